@@ -2,6 +2,7 @@
 #ifndef MAGIQUE_ASSET_PACKER_H
 #define MAGIQUE_ASSET_PACKER_H
 
+#include <initializer_list>
 #include <magique/fwd.hpp>
 #include <magique/core/Types.h>
 
@@ -32,6 +33,18 @@ namespace magique
     // Failure: Returns false
     bool CompileAssetImage(const char* dir, const char* name = "data.bin", uint64_t key = 0, bool compress = false);
 
+    // Enables pre-baking the tile collision of all tilemaps (.tmj) when compiling the asset image
+    // Each map gets an extra asset with the added extension ".collision" (e.g. "maps/level1.tmj.collision")
+    // It holds the merged colliders, their hashgrid and the pathfinding grid -> load it with AddBakedTileCollisions()
+    //      - tileSet: path of the tileset (.tsj) relative to the compiled directory - pass nullptr to disable
+    //      - layers: which tile layers are collidable - same as passed to AddTileCollisions()
+    //      - scale: scale of the tileset - same as passed to LoadGlobalTileSet()
+    //      - func: maps the tile classes - same as passed to ImportTileSet()
+    // Note: Has to be called before CompileAssetImage() - changing it does not count as a change of the image
+    // Default: Disabled
+    void SetTileCollisionBake(const char* tileSet, const std::initializer_list<int>& layers, float scale = 1,
+                              TileClassMapFunc func = nullptr);
+
     // Returns the checksum (hash) of the image (using MD5)
     // Note: This should not be used in the final shipped game - The intended workflow:
     //       - 1. Generate the checksum of the final asset image
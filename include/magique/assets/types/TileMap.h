@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <magique/core/Types.h>
+#include <magique/internal/Macros.h>
 
 //===============================================
 // TileMap
@@ -57,6 +58,7 @@ namespace magique
         const TiledProperty* getProperty(const char* name) const;
 
     private:
+        M_MAKE_PUB()
         std::vector<std::vector<TileObject>> objectLayers;
         std::vector<std::vector<int16_t>> tileLayers; // Contiguous array for map data
         std::vector<TiledProperty> properties;
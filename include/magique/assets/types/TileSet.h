@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <magique/core/Types.h>
+#include <magique/internal/Macros.h>
 
 //===============================================
 // TileSet
@@ -32,6 +33,7 @@ namespace magique
         int getTileCount() const;
 
     private:
+        M_MAKE_PUB()
         int tileSize = -1; // Default
         int tileCount = 0;
         std::vector<TileInfo> infoVec;
@@ -3,6 +3,7 @@
 #define MAGIQUE_CORE_H
 
 #include <vector>
+#include <span>
 #include <entt/entity/fwd.hpp>
 #include <magique/core/Types.h>
 #include <magique/internal/PlatformIncludes.h>
@@ -73,6 +74,29 @@ namespace magique
     // Default: true
     void SetEnableCollisionSystem(bool value);
 
+    // Dispatches the dynamic collision events (onDynamicCollision, onCollisionEnter, onCollisionStay) across workers
+    // Pairs are split into batches where each entity appears at most once - per entity the event order stays the same
+    // Note: Only pairs where all involved scripts return true for EntityScript::isThreadSafe() are run in parallel
+    // Note: A serial pair with an entity that is already in a pending batch first dispatches all pending batches
+    //       -> if serial and thread safe pairs share many entities this is no faster than the serial dispatch
+    // Default: false
+    void SetParallelCollisionEvents(bool value);
+
+    // Sets the base cell size of the entity grid of the given map - best about twice the typical entity size
+    // Note: Applied at the beginning of the next tick - bigger entities go into the coarser grid levels automatically
+    // Failure: Sizes outside of [8, 4096] are ignored with a warning
+    // Default: MAGIQUE_COLLISION_CELL_SIZE
+    void SetEntityGridCellSize(MapID map, int cellSize);
+
+    // Returns the current base cell size of the entity grid of the given map
+    int GetEntityGridCellSize(MapID map);
+
+    // Automatically picks the entity grid cell size of each loaded map
+    // Samples entity sizes and cell occupancy over 300 ticks and then applies the best size
+    // Note: The chosen size for the camera map is shown in the performance overlay
+    // Default: false
+    void SetEntityGridAutoTune(bool value);
+
     //================= DATA ACCESS =================//
 
     // Returns a list of all entities within update range of any actor - works across multiple maps!
@@ -96,6 +120,48 @@ namespace magique
     // Note: This is a hash lookup O(1) (after querying the entity grid)
     bool NearbyEntitiesContain(MapID map, Point origin, float radius, entt::entity target);
 
+    //================= SPATIAL QUERIES =================//
+    // Note: These walk the entity grid of the current tick - only entities in update range are found
+    // Note: The returned vectors are only valid until the same method is called again (single instance)
+
+    // Returns all entities whose bounding box is hit by the ray - sorted by distance (closest first)
+    // Cells are traversed in order along the ray (DDA) - with maxHits > 0 it stops as soon as the closest hits are known
+    //      - maxHits: amount of closest hits to return - 0 returns all hits until maxDist
+    // Note: The direction does not have to be normalized
+    const std::vector<RaycastHit>& RaycastEntities(MapID map, Point origin, Point direction, float maxDist,
+                                                   int maxHits = 0);
+
+    // Returns all entities whose bounding box intersects the circle given by its middle point and radius
+    const std::vector<entt::entity>& GetEntitiesInCircle(MapID map, Point mid, float radius);
+
+    // Returns up to k entities closest to the given position - sorted by distance (closest first)
+    // Searches the grid in rings around the position and stops as soon as no closer entity can exist
+    //      - filter: only entities where it returns true are considered (optional)
+    //      - maxDist: entities further away are ignored
+    // Note: The distance is measured to the closest point of the bounding box
+    const std::vector<entt::entity>& FindKNearest(MapID map, Point pos, int k,
+                                                  const std::function<bool(entt::entity)>& filter = nullptr,
+                                                  float maxDist = 1000.0F);
+
+    struct EntityQueryResults final
+    {
+        // Returns the entities found by the query with the given index (same order as the queries were passed)
+        [[nodiscard]] std::span<const entt::entity> get(int query) const;
+
+        // Returns the amount of queries
+        [[nodiscard]] int getQueryCount() const;
+
+    private:
+        std::vector<entt::entity> entities; // Results of all queries back to back
+        std::vector<int> offsets;           // Start of each query in entities - plus the end of the last one
+        friend const EntityQueryResults& QueryEntitiesBatch(MapID, const std::vector<EntityQuery>&);
+    };
+
+    // Runs all given square or circle queries at once - in parallel on the job system for larger batches
+    // Use this when many entities (e.g. AI agents) need their surroundings each tick instead of GetNearbyEntities()
+    // Note: The results are only valid until this method is called again (single instance)
+    const EntityQueryResults& QueryEntitiesBatch(MapID map, const std::vector<EntityQuery>& queries);
+
     //================= UTILS =================//
 
     // Allows to set and retrieve a player entity (the controlled entity)
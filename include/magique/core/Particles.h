@@ -17,7 +17,7 @@
 // Note: Changing the emitter doesn't change already spawned particles (except the tick functions)
 // Uses the builder pattern for syntactic sugar.
 // To begin create a ScreenEmitter emitter; and customize it: emitter.setEmissionPosition(150,150).set...
-// Can currently handle well up to 250'000 screen particles at the same time on modern systems
+// Can currently handle well up to 1'000'000 screen particles at the same time on modern systems
 // .....................................................................
 
 namespace magique
@@ -50,6 +50,7 @@ namespace magique
     {
         //================= FUNCTIONS =================//
         // Note: They are called each tick for each particle!
+        // Note: Scale and color functions can be called from worker threads - tick functions only on the main thread
 
         // Takes the current scale and the normalized time (ticksAlive/totalLifetime / 0.0 - 1.0)
         // Returns: the new scale of the particle
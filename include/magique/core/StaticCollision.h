@@ -26,6 +26,7 @@ namespace magique
 
     // Sets static collision bounds - this is only useful for simpler (static) scenes
     // Everything outside the rectangle is considered solid - pass a width or height of 0 to disable
+    // Note: Known bounds (world bounds or loaded tilemap size) allow the entity grid to use faster direct cell lookups
     // Default: Disabled
     void SetStaticWorldBounds(const Rectangle& rectangle);
 
@@ -50,10 +51,39 @@ namespace magique
 
     // Parses the selected layers of the tile data of the given map and inserts correct static colliders for marked tiles
     // Note: Using this is only possible if set a global tileset with LoadGlobalTileSet()
+    // Note: Adjacent full tiles with the same tile class are merged into bigger rectangles (per layer)
+    //       -> e.g. a straight wall is a single collider - tiles with a custom collision rect are not merged
     // Once set all calls with the same map are skipped (because there's only 1 tilemap per map)
     //       - layers: specifies which layers to parse (e.g. what layers contain collidable tiles: background, ...)
     void AddTileCollisions(MapID map, const TileMap& tileMap, const std::initializer_list<int>& layers);
 
+    // Updates the collision of a single tile of a loaded map (e.g. a destroyed wall or a placed block)
+    // Only the connected tiles of the same class around it are merged again - colliders that stay the same are kept
+    // -> the colliders are the same as when the map is loaded with the new tile
+    //       - layer: the layer index as passed to AddTileCollisions()
+    //       - tileNum: the new tile data as stored in the tilemap layer (0 is empty)
+    // Failure: Does nothing if the map or layer was not loaded or the position is out of bounds
+    void UpdateTileCollision(MapID map, int layer, int tileX, int tileY, uint16_t tileNum);
+
+    // Loads tile collision that was pre-baked into the asset image - see SetTileCollisionBake() in AssetPacker.h
+    // Instead of parsing and merging the tiles the colliders, hashgrid and pathfinding grid are copied directly
+    //      - bakedCollision: the baked asset of the map e.g. getAssetByPath("maps/level1.tmj.collision")
+    // Note: Needs the same global tileset (and scale) that was used for baking - tiles can be updated as usual after
+    // Note: Baked tile collision is never streamed - the whole map is loaded at once
+    // Failure: Returns false if the data is malformed, was baked with a different tile size or the map is loaded
+    bool AddBakedTileCollisions(MapID map, const Asset& bakedCollision);
+
+    //================= STREAMING =================//
+
+    // Enables streaming of tile collision for very large maps - only applies to maps added afterward
+    // The map is split into chunks of 64x64 tiles - only chunks around actors (update distance) have colliders loaded
+    // Once the loaded colliders exceed the memory budget the least recently used chunks are unloaded
+    //      - memoryBudget: estimated bytes the colliders of loaded chunks can use (chunks in use are never unloaded)
+    // Note: Collider ids stay the same when a chunk is loaded again (as long as its tiles didn't change)
+    // Note: Merged colliders don't cross chunk borders
+    // Default: Disabled
+    void SetTileCollisionStreaming(bool enabled, int memoryBudget = 4'000'000);
+
     // Removes the tile collision data associated with this map
     void RemoveTileCollisions(MapID map);
 
@@ -358,6 +358,7 @@ namespace magique
         Point normalVector{};   // The direction vector in which the object needs to be moved to resolve the collision
         Point collisionPoint{}; // The point of contact (or often the closest point on the shapes between the centers)
         float penDepth = 0;     // The amount by which the shapes overlap - minimal distance to move along the normal
+        float timeOfImpact = 1; // Fraction of this tick's movement at which contact happened (only < 1 for continuous)
 
         // Returns true
         [[nodiscard]] bool isColliding() const;
@@ -369,6 +370,20 @@ namespace magique
         friend void SetIsAccumulated(CollisionInfo& info);
     };
 
+    struct RaycastHit final
+    {
+        entt::entity entity; // The hit entity
+        Point point;         // Point where the ray enters the bounding box of the entity
+        float distance;      // Distance from the ray origin to the point
+    };
+
+    struct EntityQuery final
+    {
+        Point mid;             // Middle point of the query area
+        float size;            // Side length of the square - or the radius if its a circle
+        bool isCircle = false; // If true only entities whose bounding box intersects the circle are returned
+    };
+
     // Called BEFORE the entity is destroyed with its info
     using DestroyEntityCallback = void (*)(entt::entity entity, const PositionC& position);
 
@@ -457,6 +472,18 @@ namespace magique
         STAR, // Allows all orthogonal direction and additionally all diagonals top left, top right...
     };
 
+    enum class PathAlgorithm : uint8_t
+    {
+        // Expands every neighbor of a cell - slightly prefers cells closer to the target (not always the shortest path)
+        A_STAR,
+        // Jump point search - skips over symmetric paths on uniform cost grids and expands far fewer cells
+        // Always finds the shortest path - only works with GridMode::STAR (uses A_STAR otherwise)
+        JUMP_POINT,
+        // Searches from the start and from the end at the same time until both searches meet
+        // Always finds the shortest path - expands fewer cells when the end is hard to reach (e.g. enclosed or in rooms)
+        BIDIRECTIONAL,
+    };
+
     //================= MULTIPLAYER =================//
 
     enum class SendFlag : uint8_t
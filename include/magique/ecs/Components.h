@@ -62,6 +62,10 @@ namespace magique
         CollisionLayer layer = CollisionLayer{1}; // Which layers it occupies
         CollisionLayer mask = CollisionLayer{1};  // Against which layers it collides
 
+        // Sweeps the movement of this tick to prevent tunneling (continuous collision detection)
+        // Note: Only enable for small and fast entities (e.g. projectiles) - the sweep uses the bounding box
+        bool continuous = false;
+
         // Returns the middle point of an entity with the CollisionC (PositionC is implicit)
         static Point GetMiddle(entt::entity e);
 
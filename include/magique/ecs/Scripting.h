@@ -67,12 +67,16 @@ namespace magique
         onTick,
         onDynamicCollision,
         onStaticCollision,
+        onCollisionEnter,
+        onCollisionStay,
+        onCollisionExit,
         onKeyEvent,
         onMouseEvent,
     };
 
     // Add ALL event types here
-    REGISTER_EVENTS(onCreate, onDestroy, onTick, onDynamicCollision, onStaticCollision, onKeyEvent, onMouseEvent)
+    REGISTER_EVENTS(onCreate, onDestroy, onTick, onDynamicCollision, onStaticCollision, onCollisionEnter,
+                    onCollisionStay, onCollisionExit, onKeyEvent, onMouseEvent)
 
     struct EntityScript
     {
@@ -100,6 +104,17 @@ namespace magique
             AccumulateCollision(info); /// Treats the other shape as solid per default
         }
 
+        // Called once in the first tick this entity collides with another entity - after onDynamicCollision
+        // Note: Contacts are tracked per entity pair - static collisions have no enter, stay or exit events
+        virtual void onCollisionEnter(entt::entity self, entt::entity other, const CollisionInfo& info) {}
+
+        // Called each tick after the first one while the two entities keep colliding - after onDynamicCollision
+        // Note: onDynamicCollision and onCollisionStay are skipped if receivesCollisionTicks() returns false
+        virtual void onCollisionStay(entt::entity self, entt::entity other, const CollisionInfo& info) {}
+
+        // Called once in the first tick the two entities stop colliding (or the other entity is destroyed)
+        virtual void onCollisionExit(entt::entity self, entt::entity other) {}
+
         // Called once at the beginning of each tick ONLY if key state changed - press or release
         virtual void onKeyEvent(entt::entity self) {}
 
@@ -115,6 +130,20 @@ namespace magique
 
         // ... feel free to add more global methods or create subclasses with special methods!
 
+        //================= CONTACTS =================//
+
+        // Return false if this script only needs onCollisionEnter and onCollisionExit for entity collisions
+        // Skips the per-tick onDynamicCollision and onCollisionStay calls - the other shape is treated as solid (default)
+        // Note: onStaticCollision is still called each tick
+        [[nodiscard]] virtual bool receivesCollisionTicks() const { return true; }
+
+        //================= THREADING =================//
+
+        // Return true if the collision events of this script can be called from worker threads
+        // Only allowed if the events ONLY modify 'self' - no entity creation or destruction and no shared state!
+        // Note: Only used if SetParallelCollisionEvents() is enabled
+        [[nodiscard]] virtual bool isThreadSafe() const { return false; }
+
         //================= UTIL =================//
 
         // Adds the given info on top the existing info for this entity - will be applied after all collisions are resolved
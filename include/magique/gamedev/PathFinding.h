@@ -2,6 +2,7 @@
 #ifndef MAGIQUE_PATHFINDING_H
 #define MAGIQUE_PATHFINDING_H
 
+#include <functional>
 #include <vector>
 #include <magique/core/Types.h>
 #include <raylib/raylib.h>
@@ -11,7 +12,11 @@
 //===============================================
 // .....................................................................
 // This module allows to find paths using the collision data static collision (see core/StaticCollision.h)
-// It uses A-Star and works by keeping a search grid of traversable tiles
+// It uses A-Star (or jump point search) and works by keeping a search grid of traversable tiles
+// For jump point search the straight jump distances of maps with known bounds are precomputed (JPS+)
+//      -> rebuilt on the next search after the static collision of the map changed
+// For entities bigger than a cell the clearance of each cell (biggest free square starting there) is cached
+//      -> only the parts around changed static collision are recomputed
 // Note: The grid size is configured at compile time in magique/config.h
 // IMPORTANT: You probably don't need to get a new path each tick! It's probably enough to call it a couple of times per second
 //          => 30 times faster if you only do it 2 times per second instead of 60 (each tick) with almost same results
@@ -23,15 +28,104 @@ namespace magique
 
     // Assigns the (middle points) cells along the shortest path to the given vector - excluding the start tile
     //      - pathLen: stops searching if the path length exceeds this
+    //      - algorithm: JUMP_POINT expands far fewer cells on open maps - see PathAlgorithm for more info
+    //      - agentSize: size of the searching entity in cells (max. 16) - the path then holds the top left cell of the
+    //                   entity and only cells where the whole entity fits (uses the clearance of the static grid)
     // Note: The point list is in REVERSE order! (last element is the next point)
+    // Note: Agents bigger than a cell always use A*
     // Failure: if no path can be found returns an empty vector
     // Returns: True if a path could be found, false if the target is a solid tile or cant be reached
     bool FindPath(std::vector<Point>& path, Point start, Point end, MapID map, int maxLen = 50,
-                  GridMode mode = GridMode::STAR);
+                  GridMode mode = GridMode::STAR, PathAlgorithm algorithm = PathAlgorithm::A_STAR, int agentSize = 1);
 
     // Assigns "next" to the next position you should move to, in order to reach the end point the fastest
     // Same as FindPath() but only assigns the next point
-    bool FindNextPoint(Point& next, Point start, Point end, MapID map, int maxLen = 50, GridMode mode = GridMode::STAR);
+    bool FindNextPoint(Point& next, Point start, Point end, MapID map, int maxLen = 50, GridMode mode = GridMode::STAR,
+                       PathAlgorithm algorithm = PathAlgorithm::A_STAR, int agentSize = 1);
+
+    // Removes the points of the path that can be skipped by moving in a straight line instead (any-angle path)
+    // Each kept point is the farthest point of the path in line of sight (see GetPathRayCast()) of the one before
+    // Use it on the paths of FindPath() so entities move straight towards the corners instead of along grid directions
+    //      - start: the position the path was searched from
+    // Note: The path stays in REVERSE order and always keeps the end point - the points are the middle of their cells
+    // Note: Only makes sense for paths with GridMode::STAR - the straight lines are not limited to the grid directions
+    void SmoothPath(std::vector<Point>& path, Point start, MapID map);
+
+    // Finds a path over long distances (e.g. across the whole map) - uses hierarchical pathfinding (HPA*)
+    // The map is split into clusters of 16x16 cells - the entrances between them and the costs to cross them are cached
+    // Only the first clusters along the path are refined to cells - after that only the entrance cells are contained
+    //      - refineClusters: amount of clusters (from the start) that are refined to cells
+    // Note: Only static collision is considered (GridMode::STAR) - the path is close to but not always the shortest
+    // Note: Clusters are built on demand and rebuilt when the static collision inside or next to them changes
+    // Failure: Returns false if the map bounds are unknown (no tilemap or world bounds), start or end are solid
+    bool FindLongPath(std::vector<Point>& path, Point start, Point end, MapID map, int refineClusters = 2);
+
+    //================= PLANNER =================//
+
+    // Keeps the search of the last path and continues it for the next one - e.g. for an entity chasing the player
+    // Instead of searching from scratch each time (like FindPath()) it only expands the cells the last search didn't
+    //      -> the search is reused when the goal moves and when the start moves along the found path
+    //      -> cells that became solid or free (static or dynamic) only discard the part of the search using them
+    // Note: Always finds the shortest path (no weighted heuristic) - only for agents of a single cell
+    // Note: Each planner keeps its own search - use one per chasing entity
+    struct PathPlanner final
+    {
+        explicit PathPlanner(GridMode mode = GridMode::STAR);
+        PathPlanner(PathPlanner&& other) noexcept;
+        PathPlanner& operator=(PathPlanner&& other) noexcept;
+        PathPlanner(const PathPlanner&) = delete;
+        PathPlanner& operator=(const PathPlanner&) = delete;
+        ~PathPlanner();
+
+        // Same as FindPath() - the kept search is discarded if the map changed or the start left the found paths
+        bool findPath(std::vector<Point>& path, Point start, Point end, MapID map, int maxLen = 50);
+
+        // Discards the kept search
+        void reset();
+
+    private:
+        int id = -1;
+        GridMode mode;
+    };
+
+    //================= FLOW FIELDS =================//
+
+    // Returns the (normalized) direction to move in from the given position to reach the goal the fastest
+    // All entities with the same goal share a flow field - it's computed once for the goal cell and then cached
+    // Use this instead of FindPath() when many entities move to the same target (e.g. RTS units or hordes)
+    //      - radius: cells around the goal covered by the field - a bigger radius than the cached field recomputes it
+    // Note: Fields are recomputed once the static collision or the solid entities (dynamic grid) of the map change
+    // Failure: Returns {0,0} if the position is in the goal cell, outside the field or can't reach the goal
+    Point GetFlowDirection(Point position, Point goal, MapID map, int radius = 64);
+
+    //================= CACHE =================//
+
+    // Enables caching of found paths - FindPath() with the same map, start cell, end cell and settings then returns
+    // the cached path instead of searching again (e.g. patrol routes or "go to base")
+    // A cached path is searched again once any cell it passes through becomes solid (static or dynamic grid)
+    //      - capacity: maximum amount of cached paths - the least recently used path is evicted first
+    // Note: Also applies to FindNextPoint() and RequestPath() - hit rate is shown in the extended performance overlay
+    // Note: Cached paths are not updated when a shorter path opens up (e.g. a solid entity moved away)
+    // Default: Disabled
+    void SetPathCache(bool enabled, int capacity = 256);
+
+    //================= ASYNC =================//
+
+    // Called with the result of a path request - the path is only valid during the call
+    //      - found: same as the return value of FindPath()
+    using PathCallback = std::function<void(bool found, const std::vector<Point>& path)>;
+
+    // Queues a path search instead of searching immediately - can be called from any thread
+    // All requests of a tick are searched together in parallel on the job system (same result as FindPath())
+    //      -> the callbacks are called on the main thread at the start of the next tick
+    //         after the LogicSystem (dynamic grids are updated) and before Game::updateGame()
+    // Use this instead of FindPath() when many entities need a new path in the same tick
+    // Note: The callbacks are called in the order the requests were made - new requests go into the next batch
+    // Note: Entities captured by the callback might have been destroyed in the meantime
+    // Note: Requests for agents bigger than a cell are searched on the main thread
+    void RequestPath(Point start, Point end, MapID map, const PathCallback& callback, int maxLen = 50,
+                     GridMode mode = GridMode::STAR, PathAlgorithm algorithm = PathAlgorithm::A_STAR,
+                     int agentSize = 1);
 
     //================= QUERY =================//
 
@@ -7,17 +7,22 @@
 
 #include <magique/assets/container/AssetContainer.h>
 #include <magique/assets/AssetPacker.h>
+#include <magique/assets/AssetImport.h>
+#include <magique/assets/types/TileMap.h>
+#include <magique/assets/types/TileSet.h>
 #include <magique/util/Compression.h>
 #include <magique/util/Logging.h>
 #include <magique/internal/Macros.h>
 
 #include "internal/datastructures/VectorType.h"
+#include "internal/globals/StaticCollisionData.h"
 #include "internal/utils/EncryptionUtil.h"
 
 namespace fs = std::filesystem;
 
 inline constexpr auto IMAGE_HEADER = "ASSET";
 inline constexpr auto IMAGE_HEADER_COMPRESSED = "COMPR";
+inline constexpr auto BAKED_COLLISION_EXTENSION = ".collision";
 
 static void ScanDirectory(const fs::path& directory, magique::vector<fs::path>& pathList)
 {
@@ -315,9 +320,101 @@ namespace magique
         fclose(file);
     }
 
-    static void WriteImage(const uint64_t encryptionKey, const vector<fs::path>& pathList, int& writtenSize,
-                           const fs::path& rootPath, FILE* imageFile, vector<char>& data, const char* imageName)
+    struct TileCollisionBake final
     {
+        std::string tileSet;
+        vector<int> layers;
+        float scale = 1;
+        TileClassMapFunc func = nullptr;
+    };
+
+    static TileCollisionBake TILE_COLLISION_BAKE{};
+
+    void SetTileCollisionBake(const char* tileSet, const std::initializer_list<int>& layers, const float scale,
+                              const TileClassMapFunc func)
+    {
+        auto& bake = TILE_COLLISION_BAKE;
+        bake.tileSet = tileSet == nullptr ? "" : tileSet;
+        bake.layers.clear();
+        for (const auto layer : layers)
+        {
+            bake.layers.push_back(layer);
+        }
+        bake.scale = scale;
+        bake.func = func;
+    }
+
+    static void WriteEntry(const std::string& path, char* fileData, int fileSize, const uint64_t encryptionKey,
+                           FILE* imageFile, int& writtenSize)
+    {
+        // Encrypt the file data
+        SymmetricEncrypt(fileData, fileSize, encryptionKey);
+
+        // Write the path length and the path to the image file
+        const auto pathLen = static_cast<int>(path.size() + 1);
+        fwrite(&pathLen, sizeof(int), 1, imageFile);
+        fwrite(path.c_str(), pathLen, 1, imageFile);
+
+        // Write the file size and the encrypted data to the image file
+        fwrite(&fileSize, sizeof(int), 1, imageFile);
+        fwrite(fileData, fileSize, 1, imageFile);
+
+        // Update the total written size - Two 4 byte integers for path length and file size
+        writtenSize += fileSize + pathLen + 8;
+    }
+
+    // Loads the tileset used for baking tile collision - returns false if baking is disabled or failed
+    static bool LoadBakeTileSet(const fs::path& rootPath, TileSet& tileSet)
+    {
+        const auto& bake = TILE_COLLISION_BAKE;
+        if (bake.tileSet.empty())
+            return false;
+
+        const auto path = rootPath / bake.tileSet;
+        FILE* file = fopen(path.generic_string().c_str(), "rb");
+        if (file == nullptr)
+        {
+            LOG_ERROR("Could not open tileset for baking tile collision: %s", path.generic_string().c_str());
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        const int fileSize = (int)ftell(file);
+        fseek(file, 0, SEEK_SET);
+        vector<char> data;
+        data.resize(fileSize);
+        fread(data.data(), fileSize, 1, file);
+        fclose(file);
+
+        tileSet = ImportTileSet(Asset{bake.tileSet.c_str(), fileSize, data.data()}, bake.func);
+        return tileSet.getTileSize() > 0;
+    }
+
+    // Bakes the tile collision of the map (before it's encrypted) and writes it as extra entry
+    static bool WriteBakedCollision(const std::string& mapPath, const char* mapData, const int mapSize,
+                                    const TileSet& tileSet, const uint64_t encryptionKey, FILE* imageFile,
+                                    int& writtenSize, vector<char>& bakedData)
+    {
+        const auto& bake = TILE_COLLISION_BAKE;
+        const auto tileMap = ImportTileMap(Asset{mapPath.c_str(), mapSize, mapData});
+        if (tileMap.getWidth() == 0 || tileMap.getHeight() == 0)
+        {
+            LOG_WARNING("Skipped baking tile collision of empty or invalid map: %s", mapPath.c_str());
+            return false;
+        }
+        BakeTileCollisions(bakedData, tileMap, tileSet, bake.scale, bake.layers);
+        WriteEntry(mapPath + BAKED_COLLISION_EXTENSION, bakedData.data(), bakedData.size(), encryptionKey, imageFile,
+                   writtenSize);
+        return true;
+    }
+
+    static int WriteImage(const uint64_t encryptionKey, const vector<fs::path>& pathList, int& writtenSize,
+                          const fs::path& rootPath, FILE* imageFile, vector<char>& data, const char* imageName)
+    {
+        TileSet bakeTileSet;
+        const bool bakeCollision = LoadBakeTileSet(rootPath, bakeTileSet);
+        vector<char> bakedData;
+        int entries = 0;
+
         std::string relativePathStr;
         int totalFileSize = 0; // Only raw file size
         for (const auto& entry : pathList)
@@ -342,35 +439,27 @@ namespace magique
             // Read the file data into the buffer
             fread(data.data(), fileSize, 1, file);
 
-            // Encrypt the file data
-            SymmetricEncrypt(data.data(), fileSize, encryptionKey);
-
             // Get the relative path for the file
             fs::path relativePath = fs::relative(entry, rootPath);
             relativePathStr = relativePath.generic_string();
-            auto pathLen = static_cast<int>(relativePathStr.size() + 1);
-
-            // Write the path length to the image file
-            fwrite(&pathLen, sizeof(int), 1, imageFile);
 
-            // Write the relative path to the image file
-            fwrite(relativePathStr.c_str(), pathLen, 1, imageFile);
-
-            // Write the file size to the image file
-            fwrite(&fileSize, sizeof(int), 1, imageFile);
-
-            // Write the encrypted file data to the image file
-            fwrite(data.data(), fileSize, 1, imageFile);
+            // Tile collision is baked from the unencrypted data
+            if (bakeCollision && entry.extension() == ".tmj" &&
+                WriteBakedCollision(relativePathStr, data.data(), fileSize, bakeTileSet, encryptionKey, imageFile,
+                                    writtenSize, bakedData))
+            {
+                ++entries;
+            }
 
-            // Update the total written size - Two 4 byte integers for path length and file size
-            writtenSize += fileSize;
-            writtenSize += pathLen;
-            writtenSize += 8;
+            // Encrypt and write the file data
+            WriteEntry(relativePathStr, data.data(), fileSize, encryptionKey, imageFile, writtenSize);
+            ++entries;
 
             // Close the input file
             fclose(file);
         }
         CreateIndexFile(imageName, pathList.size(), totalFileSize);
+        return entries;
     }
 
     bool CompileAssetImage(const char* directory, const char* fileName, const uint64_t encryptionKey,
@@ -422,11 +511,12 @@ namespace magique
         data.reserve(10000);
 
         // Write the image data
-        WriteImage(encryptionKey, pathList, writtenSize, rootPath, imageFile, data, fileName);
+        const int entries = WriteImage(encryptionKey, pathList, writtenSize, rootPath, imageFile, data, fileName);
 
-        // Update the total written size in the file header
+        // Update the total written size and the entries (includes baked data) in the file header
         fseek(imageFile, 5, SEEK_SET);
         fwrite(&writtenSize, sizeof(int), 1, imageFile);
+        fwrite(&entries, sizeof(int), 1, imageFile);
 
         if (compress)
         {
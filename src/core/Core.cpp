@@ -64,6 +64,29 @@ namespace magique
 
     void SetEnableCollisionSystem(const bool value) { global::ENGINE_CONFIG.enableCollisionSystem = value; }
 
+    void SetParallelCollisionEvents(const bool value) { global::ENGINE_CONFIG.parallelCollisionEvents = value; }
+
+    void SetEntityGridCellSize(const MapID map, const int cellSize)
+    {
+        if (cellSize < 8 || cellSize > 4096)
+        {
+            LOG_WARNING("Entity grid cell size must be in [8, 4096]: %d", cellSize);
+            return;
+        }
+        global::DY_COLL_DATA.cellSizes[static_cast<int>(map)] = static_cast<uint16_t>(cellSize);
+    }
+
+    int GetEntityGridCellSize(const MapID map) { return global::DY_COLL_DATA.cellSizes[static_cast<int>(map)]; }
+
+    void SetEntityGridAutoTune(const bool value)
+    {
+        global::ENGINE_CONFIG.autoTuneCellSize = value;
+        for (auto& tuner : global::DY_COLL_DATA.tuners)
+        {
+            tuner = {};
+        }
+    }
+
     void SetEngineFont(const Font& font) { global::ENGINE_CONFIG.font = font; }
 
     const Font& GetEngineFont() { return global::ENGINE_CONFIG.font; }
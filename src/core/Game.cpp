@@ -59,6 +59,7 @@
 #include "internal/systems/DynamicCollisionSystem.h"
 #include "internal/systems/InputSystem.h"
 #include "internal/systems/LogicSystem.h"
+#include "internal/systems/PathRequestSystem.h"
 #include "internal/systems/LightingSystem.h"
 
 #include "core/headers/MainThreadUtil.h"
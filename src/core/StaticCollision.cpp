@@ -1,14 +1,20 @@
 // SPDX-License-Identifier: zlib-acknowledgement
 #include <raylib/raylib.h>
 
+#include <magique/assets/types/Asset.h>
 #include <magique/assets/types/TileMap.h>
 #include <magique/assets/types/TileSet.h>
 #include <magique/core/StaticCollision.h>
+#include <magique/ecs/ECS.h>
+#include <magique/ecs/Components.h>
 #include <magique/util/Logging.h>
 
 #include "internal/globals/StaticCollisionData.h"
+#include "internal/globals/EngineData.h"
+#include "internal/globals/EngineConfig.h"
 #include "internal/globals/PathFindingData.h"
 #include "internal/utils/STLUtil.h"
+#include "internal/utils/TileMergeUtil.h"
 
 namespace magique
 {
@@ -58,6 +64,7 @@ namespace magique
 
         // Insert the info
         mapTileObjectVec.push_back(std::move(info));
+        grid.bake();
         global::PATH_DATA.updateStaticPathGrid(map);
     }
 
@@ -118,6 +125,348 @@ namespace magique
         }
     }
 
+    namespace
+    {
+        // Reuses the reserved ids of the chunk that is loaded (if any) so ids stay stable across unloads
+        uint32_t InsertTileCollider(const MapID map, TileCollisionMask& mask, const Rectangle& rect, const int tileClass)
+        {
+            auto& data = global::STATIC_COLL_DATA;
+            uint32_t objectNum;
+            if (mask.reuseNext < static_cast<int>(mask.reuseIds.size()))
+            {
+                objectNum = mask.reuseIds[mask.reuseNext++];
+                data.colliderStorage.enable(objectNum, rect.x, rect.y, rect.width, rect.height);
+            }
+            else
+            {
+                objectNum = data.colliderStorage.insert(rect.x, rect.y, rect.width, rect.height);
+            }
+            const int chunk = mask.getChunk(static_cast<int>(rect.x / mask.tileSize),
+                                            static_cast<int>(rect.y / mask.tileSize));
+            data.colliderReferences.addTileCollider(map, chunk, objectNum);
+            data.loadedChunkBytes += mask.isStreamed ? StaticCollisionData::COLLIDER_BYTES : 0;
+            const auto staticID = StaticIDHelper::CreateID(objectNum, tileClass);
+            data.mapTileGrids[map].insert(staticID, rect.x, rect.y, rect.width, rect.height);
+            return objectNum;
+        }
+
+        // Removes the collider and unassigns all cells covered by it
+        void RemoveTileCollider(const MapID map, TileCollisionMask& mask, TileCollisionLayer& layer,
+                                const uint32_t objectNum)
+        {
+            auto& data = global::STATIC_COLL_DATA;
+            const auto& collider = data.colliderStorage.get(objectNum);
+            const int startX = static_cast<int>(collider.x / mask.tileSize);
+            const int startY = static_cast<int>(collider.y / mask.tileSize);
+            const int endX = static_cast<int>(std::ceil((collider.x + collider.p1) / mask.tileSize)) - 1;
+            const int endY = static_cast<int>(std::ceil((collider.y + collider.p2) / mask.tileSize)) - 1;
+            for (int i = startY; i <= std::max(startY, endY); ++i)
+            {
+                for (int j = startX; j <= std::max(startX, endX); ++j)
+                {
+                    if (layer.colliders[i * mask.width + j] == objectNum)
+                        layer.colliders[i * mask.width + j] = TileCollisionLayer::NO_COLLIDER;
+                }
+            }
+
+            const auto pred = [](const uint32_t num, const StaticID id)
+            { return num == StaticIDHelper::GetObjectNum(id); };
+            data.mapTileGrids[map].removeIfWithHoles(objectNum, pred, collider.x, collider.y, collider.p1, collider.p2);
+            data.colliderStorage.remove(objectNum);
+            data.colliderReferences.removeTileCollider(map, mask.getChunk(startX, startY), objectNum);
+            data.loadedChunkBytes -= mask.isStreamed ? StaticCollisionData::COLLIDER_BYTES : 0;
+        }
+
+        // Merges all full solid tiles in the region not yet covered by a collider into rectangles (greedy meshing)
+        void MergeTileRegion(const MapID map, TileCollisionMask& mask, TileCollisionLayer& layer, const int x,
+                             const int y, const int width, const int height)
+        {
+            auto& scratch = mask.mergeScratch;
+            scratch.resize(width * height);
+            for (int i = 0; i < height; ++i)
+            {
+                for (int j = 0; j < width; ++j)
+                {
+                    const auto collider = layer.colliders[(y + i) * mask.width + x + j];
+                    scratch[i * width + j] = collider != TileCollisionLayer::NO_COLLIDER ? 1 : 0;
+                }
+            }
+
+            const auto onRect = [&](const int rx, const int ry, const int rw, const int rh, const int16_t tileClass)
+            {
+                const Rectangle rect = {static_cast<float>(rx) * mask.tileSize, static_cast<float>(ry) * mask.tileSize,
+                                        static_cast<float>(rw) * mask.tileSize, static_cast<float>(rh) * mask.tileSize};
+                const auto objectNum = InsertTileCollider(map, mask, rect, tileClass);
+                for (int i = ry; i < ry + rh; ++i)
+                {
+                    for (int j = rx; j < rx + rw; ++j)
+                        layer.colliders[i * mask.width + j] = objectNum;
+                }
+            };
+            GreedyMergeCells(layer.cells.data(), scratch.data(), mask.width, x, y, width, height, onRect);
+        }
+
+        // Returns true if the tile (as stored in the layer data) has collision with the given marked tiles
+        // Full tiles only set the tile class - tiles with a custom collision rect also set the rect (in world space)
+        bool GetMarkedTileCollision(const HashMap<uint16_t, TileInfo>& markedTiles, const float scale,
+                                    const uint16_t tileData, const int tileX, const int tileY, const float tileSize,
+                                    int& tileClass, Rectangle& customRect)
+        {
+            // tile data is 1 more so that empty is 0
+            const auto tileNum = static_cast<uint16_t>(tileData - 1);
+            if (tileNum == UINT16_MAX) // uint overflows to maximum value (0-1 = MAX)
+                return false;
+            const auto infoIt = markedTiles.find(tileNum);
+            if (infoIt == markedTiles.end())
+                return false;
+
+            const auto& info = infoIt->second;
+            tileClass = static_cast<int>(info.tileClass);
+            customRect = {static_cast<float>(info.x) * scale, static_cast<float>(info.y) * scale,
+                          static_cast<float>(info.width) * scale, static_cast<float>(info.height) * scale};
+            // rect is 0 if not assigned
+            if (customRect.width == 0 || (customRect.x == 0 && customRect.y == 0 && customRect.width == tileSize &&
+                                          customRect.height == tileSize))
+            {
+                customRect.width = 0;
+                return true;
+            }
+            customRect.x += static_cast<float>(tileX) * tileSize;
+            customRect.y += static_cast<float>(tileY) * tileSize;
+            return true;
+        }
+
+        // Returns true if the tile has collision with the global tileset
+        bool GetTileCollision(const uint16_t tileData, const int tileX, const int tileY, const float tileSize,
+                              int& tileClass, Rectangle& customRect)
+        {
+            const auto& data = global::STATIC_COLL_DATA;
+            return GetMarkedTileCollision(data.markedTilesMap, data.tileSetScale, tileData, tileX, tileY, tileSize,
+                                          tileClass, customRect);
+        }
+
+        // Returns the tile region covered by the chunk
+        Rectangle GetChunkTiles(const TileCollisionMask& mask, const int chunk)
+        {
+            const int x = chunk % mask.chunksX * mask.chunkSize;
+            const int y = chunk / mask.chunksX * mask.chunkSize;
+            const int width = std::min(mask.chunkSize, mask.width - x);
+            const int height = std::min(mask.chunkSize, mask.height - y);
+            return {static_cast<float>(x), static_cast<float>(y), static_cast<float>(width),
+                    static_cast<float>(height)};
+        }
+
+        // Adds the 4-connected full tiles of the same class as the given tile to the region (within its chunk)
+        // Merged rectangles never leave such a region - merging it again gives the same result as the whole chunk
+        void CollectTileRegion(TileCollisionMask& mask, const TileCollisionLayer& layer, const int x, const int y)
+        {
+            const int value = layer.cells[y * mask.width + x];
+            mask.regionFlags.resize(mask.width * mask.height, 0);
+            if (value < 0 || mask.regionFlags[y * mask.width + x] != 0)
+                return;
+
+            const auto [chunkX, chunkY, chunkW, chunkH] = GetChunkTiles(mask, mask.getChunk(x, y));
+            const int startX = static_cast<int>(chunkX);
+            const int startY = static_cast<int>(chunkY);
+            const int endX = startX + static_cast<int>(chunkW);
+            const int endY = startY + static_cast<int>(chunkH);
+            auto& region = mask.region;
+            auto next = static_cast<int>(region.size());
+            region.push_back(y * mask.width + x);
+            mask.regionFlags[region.back()] = 1;
+            while (next < static_cast<int>(region.size()))
+            {
+                const int idx = region[next++];
+                const int cx = idx % mask.width;
+                const int cy = idx / mask.width;
+                const auto visit = [&](const int nx, const int ny)
+                {
+                    const int nIdx = ny * mask.width + nx;
+                    if (nx < startX || ny < startY || nx >= endX || ny >= endY || mask.regionFlags[nIdx] != 0 ||
+                        layer.cells[nIdx] != value)
+                        return;
+                    mask.regionFlags[nIdx] = 1;
+                    region.push_back(nIdx);
+                };
+                visit(cx - 1, cy);
+                visit(cx + 1, cy);
+                visit(cx, cy - 1);
+                visit(cx, cy + 1);
+            }
+        }
+
+        // Merges the collected region again - colliders that stay the same are kept, the others are replaced
+        //      - tile: the changed tile - its old merged collider is replaced even if it's not part of the region
+        void RemergeTileRegion(const MapID map, TileCollisionMask& mask, TileCollisionLayer& layer, const int tile)
+        {
+            auto& data = global::STATIC_COLL_DATA;
+            auto& region = mask.region;
+            int minX = tile % mask.width, minY = tile / mask.width, maxX = minX, maxY = minY;
+            for (const auto idx : region)
+            {
+                minX = std::min(minX, idx % mask.width);
+                minY = std::min(minY, idx / mask.width);
+                maxX = std::max(maxX, idx % mask.width);
+                maxY = std::max(maxY, idx / mask.width);
+            }
+            const int width = maxX - minX + 1;
+            const int height = maxY - minY + 1;
+            auto& scratch = mask.mergeScratch;
+            scratch.resize(width * height);
+            std::fill(scratch.begin(), scratch.end(), 1);
+            for (const auto idx : region)
+            {
+                scratch[(idx / mask.width - minY) * width + idx % mask.width - minX] = 0;
+            }
+
+            const auto tileCollider = layer.colliders[tile]; // Has the old class
+            HashSet<uint32_t> kept;
+            struct AddedRect final // Trivially copyable for the vector
+            {
+                Rectangle rect;
+                int16_t tileClass;
+            };
+            vector<AddedRect> added;
+            const auto onRect = [&](const int rx, const int ry, const int rw, const int rh, const int16_t tileClass)
+            {
+                const Rectangle rect = {static_cast<float>(rx) * mask.tileSize, static_cast<float>(ry) * mask.tileSize,
+                                        static_cast<float>(rw) * mask.tileSize, static_cast<float>(rh) * mask.tileSize};
+                const auto old = layer.colliders[ry * mask.width + rx];
+                if (old != TileCollisionLayer::NO_COLLIDER && old != tileCollider)
+                {
+                    const auto& [x, y, w, h] = data.colliderStorage.get(old);
+                    if (x == rect.x && y == rect.y && w == rect.width && h == rect.height)
+                    {
+                        kept.insert(old);
+                        return;
+                    }
+                }
+                added.push_back({rect, tileClass});
+            };
+            GreedyMergeCells(layer.cells.data(), scratch.data(), mask.width, minX, minY, width, height, onRect);
+
+            region.push_back(tile);
+            for (const auto idx : region)
+            {
+                mask.regionFlags[idx] = 0;
+                const auto objectNum = layer.colliders[idx];
+                if (objectNum != TileCollisionLayer::NO_COLLIDER && !kept.contains(objectNum))
+                    RemoveTileCollider(map, mask, layer, objectNum);
+            }
+            for (const auto& [rect, tileClass] : added)
+            {
+                const auto objectNum = InsertTileCollider(map, mask, rect, tileClass);
+                const int x = static_cast<int>(rect.x / mask.tileSize);
+                const int y = static_cast<int>(rect.y / mask.tileSize);
+                for (int i = y; i < y + static_cast<int>(rect.height / mask.tileSize); ++i)
+                {
+                    for (int j = x; j < x + static_cast<int>(rect.width / mask.tileSize); ++j)
+                        layer.colliders[i * mask.width + j] = objectNum;
+                }
+            }
+        }
+
+        // Returns the pixel area of the loaded chunk - custom collision rects can reach over its border
+        Rectangle GetChunkArea(const MapID map, const TileCollisionMask& mask, const int chunk)
+        {
+            const auto& data = global::STATIC_COLL_DATA;
+            const auto tiles = GetChunkTiles(mask, chunk);
+            float x1 = tiles.x * mask.tileSize;
+            float y1 = tiles.y * mask.tileSize;
+            float x2 = x1 + tiles.width * mask.tileSize;
+            float y2 = y1 + tiles.height * mask.tileSize;
+            for (const auto id : data.colliderReferences.tileChunkMap.at(map)[chunk].objectIds)
+            {
+                const auto& [x, y, w, h] = data.colliderStorage.get(id);
+                x1 = std::min(x1, x);
+                y1 = std::min(y1, y);
+                x2 = std::max(x2, x + w);
+                y2 = std::max(y2, y + h);
+            }
+            return {x1, y1, x2 - x1, y2 - y1};
+        }
+
+        // Inserts the colliders of all layers of the chunk - the merged rectangles never cross chunk borders
+        void LoadTileChunk(const MapID map, TileCollisionMask& mask, const int chunk)
+        {
+            auto& data = global::STATIC_COLL_DATA;
+            auto& info = data.colliderReferences.tileChunkMap[map][chunk];
+            mask.reuseIds.clear();
+            for (const auto id : info.objectIds)
+            {
+                mask.reuseIds.push_back(id);
+            }
+            mask.reuseNext = 0;
+            info.objectIds.clear();
+
+            const auto [x, y, width, height] = GetChunkTiles(mask, chunk);
+            const int startX = static_cast<int>(x);
+            const int startY = static_cast<int>(y);
+            const int endX = startX + static_cast<int>(width);
+            const int endY = startY + static_cast<int>(height);
+            for (auto& layer : mask.layers)
+            {
+                for (int i = startY; i < endY; ++i)
+                {
+                    for (int j = startX; j < endX; ++j)
+                    {
+                        const auto idx = i * mask.width + j;
+                        int tileClass = 0;
+                        Rectangle rect;
+                        if (layer.cells[idx] != -1)
+                            continue;
+                        if (!GetTileCollision(layer.tiles[idx], j, i, mask.tileSize, tileClass, rect))
+                            continue;
+                        layer.colliders[idx] = InsertTileCollider(map, mask, rect, tileClass); // Custom collision rect
+                    }
+                }
+                MergeTileRegion(map, mask, layer, startX, startY, endX - startX, endY - startY);
+            }
+
+            // The chunk changed while unloaded and has fewer colliders now
+            for (int i = mask.reuseNext; i < static_cast<int>(mask.reuseIds.size()); ++i)
+            {
+                data.colliderStorage.release(mask.reuseIds[i]);
+            }
+            mask.reuseIds.clear();
+            mask.reuseNext = 0;
+            info.isLoaded = true;
+            if (mask.isStreamed)
+                data.colliderReferences.touchChunk(map, chunk);
+        }
+
+        // Removes the colliders of the chunk from the grid but keeps their ids reserved
+        void UnloadTileChunk(const MapID map, TileCollisionMask& mask, const int chunk)
+        {
+            auto& data = global::STATIC_COLL_DATA;
+            auto& info = data.colliderReferences.tileChunkMap[map][chunk];
+            auto& grid = data.mapTileGrids[map];
+            const auto pred = [](const uint32_t num, const StaticID id)
+            { return num == StaticIDHelper::GetObjectNum(id); };
+            for (const auto id : info.objectIds)
+            {
+                const auto& [x, y, w, h] = data.colliderStorage.get(id);
+                grid.removeIfWithHoles(id, pred, x, y, w, h);
+                data.colliderStorage.disable(id);
+                data.colliderReferences.unloadTileCollider(map, id);
+            }
+            grid.patchHoles();
+
+            const auto [x, y, width, height] = GetChunkTiles(mask, chunk);
+            for (auto& layer : mask.layers)
+            {
+                for (int i = static_cast<int>(y); i < static_cast<int>(y + height); ++i)
+                {
+                    for (int j = static_cast<int>(x); j < static_cast<int>(x + width); ++j)
+                        layer.colliders[i * mask.width + j] = TileCollisionLayer::NO_COLLIDER;
+                }
+            }
+            info.isLoaded = false;
+            data.loadedChunkBytes -= static_cast<int>(info.objectIds.size()) * StaticCollisionData::COLLIDER_BYTES;
+            data.colliderReferences.unlinkChunk(map, chunk);
+        }
+    } // namespace
+
     void AddTileCollisions(const MapID map, const TileMap& tileMap, const std::initializer_list<int>& layers)
     {
         auto& data = global::STATIC_COLL_DATA;
@@ -137,7 +486,21 @@ namespace magique
         const auto tileSize = data.tileSetScale * static_cast<float>(data.tileSet->getTileSize());
         const auto mapWidth = tileMap.getWidth();
         const auto mapHeight = tileMap.getHeight();
-        auto& tileVec = data.colliderReferences.tilesCollisionMap[map];
+        const auto pixelWidth = static_cast<float>(mapWidth) * tileSize;
+        const auto pixelHeight = static_cast<float>(mapHeight) * tileSize;
+        data.colliderReferences.tilesCollisionMap[map]; // Marks the map as loaded
+
+        auto& mask = data.tileMasks[map];
+        mask.width = mapWidth;
+        mask.height = mapHeight;
+        mask.tileSize = tileSize;
+        mask.isStreamed = data.streamTileChunks;
+        mask.chunkSize = mask.isStreamed ? StaticCollisionData::CHUNK_TILES : std::max({mapWidth, mapHeight, 1});
+        mask.chunksX = (mapWidth + mask.chunkSize - 1) / mask.chunkSize;
+        mask.chunksY = (mapHeight + mask.chunkSize - 1) / mask.chunkSize;
+        auto& chunks = data.colliderReferences.tileChunkMap[map];
+        chunks.resize(mask.chunksX * mask.chunksY);
+
         for (const auto layer : layers)
         {
             if (layer > tileMap.getTileLayerCount())
@@ -147,39 +510,97 @@ namespace magique
                 continue;
             }
 
+            // Full solid tiles are marked with their class - they are merged into rectangles when a chunk is loaded
+            mask.layers.push_back({});
+            auto& tileLayer = mask.layers.back();
+            tileLayer.layer = layer;
+            tileLayer.tiles.resize(mapWidth * mapHeight);
+            tileLayer.cells.resize(mapWidth * mapHeight, -1);
+            tileLayer.colliders.resize(mapWidth * mapHeight, TileCollisionLayer::NO_COLLIDER);
+
             const auto* start = tileMap.getLayerData(layer);
-            for (int i = 0; i < mapHeight; ++i)
+            for (int i = 0; i < mapHeight * mapWidth; ++i)
             {
-                const auto yOff = i * mapWidth;
-                for (int j = 0; j < mapWidth; ++j)
+                tileLayer.tiles[i] = static_cast<uint16_t>(start[i]);
+                int tileClass = 0;
+                Rectangle rect;
+                if (GetTileCollision(tileLayer.tiles[i], i % mapWidth, i / mapWidth, tileSize, tileClass, rect) &&
+                    rect.width == 0)
                 {
-                    // tile data is 1 more so that empty is 0
-                    const auto tileNum = static_cast<uint16_t>(start[yOff + j] - 1);
-                    if (tileNum == UINT16_MAX) // uint overflows to maximum value (0-1 = MAX)
-                        continue;
-                    const auto infoIt = data.markedTilesMap.find(tileNum);
-                    if (infoIt != data.markedTilesMap.end())
-                    {
-                        const auto& info = infoIt->second;
-                        auto x = static_cast<float>(info.x) * data.tileSetScale;
-                        auto y = static_cast<float>(info.y) * data.tileSetScale;
-                        auto width = static_cast<float>(info.width) * data.tileSetScale;
-                        auto height = static_cast<float>(info.height) * data.tileSetScale;
-                        x += static_cast<float>(j) * tileSize;
-                        y += static_cast<float>(i) * tileSize;
-                        if (width == 0) // rect is 0 if not assigned - so adding to x and y is always valid
-                        {
-                            width = tileSize;
-                            height = tileSize;
-                        }
-                        const auto objectNum = data.colliderStorage.insert(x, y, width, height);
-                        tileVec.push_back(objectNum);
-                        const auto tileClass = infoIt->second.tileClass;
-                        grid.insert(StaticIDHelper::CreateID(objectNum, (int)tileClass), x, y, width, height);
-                    }
+                    tileLayer.cells[i] = static_cast<int16_t>(tileClass);
                 }
             }
         }
+
+        // With streaming the chunks are loaded around actors
+        for (int i = 0; i < static_cast<int>(chunks.size()); ++i)
+        {
+            chunks[i].isLoaded = false;
+            if (!mask.isStreamed)
+                LoadTileChunk(map, mask, i);
+        }
+        data.streamedMaps += mask.isStreamed ? 1 : 0;
+        grid.bake();
+        data.mapBounds[map] = {0, 0, pixelWidth, pixelHeight};
+        global::PATH_DATA.updateStaticPathGrid(map);
+    }
+
+    void UpdateTileCollision(const MapID map, const int layer, const int tileX, const int tileY, const uint16_t tileNum)
+    {
+        auto& data = global::STATIC_COLL_DATA;
+        const auto maskIt = data.tileMasks.find(map);
+        if (maskIt == data.tileMasks.end())
+        {
+            LOG_WARNING("No tilemap collisions have been loaded for this map!");
+            return;
+        }
+
+        auto& mask = maskIt->second;
+        auto* tileLayer = mask.getLayer(layer);
+        if (tileLayer == nullptr || tileX < 0 || tileY < 0 || tileX >= mask.width || tileY >= mask.height)
+        {
+            LOG_WARNING("Layer was not loaded or tile position is out of bounds: %d %d", tileX, tileY);
+            return;
+        }
+
+        int tileClass = -1;
+        Rectangle rect{};
+        const bool hasCollision = GetTileCollision(tileNum, tileX, tileY, mask.tileSize, tileClass, rect);
+        const bool isFullTile = hasCollision && rect.width == 0;
+        const auto idx = tileY * mask.width + tileX;
+        tileLayer->tiles[idx] = tileNum;
+        const auto chunk = mask.getChunk(tileX, tileY);
+        if (!data.colliderReferences.tileChunkMap[map][chunk].isLoaded)
+        {
+            tileLayer->cells[idx] = isFullTile ? static_cast<int16_t>(tileClass) : static_cast<int16_t>(-1);
+            return; // Built with the new data once loaded
+        }
+
+        // Old custom collision rect - merged colliders are rebuilt below
+        if (tileLayer->cells[idx] == -1 && tileLayer->colliders[idx] != TileCollisionLayer::NO_COLLIDER)
+        {
+            RemoveTileCollider(map, mask, *tileLayer, tileLayer->colliders[idx]);
+        }
+        tileLayer->cells[idx] = isFullTile ? static_cast<int16_t>(tileClass) : static_cast<int16_t>(-1);
+
+        // The tile can join or split the regions of the tile and its neighbours
+        mask.region.clear();
+        CollectTileRegion(mask, *tileLayer, tileX, tileY);
+        constexpr int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (const auto& [offX, offY] : offsets)
+        {
+            const int x = tileX + offX;
+            const int y = tileY + offY;
+            if (x >= 0 && y >= 0 && x < mask.width && y < mask.height && mask.getChunk(x, y) == chunk)
+                CollectTileRegion(mask, *tileLayer, x, y);
+        }
+        RemergeTileRegion(map, mask, *tileLayer, idx);
+        data.mapTileGrids[map].patchHoles();
+
+        if (hasCollision && !isFullTile)
+        {
+            tileLayer->colliders[idx] = InsertTileCollider(map, mask, rect, tileClass);
+        }
         global::PATH_DATA.updateStaticPathGrid(map);
     }
 
@@ -192,15 +613,373 @@ namespace magique
             return;
         }
 
-        const auto& colliderIdVec = data.colliderReferences.tilesCollisionMap.at(map);
         auto& hashGrid = data.mapTileGrids[map];
-        for (const auto id : colliderIdVec)
+        const bool isStreamed = data.tileMasks[map].isStreamed;
+        auto& chunks = data.colliderReferences.tileChunkMap[map];
+        for (int i = 0; i < static_cast<int>(chunks.size()); ++i)
         {
-            data.colliderStorage.remove(id);
+            const auto& chunk = chunks[i];
+            for (const auto id : chunk.objectIds)
+            {
+                if (chunk.isLoaded)
+                    data.colliderStorage.remove(id);
+                else
+                    data.colliderStorage.release(id); // Only reserved
+            }
+            if (isStreamed && chunk.isLoaded)
+            {
+                data.loadedChunkBytes -= static_cast<int>(chunk.objectIds.size()) * StaticCollisionData::COLLIDER_BYTES;
+                data.colliderReferences.unlinkChunk(map, i);
+            }
         }
         hashGrid.clear(); // We can clear as tile collisions can only occur once per map
+        data.streamedMaps -= isStreamed ? 1 : 0;
         data.colliderReferences.tilesCollisionMap.erase(map);
+        data.colliderReferences.tileChunkMap.erase(map);
+        data.tileMasks.erase(map);
+        data.mapBounds.erase(map);
+        global::PATH_DATA.updateStaticPathGrid(map);
+    }
+
+    //----------------- BAKING -----------------//
+
+    namespace
+    {
+        using PathBlock = decltype(PathFindingGrid::visited)::mapped_type;
+
+        template <typename T>
+        void AppendBaked(vector<char>& out, const T* src, const int count)
+        {
+            const auto start = out.size();
+            out.resize(start + count * static_cast<int>(sizeof(T)));
+            if (count > 0)
+                memcpy(&out[start], src, count * sizeof(T));
+        }
+
+        int64_t GetBakedSize(const BakedTileCollisionHeader& header)
+        {
+            const int64_t tileCount = static_cast<int64_t>(header.width) * header.height;
+            const int64_t layerBytes = sizeof(int) + tileCount * (sizeof(uint16_t) + sizeof(int16_t) + sizeof(uint32_t));
+            return static_cast<int64_t>(sizeof(BakedTileCollisionHeader)) + header.layerCount * layerBytes +
+                static_cast<int64_t>(header.colliderCount) * sizeof(StaticCollider) +
+                static_cast<int64_t>(header.cellKeyCount) * sizeof(CellID) +
+                (static_cast<int64_t>(header.cellKeyCount) + 1) * sizeof(uint32_t) +
+                static_cast<int64_t>(header.valueCount) * sizeof(StaticID) +
+                static_cast<int64_t>(header.pathBlockCount) * (sizeof(VisitedCellID) + sizeof(PathBlock));
+        }
+    } // namespace
+
+    void BakeTileCollisions(vector<char>& out, const TileMap& tileMap, const TileSet& tileSet, const float scale,
+                            const vector<int>& layers)
+    {
+        HashMap<uint16_t, TileInfo> markedTiles;
+        for (const auto& tileInfo : tileSet.getTilesInfo())
+        {
+            if (tileInfo.hasCollision)
+                markedTiles[tileInfo.tileID] = tileInfo;
+        }
+
+        BakedTileCollisionHeader header;
+        header.width = tileMap.getWidth();
+        header.height = tileMap.getHeight();
+        header.tileSize = scale * static_cast<float>(tileSet.getTileSize());
+        header.pathCellSize = PathFindingData::cellSize;
+        header.pathBlockSize = sizeof(PathBlock);
+        const int tileCount = header.width * header.height;
+        const float tileSize = header.tileSize;
+
+        // Same steps as loading a chunk that covers the whole map - custom rects first then the merged tiles
+        vector<StaticCollider> colliders;
+        vector<int> colliderClasses;
+        vector<char> layerData;
+        vector<uint8_t> scratch;
+        const auto addCollider = [&](const Rectangle& rect, const int tileClass)
+        {
+            colliders.push_back({rect.x, rect.y, rect.width, rect.height});
+            colliderClasses.push_back(tileClass);
+            return static_cast<uint32_t>(colliders.size() - 1);
+        };
+
+        for (const auto layer : layers)
+        {
+            if (layer < 0 || layer >= tileMap.getTileLayerCount())
+            {
+                LOG_WARNING("Given tilemap does not contain a layer with index: %d. Check TileMap.h for more info",
+                            layer);
+                continue;
+            }
+
+            TileCollisionLayer tileLayer;
+            tileLayer.layer = layer;
+            tileLayer.tiles.resize(tileCount);
+            tileLayer.cells.resize(tileCount, -1);
+            tileLayer.colliders.resize(tileCount, TileCollisionLayer::NO_COLLIDER);
+            const auto* start = tileMap.getLayerData(layer);
+            for (int i = 0; i < tileCount; ++i)
+            {
+                tileLayer.tiles[i] = static_cast<uint16_t>(start[i]);
+                int tileClass = 0;
+                Rectangle rect;
+                const int x = i % header.width;
+                const int y = i / header.width;
+                if (!GetMarkedTileCollision(markedTiles, scale, tileLayer.tiles[i], x, y, tileSize, tileClass, rect))
+                    continue;
+                if (rect.width == 0)
+                    tileLayer.cells[i] = static_cast<int16_t>(tileClass);
+                else
+                    tileLayer.colliders[i] = addCollider(rect, tileClass);
+            }
+
+            scratch.clear();
+            scratch.resize(tileCount, 0);
+            const auto onRect = [&](const int rx, const int ry, const int rw, const int rh, const int16_t tileClass)
+            {
+                const Rectangle rect = {static_cast<float>(rx) * tileSize, static_cast<float>(ry) * tileSize,
+                                        static_cast<float>(rw) * tileSize, static_cast<float>(rh) * tileSize};
+                const auto index = addCollider(rect, tileClass);
+                for (int i = ry; i < ry + rh; ++i)
+                {
+                    for (int j = rx; j < rx + rw; ++j)
+                        tileLayer.colliders[i * header.width + j] = index;
+                }
+            };
+            GreedyMergeCells(tileLayer.cells.data(), scratch.data(), header.width, 0, 0, header.width, header.height,
+                             onRect);
+
+            AppendBaked(layerData, &tileLayer.layer, 1);
+            AppendBaked(layerData, tileLayer.tiles.data(), tileCount);
+            AppendBaked(layerData, tileLayer.cells.data(), tileCount);
+            AppendBaked(layerData, tileLayer.colliders.data(), tileCount);
+            ++header.layerCount;
+        }
+
+        TileHashGrid grid;
+        PathFindingGrid pathGrid;
+        for (int i = 0; i < colliders.size(); ++i)
+        {
+            const auto& [x, y, w, h] = colliders[i];
+            grid.insert(StaticIDHelper::CreateID(i, colliderClasses[i]), x, y, w, h);
+            PathFindingData::RasterizeRect(pathGrid, x, y, w, h);
+        }
+        grid.bake();
+        if (grid.offsets.empty())
+            grid.offsets.push_back(0);
+
+        header.colliderCount = colliders.size();
+        header.cellKeyCount = grid.cellKeys.size();
+        header.valueCount = grid.values.size();
+        header.pathBlockCount = static_cast<int>(pathGrid.visited.size());
+
+        out.clear();
+        out.reserve(static_cast<int>(GetBakedSize(header)));
+        AppendBaked(out, &header, 1);
+        AppendBaked(out, layerData.data(), layerData.size());
+        AppendBaked(out, colliders.data(), colliders.size());
+        AppendBaked(out, grid.cellKeys.data(), grid.cellKeys.size());
+        AppendBaked(out, grid.offsets.data(), grid.offsets.size());
+        AppendBaked(out, grid.values.data(), grid.values.size());
+        for (const auto& [key, block] : pathGrid.visited)
+        {
+            AppendBaked(out, &key, 1);
+            AppendBaked(out, &block, 1);
+        }
+        MAGIQUE_ASSERT(out.size() == GetBakedSize(header), "Baked size mismatch");
+    }
+
+    bool AddBakedTileCollisions(const MapID map, const Asset& bakedCollision)
+    {
+        auto& data = global::STATIC_COLL_DATA;
+        if (data.tileSet == nullptr)
+        {
+            LOG_WARNING("Cannot load tile collision data without tile set. Use LoadGlobalTileSet()");
+            return false;
+        }
+
+        if (data.colliderReferences.tilesCollisionMap.contains(map))
+        {
+            LOG_WARNING("Tile data for this map was already loaded. Remove it before you can load it again");
+            return false;
+        }
+
+        BakedTileCollisionHeader header;
+        const char* bytes = bakedCollision.getData();
+        const int size = bakedCollision.getSize();
+        if (bytes == nullptr || size < static_cast<int>(sizeof(header)))
+        {
+            LOG_WARNING("Baked tile collision is empty: %s", bakedCollision.getPath());
+            return false;
+        }
+        memcpy(&header, bytes, sizeof(header));
+        if (header.magic != BakedTileCollisionHeader::MAGIC || header.version != BakedTileCollisionHeader::VERSION ||
+            header.pathCellSize != PathFindingData::cellSize || header.pathBlockSize != sizeof(PathBlock))
+        {
+            LOG_WARNING("Baked tile collision was made with a different engine version: %s", bakedCollision.getPath());
+            return false;
+        }
+        if (header.width < 0 || header.height < 0 || header.layerCount < 0 || header.colliderCount < 0 ||
+            header.cellKeyCount < 0 || header.valueCount < 0 || header.pathBlockCount < 0 ||
+            ((header.width == 0 || header.height == 0) && header.colliderCount != 0) || // Empty maps have no chunk
+            GetBakedSize(header) != size)
+        {
+            LOG_WARNING("Baked tile collision is malformed: %s", bakedCollision.getPath());
+            return false;
+        }
+        const auto tileSize = data.tileSetScale * static_cast<float>(data.tileSet->getTileSize());
+        if (header.tileSize != tileSize)
+        {
+            LOG_WARNING("Baked tile collision uses a different tile size: %.1f | Global tileset: %.1f", header.tileSize,
+                        tileSize);
+            return false;
+        }
+
+        // Built before the tiles are registered - the baked tiles are added on top
         global::PATH_DATA.updateStaticPathGrid(map);
+
+        const int tileCount = header.width * header.height;
+        const int layerBytes = static_cast<int>(sizeof(int)) + tileCount * 8;
+        const char* ptr = bytes + sizeof(header) + header.layerCount * layerBytes;
+        const auto base = data.colliderStorage.insertRange(ptr, header.colliderCount);
+        ptr += header.colliderCount * sizeof(StaticCollider);
+
+        // Tile grid - the baked indices are offset to the actual collider indices
+        auto& grid = data.mapTileGrids[map];
+        const char* keys = ptr;
+        const char* offsets = keys + header.cellKeyCount * sizeof(CellID);
+        const char* values = offsets + (header.cellKeyCount + 1) * sizeof(uint32_t);
+        grid.assign(keys, header.cellKeyCount, offsets, values, header.valueCount);
+        for (auto& value : grid.values)
+        {
+            value += static_cast<StaticID>(base) << 32;
+        }
+        ptr = values + header.valueCount * sizeof(StaticID);
+
+        auto& mask = data.tileMasks[map];
+        mask.width = header.width;
+        mask.height = header.height;
+        mask.tileSize = tileSize;
+        mask.isStreamed = false;
+        mask.chunkSize = std::max({header.width, header.height, 1});
+        mask.chunksX = (header.width + mask.chunkSize - 1) / mask.chunkSize;
+        mask.chunksY = (header.height + mask.chunkSize - 1) / mask.chunkSize;
+        const char* layerPtr = bytes + sizeof(header);
+        for (int i = 0; i < header.layerCount; ++i)
+        {
+            mask.layers.push_back({});
+            auto& tileLayer = mask.layers.back();
+            tileLayer.tiles.resize(tileCount);
+            tileLayer.cells.resize(tileCount);
+            tileLayer.colliders.resize(tileCount);
+            memcpy(&tileLayer.layer, layerPtr, sizeof(int));
+            layerPtr += sizeof(int);
+            memcpy(tileLayer.tiles.data(), layerPtr, tileCount * sizeof(uint16_t));
+            layerPtr += tileCount * sizeof(uint16_t);
+            memcpy(tileLayer.cells.data(), layerPtr, tileCount * sizeof(int16_t));
+            layerPtr += tileCount * sizeof(int16_t);
+            memcpy(tileLayer.colliders.data(), layerPtr, tileCount * sizeof(uint32_t));
+            layerPtr += tileCount * sizeof(uint32_t);
+            for (auto& collider : tileLayer.colliders)
+            {
+                if (collider != TileCollisionLayer::NO_COLLIDER)
+                    collider += base;
+            }
+        }
+
+        // Everything is a single loaded chunk
+        data.colliderReferences.tilesCollisionMap[map]; // Marks the map as loaded
+        data.colliderReferences.tileChunkMap[map].resize(mask.chunksX * mask.chunksY);
+        for (int i = 0; i < header.colliderCount; ++i)
+        {
+            data.colliderReferences.addTileCollider(map, 0, base + i);
+        }
+
+        auto& pathGrid = global::PATH_DATA.mapsStaticGrids[map];
+        for (int i = 0; i < header.pathBlockCount; ++i)
+        {
+            VisitedCellID key;
+            PathBlock block;
+            memcpy(&key, ptr, sizeof(key));
+            memcpy(&block, ptr + sizeof(key), sizeof(block));
+            ptr += sizeof(key) + sizeof(block);
+            pathGrid.addBlock(key) |= block;
+        }
+        global::PATH_DATA.markStaticGridChanged(map);
+
+        data.mapBounds[map] = {0, 0, static_cast<float>(header.width) * tileSize,
+                               static_cast<float>(header.height) * tileSize};
+        return true;
+    }
+
+    //----------------- STREAMING -----------------//
+
+    void SetTileCollisionStreaming(const bool enabled, const int memoryBudget)
+    {
+        auto& data = global::STATIC_COLL_DATA;
+        if (!data.tileMasks.empty())
+        {
+            LOG_WARNING("Streaming only applies to maps whose tile collisions are added afterward");
+        }
+        data.streamTileChunks = enabled;
+        data.streamingBudget = memoryBudget;
+    }
+
+    void StreamTileCollisionChunks()
+    {
+        auto& data = global::STATIC_COLL_DATA;
+        if (data.streamedMaps == 0) [[likely]]
+        {
+            return;
+        }
+        const auto tick = global::ENGINE_DATA.engineTicks;
+        const auto updateDist = global::ENGINE_CONFIG.entityUpdateDistance;
+
+        // Loads all chunks within the update distance of an actor (+1 chunk for entities moving in)
+        const auto view = internal::REGISTRY.view<const ActorC, const PositionC>();
+        for (const auto actor : view)
+        {
+            const auto& pos = view.get<const PositionC>(actor);
+            const auto maskIt = data.tileMasks.find(pos.map);
+            if (maskIt == data.tileMasks.end() || !maskIt->second.isStreamed)
+                continue;
+
+            auto& mask = maskIt->second;
+            auto& chunks = data.colliderReferences.tileChunkMap[pos.map];
+            const float chunkPixels = static_cast<float>(mask.chunkSize) * mask.tileSize;
+            const float range = updateDist / 2.0F + chunkPixels;
+            const int x1 = std::max(0, static_cast<int>((pos.x - range) / chunkPixels));
+            const int y1 = std::max(0, static_cast<int>((pos.y - range) / chunkPixels));
+            const int x2 = std::min(mask.chunksX - 1, static_cast<int>((pos.x + range) / chunkPixels));
+            const int y2 = std::min(mask.chunksY - 1, static_cast<int>((pos.y + range) / chunkPixels));
+            for (int i = y1; i <= y2; ++i)
+            {
+                for (int j = x1; j <= x2; ++j)
+                {
+                    const int chunk = i * mask.chunksX + j;
+                    chunks[chunk].lastUsedTick = tick;
+                    if (!chunks[chunk].isLoaded)
+                    {
+                        LoadTileChunk(pos.map, mask, chunk); // Inserted at the front
+                        global::PATH_DATA.updateStaticPathRect(pos.map, GetChunkArea(pos.map, mask, chunk));
+                    }
+                    else
+                    {
+                        data.colliderReferences.touchChunk(pos.map, chunk);
+                    }
+                }
+            }
+        }
+
+        // Unloads the least recently used chunks until the loaded colliders fit the budget
+        auto& refs = data.colliderReferences;
+        while (data.loadedChunkBytes > data.streamingBudget && refs.lruTail.chunk != -1)
+        {
+            const auto [lruMap, lruChunk] = refs.lruTail;
+            if (refs.getChunk(refs.lruTail).lastUsedTick == tick) // All loaded chunks are in use
+                break;
+            auto& mask = data.tileMasks[lruMap];
+            const auto area = GetChunkArea(lruMap, mask, lruChunk); // Before the colliders are disabled
+            UnloadTileChunk(lruMap, mask, lruChunk);
+            global::PATH_DATA.updateStaticPathRect(lruMap, area);
+        }
     }
 
     //----------------- MANUAL GROUPS -----------------//
@@ -251,6 +1030,7 @@ namespace magique
             groupInfo.objectIds.push_back(num); // So we can uniquely delete later
         }
         mapGroupInfoVec.push_back(std::move(groupInfo));
+        hashGrids.bake();
         global::PATH_DATA.updateStaticPathGrid(map);
     }
 
@@ -191,11 +191,11 @@ namespace magique
         {
             if (!dynamic.mapEntityGrids.contains(currentMap))
                 return;
-            const auto& grid = dynamic.mapEntityGrids[currentMap];
+            const auto& grid = dynamic.mapEntityGrids[currentMap].level0; // Only the base level
             const auto bounds = GetCameraBounds();
-            constexpr int cellSize = MAGIQUE_COLLISION_CELL_SIZE;
+            const int cellSize = grid.getCellSize();
             const float fontSize = config.fontSize;
-            const float textOff = MAGIQUE_COLLISION_CELL_SIZE / 2.0F - fontSize / 2.0F;
+            const float textOff = static_cast<float>(cellSize) / 2.0F - fontSize / 2.0F;
             const int startX = static_cast<int>(bounds.x) / cellSize;
             const int startY = static_cast<int>(bounds.y) / cellSize;
             const int width = static_cast<int>(bounds.width) / cellSize;
@@ -207,19 +207,18 @@ namespace magique
                 for (int j = 0; j < width; ++j)
                 {
                     const int currX = startX + j;
-                    const int x = currX * MAGIQUE_COLLISION_CELL_SIZE;
-                    const int y = currY * MAGIQUE_COLLISION_CELL_SIZE;
+                    const int x = currX * cellSize;
+                    const int y = currY * cellSize;
 
-                    const auto id = GetCellID(currX, currY);
-                    const auto it = grid.cellMap.find(id);
-                    if (it != grid.cellMap.end())
+                    const int blockIdx = grid.findCell(currX, currY);
+                    if (blockIdx != -1)
                     {
-                        const auto count = static_cast<int>(grid.dataBlocks[it->second].size);
+                        const auto count = static_cast<int>(grid.dataBlocks[blockIdx].size);
                         const auto color = count > grid.getBlockSize() ? RED : GREEN; // Over the limit
                         const Vector2 pos = {static_cast<float>(x) + textOff, static_cast<float>(y) + textOff};
                         DrawTextEx(config.font, std::to_string(count).c_str(), pos, fontSize, 1, color);
                     }
-                    DrawRectangleLines(x, y, MAGIQUE_COLLISION_CELL_SIZE, MAGIQUE_COLLISION_CELL_SIZE, BLACK);
+                    DrawRectangleLines(x, y, cellSize, cellSize, BLACK);
                 }
             }
         };
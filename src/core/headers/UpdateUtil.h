@@ -8,11 +8,12 @@ namespace magique
     inline void InternalUpdatePre(const entt::registry& registry, Game& game) // Before user space update
     {
         global::TWEEN_DATA.update();
-        global::CONSOLE_DATA.update();  // First in case needs to block input
-        InputSystem();                  // Before gametick per contract (scripting system)
-        global::PARTICLE_DATA.update(); // Order doesnt matter
-        LogicSystem(registry);          // Before gametick cause essential
-                                        //        global::PATH_DATA.updateDynamicGrid();
+        global::CONSOLE_DATA.update();        // First in case needs to block input
+        InputSystem();                        // Before gametick per contract (scripting system)
+        global::PARTICLE_DATA.startUpdate();  // Workers update the particles while the logic system runs
+        LogicSystem(registry);                // Before gametick cause essential
+        global::PARTICLE_DATA.finishUpdate(); // Particles created in between are added here
+        PathRequestSystem();                  // After so the dynamic grids are up to date
         // Order doesnt matter
         auto& config = global::ENGINE_CONFIG;
         if (config.showPerformanceOverlay)
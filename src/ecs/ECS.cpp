@@ -6,8 +6,10 @@
 #include <magique/ecs/Scripting.h>
 #include <magique/ecs/Components.h>
 #include <magique/util/Logging.h>
+#include <magique/util/JobSystem.h>
 #include <magique/core/Animations.h>
 #include <magique/core/Camera.h>
+#include <magique/core/CollisionDetection.h>
 
 #include "internal/globals/ECSData.h"
 #include "internal/globals/EngineData.h"
@@ -16,6 +18,7 @@
 #include "internal/globals/PathFindingData.h"
 #include "internal/globals/ScriptData.h"
 #include "internal/utils/STLUtil.h"
+#include "internal/utils/CollisionPrimitives.h"
 
 namespace magique
 {
@@ -331,5 +334,307 @@ namespace magique
         return data.nearbyQueryData.cache.contains(target);
     }
 
+    //----------------- SPATIAL QUERIES -----------------//
+
+    namespace
+    {
+        Rectangle GetQueryBoundingBox(const entt::entity e)
+        {
+            const auto& pos = internal::REGISTRY.get<const PositionC>(e);
+            const auto& col = internal::REGISTRY.get<const CollisionC>(e);
+            return GetEntityBoundingBox(pos, col);
+        }
+
+        // Distance from the point to the closest point of the rectangle - 0 if inside
+        float GetDistanceToRect(const Point p, const Rectangle& r)
+        {
+            const float dx = maxValue(maxValue(r.x - p.x, p.x - (r.x + r.width)), 0.0F);
+            const float dy = maxValue(maxValue(r.y - p.y, p.y - (r.y + r.height)), 0.0F);
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        // Appends all entities whose bounding box intersects the query area to out
+        template <typename Vec>
+        void CollectEntityQuery(const EntityHashGrid& grid, const EntityQuery& query, HashSet<entt::entity>& visited,
+                                Vec& out)
+        {
+            visited.clear();
+            const float half = query.isCircle ? query.size : query.size / 2.0F;
+            const float x = query.mid.x - half;
+            const float y = query.mid.y - half;
+            grid.query(visited, x, y, half * 2.0F, half * 2.0F);
+            for (const auto e : visited)
+            {
+                const auto bb = GetQueryBoundingBox(e);
+                if (query.isCircle)
+                {
+                    // Skips the candidates in the corners of the square query
+                    if (GetDistanceToRect(query.mid, bb) <= query.size)
+                        out.push_back(e);
+                }
+                else if (RectToRect(x, y, half * 2.0F, half * 2.0F, bb.x, bb.y, bb.width, bb.height))
+                {
+                    out.push_back(e);
+                }
+            }
+        }
+
+        // Runs the queries in [start, end) into the buffers of the given part
+        void CollectEntityQueryRange(const EntityHashGrid* grid, const EntityQuery* queries, const int start,
+                                     const int end, const int part)
+        {
+            auto& data = global::ENGINE_DATA.spatialQueryData;
+            auto& entities = data.partEntities[part].vec;
+            auto& counts = data.partCounts[part].vec;
+            for (int i = start; i < end; ++i)
+            {
+                const auto before = entities.size();
+                if (queries[i].size > 0.0F) [[likely]]
+                    CollectEntityQuery(*grid, queries[i], data.partVisited[part].set, entities);
+                counts.push_back(static_cast<int>(entities.size() - before));
+            }
+        }
+
+        bool SortByDistance(const std::pair<float, entt::entity>& a, const std::pair<float, entt::entity>& b)
+        {
+            return a.first < b.first;
+        }
+    } // namespace
+
+    const std::vector<RaycastHit>& RaycastEntities(const MapID map, const Point origin, Point direction,
+                                                   const float maxDist, const int maxHits)
+    {
+        auto& query = global::ENGINE_DATA.spatialQueryData;
+        query.hits.clear();
+        query.visited.clear();
+
+        const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (length == 0.0F || maxDist <= 0.0F) [[unlikely]]
+        {
+            LOG_WARNING("Invalid raycast: direction must not be zero and maxDist must be positive");
+            return query.hits;
+        }
+        direction.x /= length;
+        direction.y /= length;
+
+        const auto& grids = global::DY_COLL_DATA.mapEntityGrids;
+        if (!grids.contains(map))
+        {
+            return query.hits;
+        }
+
+        auto onCell = [&](const auto& level, const int cellX, const int cellY)
+        {
+            level.forEachInCell(cellX, cellY,
+                                [&](const entt::entity e)
+                                {
+                                    if (!query.visited.insert(e).second)
+                                        return false;
+                                    const auto bb = GetQueryBoundingBox(e);
+                                    float dist = 0;
+                                    if (RayToRect(origin.x, origin.y, direction.x, direction.y, maxDist, bb.x, bb.y,
+                                                  bb.width, bb.height, dist))
+                                    {
+                                        const Point point = {origin.x + direction.x * dist,
+                                                             origin.y + direction.y * dist};
+                                        query.hits.push_back({e, point, dist});
+                                    }
+                                    return false;
+                                });
+        };
+
+        auto byDistance = [](const RaycastHit& a, const RaycastHit& b) { return a.distance < b.distance; };
+        grids[map].forEachLevel(
+            [&](const auto& level)
+            {
+                if (level.getCellCount() == 0)
+                    return;
+                level.traverseRay(origin.x, origin.y, direction.x, direction.y, maxDist,
+                                  [&](const int cellX, const int cellY, const float dist)
+                                  {
+                                      // All hits closer than this cell were found already
+                                      if (maxHits > 0 && static_cast<int>(query.hits.size()) >= maxHits)
+                                      {
+                                          const auto nth = query.hits.begin() + (maxHits - 1);
+                                          std::ranges::nth_element(query.hits, nth, byDistance);
+                                          if (nth->distance <= dist)
+                                              return true;
+                                      }
+                                      onCell(level, cellX, cellY);
+                                      return false;
+                                  });
+            });
+
+        std::ranges::sort(query.hits, byDistance);
+        if (maxHits > 0 && static_cast<int>(query.hits.size()) > maxHits)
+        {
+            query.hits.resize(maxHits);
+        }
+        return query.hits;
+    }
+
+    const std::vector<entt::entity>& GetEntitiesInCircle(const MapID map, const Point mid, const float radius)
+    {
+        auto& query = global::ENGINE_DATA.spatialQueryData;
+        query.entities.clear();
+
+        const auto& grids = global::DY_COLL_DATA.mapEntityGrids;
+        if (!grids.contains(map) || radius <= 0.0F)
+        {
+            return query.entities;
+        }
+        CollectEntityQuery(grids[map], {mid, radius, true}, query.visited, query.entities);
+        return query.entities;
+    }
+
+    const std::vector<entt::entity>& FindKNearest(const MapID map, const Point pos, const int k,
+                                                  const std::function<bool(entt::entity)>& filter, const float maxDist)
+    {
+        auto& query = global::ENGINE_DATA.spatialQueryData;
+        query.entities.clear();
+        query.sorted.clear();
+        query.visited.clear();
+
+        const auto& grids = global::DY_COLL_DATA.mapEntityGrids;
+        if (!grids.contains(map) || k <= 0)
+        {
+            return query.entities;
+        }
+
+        const auto& grid = grids[map];
+        auto addCandidate = [&](const entt::entity e)
+        {
+            if (!query.visited.insert(e).second)
+                return false;
+            if (filter && !filter(e))
+                return false;
+            const float dist = GetDistanceToRect(pos, GetQueryBoundingBox(e));
+            if (dist <= maxDist)
+            {
+                query.sorted.push_back({dist, e});
+            }
+            return false;
+        };
+
+        // Large entities are only looked up in the coarse cells within maxDist
+        // They are not in the base level - the visited set is only shared to skip duplicates across cells
+        if (!grid.coarseElements.empty())
+        {
+            const float size = maxDist * 2.0F;
+            grid.level1.query(query.visited, pos.x - maxDist, pos.y - maxDist, size, size);
+            grid.level2.query(query.visited, pos.x - maxDist, pos.y - maxDist, size, size);
+            for (const auto e : query.visited)
+            {
+                const float dist = GetDistanceToRect(pos, GetQueryBoundingBox(e));
+                if (dist <= maxDist && (!filter || filter(e)))
+                    query.sorted.push_back({dist, e});
+            }
+        }
+
+        // Searches the base level in growing rings around the cell of the position
+        // Everything not found until ring r is at least r * cellSize away - stop once the kth candidate is closer
+        const auto& level = grid.level0;
+        const auto cellSize = static_cast<float>(level.getCellSize());
+        const int centerX = static_cast<int>(std::floor(pos.x / cellSize));
+        const int centerY = static_cast<int>(std::floor(pos.y / cellSize));
+        const int maxRing = static_cast<int>(maxDist / cellSize) + 1;
+        for (int r = 0; r <= maxRing; ++r)
+        {
+            for (int x = centerX - r; x <= centerX + r; ++x)
+            {
+                level.forEachInCell(x, centerY - r, addCandidate);
+                if (r != 0)
+                    level.forEachInCell(x, centerY + r, addCandidate);
+            }
+            for (int y = centerY - r + 1; y <= centerY + r - 1; ++y)
+            {
+                level.forEachInCell(centerX - r, y, addCandidate);
+                level.forEachInCell(centerX + r, y, addCandidate);
+            }
+
+            if (static_cast<int>(query.sorted.size()) >= k)
+            {
+                std::ranges::nth_element(query.sorted, query.sorted.begin() + (k - 1), SortByDistance);
+                if (query.sorted[k - 1].first <= static_cast<float>(r) * cellSize)
+                    break;
+            }
+        }
+
+        const int count = minValue(k, static_cast<int>(query.sorted.size()));
+        std::ranges::partial_sort(query.sorted, query.sorted.begin() + count, SortByDistance);
+        for (int i = 0; i < count; ++i)
+        {
+            query.entities.push_back(query.sorted[i].second);
+        }
+        return query.entities;
+    }
+
+    std::span<const entt::entity> EntityQueryResults::get(const int query) const
+    {
+        MAGIQUE_ASSERT(query >= 0 && query < getQueryCount(), "Query index out of bounds");
+        return {entities.data() + offsets[query], static_cast<size_t>(offsets[query + 1] - offsets[query])};
+    }
+
+    int EntityQueryResults::getQueryCount() const
+    {
+        return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1;
+    }
+
+    const EntityQueryResults& QueryEntitiesBatch(const MapID map, const std::vector<EntityQuery>& queries)
+    {
+        static EntityQueryResults results; // Single instance - only valid until the next call
+        auto& data = global::ENGINE_DATA.spatialQueryData;
+        results.entities.clear();
+        results.offsets.clear();
+        results.offsets.push_back(0);
+
+        const auto& grids = global::DY_COLL_DATA.mapEntityGrids;
+        const int size = static_cast<int>(queries.size());
+        if (!grids.contains(map))
+        {
+            results.offsets.resize(size + 1, 0);
+            return results;
+        }
+
+        for (int j = 0; j < COL_WORK_PARTS; ++j)
+        {
+            data.partEntities[j].vec.clear();
+            data.partCounts[j].vec.clear();
+        }
+
+        const auto* grid = &grids[map];
+        int parts = 1;
+        if (size < SpatialQueryData::MIN_PARALLEL_QUERIES)
+        {
+            CollectEntityQueryRange(grid, queries.data(), 0, size, 0);
+        }
+        else
+        {
+            std::array<jobHandle, COL_WORK_PARTS> handles{};
+            int end = 0;
+            const int partSize = size / COL_WORK_PARTS;
+            for (int j = 0; j < COL_WORK_PARTS - 1; ++j)
+            {
+                const int start = end;
+                end = start + partSize;
+                handles[j] = AddJob(CreateExplicitJob(CollectEntityQueryRange, grid, queries.data(), start, end, j));
+            }
+            CollectEntityQueryRange(grid, queries.data(), end, size, COL_WORK_PARTS - 1);
+            AwaitJobs(handles);
+            parts = COL_WORK_PARTS;
+        }
+
+        // Merge in query order - the parts hold consecutive query ranges
+        for (int j = 0; j < parts; ++j)
+        {
+            const auto& entities = data.partEntities[j].vec;
+            results.entities.insert(results.entities.end(), entities.begin(), entities.end());
+            for (const int count : data.partCounts[j].vec)
+            {
+                results.offsets.push_back(results.offsets.back() + count);
+            }
+        }
+        return results;
+    }
 
 } // namespace magique
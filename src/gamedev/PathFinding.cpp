@@ -1,24 +1,58 @@
 // SPDX-License-Identifier: zlib-acknowledgement
+#include <algorithm>
+#include <limits>
 #include <raylib/raylib.h>
 
 #include <magique/gamedev/PathFinding.h>
 #include <magique/core/Camera.h>
+#include <magique/util/JobSystem.h>
+#include <magique/util/Logging.h>
 
 #include "internal/globals/PathFindingData.h"
+#include "internal/globals/EngineData.h"
 
 namespace magique
 {
     bool FindPath(std::vector<Point>& pathVec, const Point start, const Point end, const MapID map, const int maxLen,
-                  GridMode mode)
+                  GridMode mode, const PathAlgorithm algorithm, int agentSize)
     {
         auto& path = global::PATH_DATA;
-        return path.findPath(pathVec, start, end, map, maxLen, mode);
+        agentSize = std::clamp(agentSize, 1, ClearanceMap::MAX);
+        const bool useCache = path.cachedPaths.capacity > 0;
+        PathCacheKey key{};
+        if (useCache)
+        {
+            key = PathFindingData::GetCacheKey(start, end, map, maxLen, mode, algorithm, agentSize);
+            if (path.getCachedPath(key, pathVec))
+                return true;
+        }
+
+        bool found;
+        if (algorithm == PathAlgorithm::JUMP_POINT && mode == GridMode::STAR && agentSize == 1)
+        {
+            found = path.findJumpPath(pathVec, start, end, map, maxLen);
+        }
+        else if (algorithm == PathAlgorithm::BIDIRECTIONAL && agentSize == 1)
+        {
+            found = path.findBidirectionalPath(pathVec, start, end, map, maxLen, mode);
+        }
+        else
+        {
+            found = path.findPath(pathVec, start, end, map, maxLen, mode, agentSize);
+        }
+
+        if (found && useCache)
+        {
+            path.cachePath(key, pathVec);
+        }
+        return found;
     }
 
-    bool FindNextPoint(Point& next, const Point start, const Point end, const MapID map, const int maxLen, GridMode mode)
+    bool FindNextPoint(Point& next, const Point start, const Point end, const MapID map, const int maxLen, GridMode mode,
+                       const PathAlgorithm algorithm, const int agentSize)
     {
         auto& path = global::PATH_DATA;
-        FindPath(path.pathCache, start, end, map, maxLen, mode);
+        FindPath(path.pathCache, start, end, map, maxLen, mode, algorithm, agentSize);
         if (path.pathCache.empty())
         {
             return false;
@@ -27,53 +61,811 @@ namespace magique
         return true;
     }
 
-    // Same as FindPath() but allows to specify the dimensions of the searching entity
-    // The pathfinding tries to find a path that fits the entity
-    // static void FindPathEx(std::vector<Point>& path, Point start, Point end, Point dimensions, int searchLen) {}
+    //----------------- HIERARCHICAL -----------------//
 
-    bool GetPathRayCast(const Point start, const Point end, const MapID map)
+    namespace
     {
-        auto& path = global::PATH_DATA;
-        const auto& staticGrid = path.mapsStaticGrids[map];
-        const auto& dynamicGrid = path.mapsDynamicGrids[map];
+        constexpr int CLUSTER_SIZE = ClusterGraph::SIZE;
+        constexpr int CLUSTER_CELLS = CLUSTER_SIZE * CLUSTER_SIZE;
+        constexpr float NO_COST = std::numeric_limits<float>::max();
+
+        struct CostEntry final
+        {
+            float cost;
+            int idx;
+            bool operator>(const CostEntry& o) const { return cost > o.cost; }
+        };
+
+        // Shortest paths from a cell to all cells of its cluster - the path never leaves the cluster
+        struct ClusterSearch final
+        {
+            int originX = 0, originY = 0; // Top left cell of the cluster
+            bool solid[CLUSTER_CELLS]{};
+            float cost[CLUSTER_CELLS]{};
+            int16_t parent[CLUSTER_CELLS]{};
+            cxstructs::PriorityQueue<CostEntry> queue{CLUSTER_CELLS};
+
+            void load(const ClusterGraph& graph, const PathFindingGrid& grid, const int clusterX, const int clusterY)
+            {
+                originX = clusterX * CLUSTER_SIZE;
+                originY = clusterY * CLUSTER_SIZE;
+                for (int i = 0; i < CLUSTER_SIZE; ++i)
+                {
+                    for (int j = 0; j < CLUSTER_SIZE; ++j)
+                        solid[i * CLUSTER_SIZE + j] = !IsFree(graph, grid, originX + j, originY + i);
+                }
+            }
+
+            void search(const int startX, const int startY)
+            {
+                std::fill_n(cost, CLUSTER_CELLS, NO_COST);
+                std::fill_n(parent, CLUSTER_CELLS, static_cast<int16_t>(-1));
+                const int start = toIndex(startX, startY);
+                cost[start] = 0;
+                queue.clear();
+                queue.push({0, start});
+                while (!queue.empty())
+                {
+                    const auto [currCost, idx] = queue.top();
+                    queue.pop();
+                    if (currCost > cost[idx])
+                        continue;
+                    const int x = idx % CLUSTER_SIZE;
+                    const int y = idx / CLUSTER_SIZE;
+                    for (const auto& dir : MOVEMENTS[(int)GridMode::STAR])
+                    {
+                        const int nx = x + static_cast<int>(dir.x);
+                        const int ny = y + static_cast<int>(dir.y);
+                        if (nx < 0 || ny < 0 || nx >= CLUSTER_SIZE || ny >= CLUSTER_SIZE)
+                            continue;
+                        const int next = ny * CLUSTER_SIZE + nx;
+                        const float newCost = currCost + MOVE_COST[(int)GridMode::STAR](dir);
+                        if (solid[next] || newCost >= cost[next])
+                            continue;
+                        cost[next] = newCost;
+                        parent[next] = static_cast<int16_t>(idx);
+                        queue.push({newCost, next});
+                    }
+                }
+            }
+
+            [[nodiscard]] float getCost(const int cellX, const int cellY) const { return cost[toIndex(cellX, cellY)]; }
+
+            // Appends the cells from the search start (excluded) to the given cell
+            void appendPath(const int cellX, const int cellY, vector<Point>& cells) const
+            {
+                const int begin = cells.size();
+                for (int idx = toIndex(cellX, cellY); parent[idx] != -1; idx = parent[idx])
+                {
+                    cells.push_back({static_cast<float>(originX + idx % CLUSTER_SIZE),
+                                     static_cast<float>(originY + idx / CLUSTER_SIZE)});
+                }
+                std::reverse(cells.begin() + begin, cells.end());
+            }
+
+            static bool IsFree(const ClusterGraph& graph, const PathFindingGrid& grid, const int cellX, const int cellY)
+            {
+                if (cellX < graph.minX || cellY < graph.minY || cellX > graph.maxX || cellY > graph.maxY)
+                    return false;
+                return !grid.getIsMarked(static_cast<float>(cellX * MAGIQUE_PATHFINDING_CELL_SIZE),
+                                         static_cast<float>(cellY * MAGIQUE_PATHFINDING_CELL_SIZE));
+            }
+
+        private:
+            [[nodiscard]] int toIndex(const int cellX, const int cellY) const
+            {
+                return (cellY - originY) * CLUSTER_SIZE + (cellX - originX);
+            }
+        };
+
+        struct Transition final
+        {
+            int x, y;           // Cell inside the cluster
+            int otherX, otherY; // Cell inside the neighboring cluster
+            float cost;
+        };
+
+        struct AbstractNode final
+        {
+            int x, y;
+            float gCost;
+            int parent;
+        };
+
+        // Search state - like PATH_DATA only used from the main thread
+        ClusterSearch CLUSTER_SEARCH;
+        ClusterSearch END_SEARCH;
+        vector<Transition> TRANSITIONS;
+        vector<AbstractNode> ABSTRACT_NODES;
+        HashMap<VisitedCellID, float> ABSTRACT_COSTS; // Negative once the node is closed
+        cxstructs::PriorityQueue<CostEntry> ABSTRACT_QUEUE{256};
+
+        int GetCluster(const int cell) { return floordiv(cell, CLUSTER_SIZE); }
+
+        float OctileCost(const int x1, const int y1, const int x2, const int y2)
+        {
+            const int dx = std::abs(x1 - x2);
+            const int dy = std::abs(y1 - y2);
+            return static_cast<float>(std::min(dx, dy)) * 1.40F + static_cast<float>(std::abs(dx - dy));
+        }
+
+        // Finds the cells where the cluster can be entered from its neighbors
+        // Both sides compute the same transitions for their shared border - so the nodes always have a counterpart
+        void FindTransitions(const ClusterGraph& graph, const PathFindingGrid& grid, const int originX,
+                             const int originY)
+        {
+            const auto isFree = [&](const int x, const int y) { return ClusterSearch::IsFree(graph, grid, x, y); };
+            TRANSITIONS.clear();
+            for (const auto& dir : MOVEMENTS[(int)GridMode::CROSS])
+            {
+                const int dx = static_cast<int>(dir.x);
+                const int dy = static_cast<int>(dir.y);
+                // First border cell and the step along the border
+                const int borderX = originX + (dx > 0 ? CLUSTER_SIZE - 1 : 0);
+                const int borderY = originY + (dy > 0 ? CLUSTER_SIZE - 1 : 0);
+                const int stepX = dx == 0 ? 1 : 0;
+                const int stepY = dy == 0 ? 1 : 0;
+                const auto ownFree = [&](const int i) { return isFree(borderX + stepX * i, borderY + stepY * i); };
+                const auto otherFree = [&](const int i)
+                { return isFree(borderX + stepX * i + dx, borderY + stepY * i + dy); };
+                const auto add = [&](const int i, const int otherI, const float cost)
+                {
+                    TRANSITIONS.push_back({borderX + stepX * i, borderY + stepY * i, borderX + stepX * otherI + dx,
+                                           borderY + stepY * otherI + dy, cost});
+                };
+
+                // Runs of free cells on both sides - short ones get a transition in the middle, long ones at the ends
+                int i = 0;
+                while (i < CLUSTER_SIZE)
+                {
+                    if (!ownFree(i) || !otherFree(i))
+                    {
+                        ++i;
+                        continue;
+                    }
+                    int end = i;
+                    while (end < CLUSTER_SIZE && ownFree(end) && otherFree(end))
+                        ++end;
+                    if (end - i < 6)
+                    {
+                        add((i + end) / 2, (i + end) / 2, 1.0F);
+                    }
+                    else
+                    {
+                        add(i, i, 1.0F);
+                        add(end - 1, end - 1, 1.0F);
+                    }
+                    i = end;
+                }
 
-        int x0 = static_cast<int>(start.x / MAGIQUE_PATHFINDING_CELL_SIZE);
-        int y0 = static_cast<int>(start.y / MAGIQUE_PATHFINDING_CELL_SIZE);
-        int const x1 = static_cast<int>(end.x / MAGIQUE_PATHFINDING_CELL_SIZE);
-        int const y1 = static_cast<int>(end.y / MAGIQUE_PATHFINDING_CELL_SIZE);
+                // Cells only connected diagonally across the border
+                for (int j = 0; j < CLUSTER_SIZE; ++j)
+                {
+                    if (!ownFree(j) || otherFree(j))
+                        continue;
+                    for (const int k : {j - 1, j + 1})
+                    {
+                        if (k >= 0 && k < CLUSTER_SIZE && otherFree(k) && !ownFree(k))
+                            add(j, k, 1.40F);
+                    }
+                }
+            }
+
+            // Corner cells only connected diagonally to the diagonal neighbor
+            for (const auto& dir : MOVEMENTS[(int)GridMode::STAR])
+            {
+                const int dx = static_cast<int>(dir.x);
+                const int dy = static_cast<int>(dir.y);
+                if (dx == 0 || dy == 0)
+                    continue;
+                const int x = originX + (dx > 0 ? CLUSTER_SIZE - 1 : 0);
+                const int y = originY + (dy > 0 ? CLUSTER_SIZE - 1 : 0);
+                if (isFree(x, y) && isFree(x + dx, y + dy) && !isFree(x + dx, y) && !isFree(x, y + dy))
+                    TRANSITIONS.push_back({x, y, x + dx, y + dy, 1.40F});
+            }
+        }
+
+        void BuildCluster(PathCluster& cluster, const ClusterGraph& graph, const PathFindingGrid& grid,
+                          const int clusterX, const int clusterY)
+        {
+            auto& search = CLUSTER_SEARCH;
+            search.load(graph, grid, clusterX, clusterY);
+            FindTransitions(graph, grid, search.originX, search.originY);
+
+            cluster.nodes.clear();
+            cluster.edges.clear();
+            for (const auto& transition : TRANSITIONS)
+            {
+                if (cluster.findNode(transition.x, transition.y) == -1)
+                    cluster.nodes.push_back({transition.x, transition.y, 0, 0});
+            }
+
+            for (auto& node : cluster.nodes)
+            {
+                node.firstEdge = cluster.edges.size();
+                search.search(node.x, node.y);
+                for (const auto& other : cluster.nodes)
+                {
+                    const float cost = search.getCost(other.x, other.y);
+                    if (&other != &node && cost != NO_COST)
+                        cluster.edges.push_back({other.x, other.y, cost});
+                }
+                for (const auto& transition : TRANSITIONS)
+                {
+                    if (transition.x == node.x && transition.y == node.y)
+                        cluster.edges.push_back({transition.otherX, transition.otherY, transition.cost});
+                }
+                node.edgeCount = cluster.edges.size() - node.firstEdge;
+            }
+            cluster.isDirty = false;
+        }
 
-        int const dx = std::abs(x1 - x0);
-        int const sx = x0 < x1 ? 1 : -1;
-        int const dy = -std::abs(y1 - y0);
-        int const sy = y0 < y1 ? 1 : -1;
-        int error = dx + dy;
+        const PathCluster& GetPathCluster(ClusterGraph& graph, const PathFindingGrid& grid, const int clusterX,
+                                          const int clusterY)
+        {
+            auto& cluster = graph.clusters[GetVisitedCell(clusterX, clusterY)];
+            if (cluster.isDirty)
+            {
+                BuildCluster(cluster, graph, grid, clusterX, clusterY);
+            }
+            return cluster;
+        }
 
-        while (true)
+        void PushAbstractNode(const int x, const int y, const float gCost, const int parent, const int endX,
+                              const int endY)
         {
-            const float x = static_cast<float>(x0) * MAGIQUE_PATHFINDING_CELL_SIZE;
-            const float y = static_cast<float>(y0) * MAGIQUE_PATHFINDING_CELL_SIZE;
-            // DrawRectangleRec({x, y, MAGIQUE_PATHFINDING_CELL_SIZE, MAGIQUE_PATHFINDING_CELL_SIZE}, PURPLE);
-            if (PathFindingData::IsCellSolid(x, y, staticGrid, dynamicGrid))
+            const auto [it, inserted] = ABSTRACT_COSTS.try_emplace(GetVisitedCell(x, y), gCost);
+            if (!inserted)
             {
-                return false;
+                if (it->second < 0 || it->second <= gCost)
+                    return;
+                it->second = gCost;
             }
-            if (x0 == x1 && y0 == y1)
+            ABSTRACT_QUEUE.push({gCost + OctileCost(x, y, endX, endY), ABSTRACT_NODES.size()});
+            ABSTRACT_NODES.push_back({x, y, gCost, parent});
+        }
+    } // namespace
+
+    bool FindLongPath(std::vector<Point>& pathVec, const Point start, const Point end, const MapID map,
+                      const int refineClusters)
+    {
+        auto& path = global::PATH_DATA;
+        pathVec.clear();
+        path.expandedNodes = 0;
+
+        const auto bounds = global::STATIC_COLL_DATA.getMapBounds(map);
+        if (bounds.width <= 0 || bounds.height <= 0)
+        {
+            return false;
+        }
+
+        // Cells inside the map bounds - the graph is rebuilt if they changed
+        constexpr float cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+        auto& graph = path.mapsClusterGraphs[map];
+        const int minX = static_cast<int>(std::floor(bounds.x / cellSize));
+        const int minY = static_cast<int>(std::floor(bounds.y / cellSize));
+        const int maxX = static_cast<int>(std::ceil((bounds.x + bounds.width) / cellSize)) - 1;
+        const int maxY = static_cast<int>(std::ceil((bounds.y + bounds.height) / cellSize)) - 1;
+        if (graph.minX != minX || graph.minY != minY || graph.maxX != maxX || graph.maxY != maxY)
+        {
+            graph.clusters.clear();
+            graph.minX = minX;
+            graph.minY = minY;
+            graph.maxX = maxX;
+            graph.maxY = maxY;
+        }
+
+        const auto& grid = path.mapsStaticGrids[map];
+        const int startX = static_cast<int>(std::floor(start.x / cellSize));
+        const int startY = static_cast<int>(std::floor(start.y / cellSize));
+        const int endX = static_cast<int>(std::floor(end.x / cellSize));
+        const int endY = static_cast<int>(std::floor(end.y / cellSize));
+        if (!ClusterSearch::IsFree(graph, grid, startX, startY) || !ClusterSearch::IsFree(graph, grid, endX, endY))
+        {
+            return false;
+        }
+
+        // The end is connected to the nodes of its cluster
+        const int endClusterX = GetCluster(endX);
+        const int endClusterY = GetCluster(endY);
+        END_SEARCH.load(graph, grid, endClusterX, endClusterY);
+        END_SEARCH.search(endX, endY);
+
+        ABSTRACT_NODES.clear();
+        ABSTRACT_COSTS.clear();
+        ABSTRACT_QUEUE.clear();
+        PushAbstractNode(startX, startY, 0, -1, endX, endY);
+
+        int found = -1;
+        while (!ABSTRACT_QUEUE.empty())
+        {
+            const int idx = ABSTRACT_QUEUE.top().idx;
+            ABSTRACT_QUEUE.pop();
+            const auto [x, y, gCost, parent] = ABSTRACT_NODES[idx];
+            auto& cost = ABSTRACT_COSTS[GetVisitedCell(x, y)];
+            if (cost < 0)
+                continue;
+            cost = -1;
+            ++path.expandedNodes;
+            if (x == endX && y == endY)
+            {
+                found = idx;
                 break;
-            int const e2 = 2 * error;
-            if (e2 >= dy)
+            }
+
+            const int clusterX = GetCluster(x);
+            const int clusterY = GetCluster(y);
+            const auto& cluster = GetPathCluster(graph, grid, clusterX, clusterY);
+            if (clusterX == endClusterX && clusterY == endClusterY && END_SEARCH.getCost(x, y) != NO_COST)
             {
-                error = error + dy;
-                x0 = x0 + sx;
+                PushAbstractNode(endX, endY, gCost + END_SEARCH.getCost(x, y), idx, endX, endY);
             }
-            if (e2 <= dx)
+
+            if (parent == -1) // The start is connected to the nodes of its cluster
+            {
+                CLUSTER_SEARCH.load(graph, grid, clusterX, clusterY);
+                CLUSTER_SEARCH.search(x, y);
+                for (const auto& node : cluster.nodes)
+                {
+                    const float cost = CLUSTER_SEARCH.getCost(node.x, node.y);
+                    if (cost != NO_COST)
+                        PushAbstractNode(node.x, node.y, cost, idx, endX, endY);
+                }
+            }
+
+            const int nodeIdx = cluster.findNode(x, y);
+            if (nodeIdx == -1) // Only the start
+                continue;
+            const auto& node = cluster.nodes[nodeIdx];
+            for (int i = node.firstEdge; i < node.firstEdge + node.edgeCount; ++i)
             {
-                error = error + dx;
-                y0 = y0 + sy;
+                const auto& edge = cluster.edges[i];
+                PushAbstractNode(edge.x, edge.y, gCost + edge.cost, idx, endX, endY);
             }
         }
+
+        if (found == -1)
+        {
+            return false;
+        }
+
+        // Waypoints from start to end
+        vector<Point> waypoints;
+        for (int idx = found; idx != -1; idx = ABSTRACT_NODES[idx].parent)
+        {
+            const auto& node = ABSTRACT_NODES[idx];
+            waypoints.push_back({static_cast<float>(node.x), static_cast<float>(node.y)});
+        }
+        std::reverse(waypoints.begin(), waypoints.end());
+
+        // Refine the segments inside the first clusters to cells - the rest stays as waypoints
+        vector<Point> cells;
+        int refined = 0;
+        for (int i = 1; i < waypoints.size(); ++i)
+        {
+            const auto& from = waypoints[i - 1];
+            const auto& to = waypoints[i];
+            const int clusterX = GetCluster(static_cast<int>(from.x));
+            const int clusterY = GetCluster(static_cast<int>(from.y));
+            const bool sameCluster =
+                clusterX == GetCluster(static_cast<int>(to.x)) && clusterY == GetCluster(static_cast<int>(to.y));
+            if (from == to)
+                continue;
+            if (sameCluster && refined < refineClusters)
+            {
+                CLUSTER_SEARCH.load(graph, grid, clusterX, clusterY);
+                CLUSTER_SEARCH.search(static_cast<int>(from.x), static_cast<int>(from.y));
+                CLUSTER_SEARCH.appendPath(static_cast<int>(to.x), static_cast<int>(to.y), cells);
+                ++refined;
+            }
+            else
+            {
+                cells.push_back(to);
+            }
+        }
+
+        pathVec.reserve(cells.size());
+        for (int i = cells.size() - 1; i >= 0; --i)
+        {
+            const auto& cell = cells[i];
+            pathVec.push_back({(cell.x * cellSize) + (cellSize / 2.0F), (cell.y * cellSize) + (cellSize / 2.0F)});
+        }
         return true;
     }
 
+    //----------------- FLOW FIELDS -----------------//
+
+    namespace
+    {
+        constexpr int MAX_FLOW_FIELDS = 32;                // Least recently used fields are removed
+        constexpr int MIN_PARALLEL_FLOW_CELLS = 256 * 256; // Smaller fields derive their directions on the main thread
+
+        vector<uint8_t> FLOW_SOLID; // Solid cells of the field that is built
+        cxstructs::PriorityQueue<CostEntry> FLOW_QUEUE{256};
+
+        uint64_t GetDynamicGridHash(const MapID map)
+        {
+            auto& path = global::PATH_DATA;
+            auto& [tick, hash] = path.dynamicHashes[map];
+            const auto currentTick = global::ENGINE_DATA.engineTicks;
+            if (tick == currentTick)
+            {
+                return hash;
+            }
+            // Independent of the iteration order
+            hash = 0;
+            for (const auto& [key, block] : path.mapsDynamicGrids[map].visited)
+            {
+                const auto blockHash = ankerl::unordered_dense::detail::wyhash::hash(&block, sizeof(block));
+                hash ^= ankerl::unordered_dense::detail::wyhash::hash(blockHash + key);
+            }
+            tick = currentTick;
+            return hash;
+        }
+
+        // Each cell points to the neighbor with the lowest cost to the goal over it - only downhill
+        void DeriveFlowDirections(FlowField* field, const int startRow, const int endRow)
+        {
+            const auto& movement = MOVEMENTS[(int)GridMode::STAR];
+            const int size = field->size;
+            for (int i = startRow; i < endRow; ++i)
+            {
+                for (int j = 0; j < size; ++j)
+                {
+                    const int idx = i * size + j;
+                    int8_t best = FlowField::NO_DIRECTION;
+                    float bestCost = NO_COST;
+                    for (int d = 0; d < static_cast<int>(movement.size()); ++d)
+                    {
+                        const int nx = j + static_cast<int>(movement[d].x);
+                        const int ny = i + static_cast<int>(movement[d].y);
+                        if (nx < 0 || ny < 0 || nx >= size || ny >= size)
+                            continue;
+                        const float nextCost = field->costs[ny * size + nx];
+                        if (nextCost >= field->costs[idx])
+                            continue;
+                        const float cost = nextCost + MOVE_COST[(int)GridMode::STAR](movement[d]);
+                        if (cost < bestCost)
+                        {
+                            bestCost = cost;
+                            best = static_cast<int8_t>(d);
+                        }
+                    }
+                    field->directions[idx] = best;
+                }
+            }
+        }
+
+        void BuildFlowField(FlowField& field, const MapID map, const int goalX, const int goalY, const int radius)
+        {
+            auto& path = global::PATH_DATA;
+            const auto& staticGrid = path.mapsStaticGrids[map];
+            const auto& dynamicGrid = path.mapsDynamicGrids[map];
+            const int size = radius * 2 + 1;
+            const int cellCount = size * size;
+            field.x = goalX - radius;
+            field.y = goalY - radius;
+            field.size = size;
+            field.costs.resize(cellCount);
+            field.directions.resize(cellCount);
+            std::fill_n(field.costs.data(), cellCount, NO_COST);
+
+            FLOW_SOLID.resize(cellCount);
+            for (int i = 0; i < size; ++i)
+            {
+                const auto cellY = static_cast<float>((field.y + i) * MAGIQUE_PATHFINDING_CELL_SIZE);
+                for (int j = 0; j < size; ++j)
+                {
+                    const auto cellX = static_cast<float>((field.x + j) * MAGIQUE_PATHFINDING_CELL_SIZE);
+                    FLOW_SOLID[i * size + j] = PathFindingData::IsCellSolid(cellX, cellY, staticGrid, dynamicGrid);
+                }
+            }
+
+            // Integration field - Dijkstra from the goal
+            const int goal = field.getIndex(goalX, goalY);
+            FLOW_QUEUE.clear();
+            if (FLOW_SOLID[goal] == 0)
+            {
+                field.costs[goal] = 0;
+                FLOW_QUEUE.push({0, goal});
+            }
+            while (!FLOW_QUEUE.empty())
+            {
+                const auto [cost, idx] = FLOW_QUEUE.top();
+                FLOW_QUEUE.pop();
+                if (cost > field.costs[idx])
+                    continue;
+                const int x = idx % size;
+                const int y = idx / size;
+                for (const auto& dir : MOVEMENTS[(int)GridMode::STAR])
+                {
+                    const int nx = x + static_cast<int>(dir.x);
+                    const int ny = y + static_cast<int>(dir.y);
+                    if (nx < 0 || ny < 0 || nx >= size || ny >= size)
+                        continue;
+                    const int next = ny * size + nx;
+                    const float newCost = cost + MOVE_COST[(int)GridMode::STAR](dir);
+                    if (FLOW_SOLID[next] != 0 || newCost >= field.costs[next])
+                        continue;
+                    field.costs[next] = newCost;
+                    FLOW_QUEUE.push({newCost, next});
+                }
+            }
+
+            // Direction field - independent per cell so it's split into row ranges
+            if (cellCount < MIN_PARALLEL_FLOW_CELLS)
+            {
+                DeriveFlowDirections(&field, 0, size);
+            }
+            else
+            {
+                std::array<jobHandle, COL_WORK_PARTS> handles{};
+                const int partSize = size / COL_WORK_PARTS;
+                int end = 0;
+                for (int j = 0; j < COL_WORK_PARTS - 1; ++j)
+                {
+                    const int start = end;
+                    end = start + partSize;
+                    handles[j] = AddJob(CreateExplicitJob(DeriveFlowDirections, &field, start, end));
+                }
+                DeriveFlowDirections(&field, end, size);
+                AwaitJobs(handles);
+            }
+        }
+
+        const FlowField& GetFlowField(const MapID map, const int goalX, const int goalY, const int radius)
+        {
+            auto& path = global::PATH_DATA;
+            const auto tick = global::ENGINE_DATA.engineTicks;
+            const auto dynamicHash = GetDynamicGridHash(map);
+            const auto key = (static_cast<uint64_t>(map) << 32) | GetVisitedCell(goalX, goalY);
+
+            auto it = path.flowFields.find(key);
+            if (it == path.flowFields.end())
+            {
+                if (path.flowFields.size() >= MAX_FLOW_FIELDS)
+                {
+                    auto oldest = path.flowFields.begin();
+                    for (auto curr = path.flowFields.begin(); curr != path.flowFields.end(); ++curr)
+                    {
+                        if (curr->second.lastUsed < oldest->second.lastUsed)
+                            oldest = curr;
+                    }
+                    path.flowFields.erase(oldest);
+                }
+                it = path.flowFields.try_emplace(key).first;
+                it->second.size = 0; // Forces a build
+            }
+
+            auto& field = it->second;
+            field.lastUsed = tick;
+            if (field.size < radius * 2 + 1 || field.dynamicHash != dynamicHash ||
+                field.staticVersion != path.staticGridVersion)
+            {
+                BuildFlowField(field, map, goalX, goalY, radius);
+                field.dynamicHash = dynamicHash;
+                field.staticVersion = path.staticGridVersion;
+            }
+            return field;
+        }
+    } // namespace
+
+    Point GetFlowDirection(const Point position, const Point goal, const MapID map, const int radius)
+    {
+        constexpr float cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+        const int goalX = static_cast<int>(std::floor(goal.x / cellSize));
+        const int goalY = static_cast<int>(std::floor(goal.y / cellSize));
+        const int cellX = static_cast<int>(std::floor(position.x / cellSize));
+        const int cellY = static_cast<int>(std::floor(position.y / cellSize));
+        if (radius <= 0)
+        {
+            return {0, 0};
+        }
+
+        const auto& field = GetFlowField(map, goalX, goalY, radius);
+        if (!field.contains(cellX, cellY))
+        {
+            return {0, 0};
+        }
+        const auto direction = field.directions[field.getIndex(cellX, cellY)];
+        if (direction == FlowField::NO_DIRECTION)
+        {
+            return {0, 0};
+        }
+        Point dir = MOVEMENTS[(int)GridMode::STAR][direction];
+        return dir.normalize();
+    }
+
+    //----------------- PLANNER -----------------//
+
+    PathPlanner::PathPlanner(const GridMode mode) : id(global::PATH_DATA.nextPlannerID++), mode(mode) {}
+
+    PathPlanner::PathPlanner(PathPlanner&& other) noexcept : id(other.id), mode(other.mode) { other.id = -1; }
+
+    PathPlanner& PathPlanner::operator=(PathPlanner&& other) noexcept
+    {
+        if (this != &other)
+        {
+            global::PATH_DATA.planners.erase(id);
+            id = other.id;
+            mode = other.mode;
+            other.id = -1;
+        }
+        return *this;
+    }
+
+    PathPlanner::~PathPlanner() { global::PATH_DATA.planners.erase(id); }
+
+    bool PathPlanner::findPath(std::vector<Point>& pathVec, const Point start, const Point end, const MapID map,
+                               const int maxLen)
+    {
+        constexpr float cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+        auto& path = global::PATH_DATA;
+        if (id == -1)
+        {
+            LOG_WARNING("Used a moved-from PathPlanner");
+            pathVec.clear();
+            return false;
+        }
+
+        auto& search = path.planners[id];
+        const auto& staticGrid = path.mapsStaticGrids[map];
+        const auto& dynamicGrid = path.mapsDynamicGrids[map];
+        const uint64_t dynamicHash = GetDynamicGridHash(map);
+        const int startX = static_cast<int>(std::floor(start.x / cellSize));
+        const int startY = static_cast<int>(std::floor(start.y / cellSize));
+        const int endX = static_cast<int>(std::floor(end.x / cellSize));
+        const int endY = static_cast<int>(std::floor(end.y / cellSize));
+
+        if (search.isEmpty || search.map != map || search.mode != mode)
+        {
+            search.reset();
+            search.map = map;
+            search.mode = mode;
+        }
+        const bool gridChanged = search.staticVersion != path.staticGridVersion || search.dynamicHash != dynamicHash;
+        bool startMoved = search.isEmpty;
+        if (!startMoved)
+        {
+            const auto& root = search.nodes[search.root];
+            startMoved = root.x != startX || root.y != startY;
+        }
+        if (startMoved || gridChanged)
+        {
+            search.repair(startX, startY, gridChanged, staticGrid, dynamicGrid);
+            search.staticVersion = path.staticGridVersion;
+            search.dynamicHash = dynamicHash;
+        }
+
+        const bool found = search.findPath(pathVec, endX, endY, maxLen, staticGrid, dynamicGrid);
+        path.expandedNodes = search.expandedNodes;
+        return found;
+    }
+
+    void PathPlanner::reset() { global::PATH_DATA.planners.erase(id); }
+
+    //----------------- CACHE -----------------//
+
+    void SetPathCache(const bool enabled, const int capacity)
+    {
+        auto& cache = global::PATH_DATA.cachedPaths;
+        cache.clear();
+        cache.capacity = enabled ? std::max(capacity, 1) : 0;
+        cache.hits = 0;
+        cache.misses = 0;
+    }
+
+    //----------------- ASYNC -----------------//
+
+    void RequestPath(const Point start, const Point end, const MapID map, const PathCallback& callback, const int maxLen,
+                     const GridMode mode, const PathAlgorithm algorithm, const int agentSize)
+    {
+        if (!callback)
+        {
+            LOG_WARNING("Passed null callback to RequestPath()");
+            return;
+        }
+        auto& path = global::PATH_DATA;
+        path.requestLock.lock();
+        auto& request = path.pendingRequests.emplace_back();
+        request.callback = callback;
+        request.start = start;
+        request.end = end;
+        request.map = map;
+        request.maxLen = static_cast<uint16_t>(maxLen);
+        request.mode = mode;
+        request.algorithm = algorithm;
+        request.agentSize = static_cast<uint8_t>(std::clamp(agentSize, 1, ClearanceMap::MAX));
+        path.requestLock.unlock();
+    }
+
+    // Same as FindPath() but allows to specify the dimensions of the searching entity
+    // The pathfinding tries to find a path that fits the entity
+    // static void FindPathEx(std::vector<Point>& path, Point start, Point end, Point dimensions, int searchLen) {}
+
+    namespace
+    {
+        // Bresenham line through the cells - the first cell is skipped if specified
+        bool IsLineFree(const Point start, const Point end, const PathFindingGrid& staticGrid,
+                        const PathFindingGrid& dynamicGrid, const bool skipStart)
+        {
+            int x0 = static_cast<int>(start.x / MAGIQUE_PATHFINDING_CELL_SIZE);
+            int y0 = static_cast<int>(start.y / MAGIQUE_PATHFINDING_CELL_SIZE);
+            int const x1 = static_cast<int>(end.x / MAGIQUE_PATHFINDING_CELL_SIZE);
+            int const y1 = static_cast<int>(end.y / MAGIQUE_PATHFINDING_CELL_SIZE);
+
+            int const dx = std::abs(x1 - x0);
+            int const sx = x0 < x1 ? 1 : -1;
+            int const dy = -std::abs(y1 - y0);
+            int const sy = y0 < y1 ? 1 : -1;
+            int error = dx + dy;
+
+            bool isStart = true;
+            while (true)
+            {
+                const float x = static_cast<float>(x0) * MAGIQUE_PATHFINDING_CELL_SIZE;
+                const float y = static_cast<float>(y0) * MAGIQUE_PATHFINDING_CELL_SIZE;
+                // DrawRectangleRec({x, y, MAGIQUE_PATHFINDING_CELL_SIZE, MAGIQUE_PATHFINDING_CELL_SIZE}, PURPLE);
+                if ((!isStart || !skipStart) && PathFindingData::IsCellSolid(x, y, staticGrid, dynamicGrid))
+                {
+                    return false;
+                }
+                if (x0 == x1 && y0 == y1)
+                    break;
+                isStart = false;
+                int const e2 = 2 * error;
+                if (e2 >= dy)
+                {
+                    error = error + dy;
+                    x0 = x0 + sx;
+                }
+                if (e2 <= dx)
+                {
+                    error = error + dx;
+                    y0 = y0 + sy;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    bool GetPathRayCast(const Point start, const Point end, const MapID map)
+    {
+        auto& path = global::PATH_DATA;
+        const auto& staticGrid = path.mapsStaticGrids[map];
+        const auto& dynamicGrid = path.mapsDynamicGrids[map];
+        return IsLineFree(start, end, staticGrid, dynamicGrid, false);
+    }
+
+    void SmoothPath(std::vector<Point>& pathVec, const Point start, const MapID map)
+    {
+        auto& path = global::PATH_DATA;
+        if (pathVec.size() < 2)
+        {
+            return;
+        }
+        const auto& staticGrid = path.mapsStaticGrids[map];
+        const auto& dynamicGrid = path.mapsDynamicGrids[map];
+
+        // Walks the path from the start (back) - the kept points are written to the back as well
+        // The cell of the last kept point is always walkable - skipped so the entity itself doesn't block the ray
+        int write = static_cast<int>(pathVec.size());
+        int current = write - 1;
+        Point anchor = start;
+        while (current >= 0)
+        {
+            int farthest = current; // The next point on the path is always reachable
+            while (farthest > 0 && IsLineFree(anchor, pathVec[farthest - 1], staticGrid, dynamicGrid, true))
+            {
+                --farthest;
+            }
+            anchor = pathVec[farthest];
+            pathVec[--write] = anchor;
+            current = farthest - 1;
+        }
+        pathVec.erase(pathVec.begin(), pathVec.begin() + write);
+    }
+
     bool GetExistsPath(const Point start, const Point end, const MapID map, const int max, GridMode mode)
     {
         Point point;
@@ -0,0 +1,254 @@
+// SPDX-License-Identifier: zlib-acknowledgement
+#ifndef MAGIQUE_BAKED_HASH_GRID_H
+#define MAGIQUE_BAKED_HASH_GRID_H
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+//-----------------------------------------------
+// Baked Hash Grid
+//-----------------------------------------------
+// .....................................................................
+// Grid for mostly static content - the elements are baked into a compressed sparse row (CSR) layout:
+//      - cellKeys: sorted ids of all non-empty cells
+//      - offsets: start of each cell in the values - plus the end of the last cell
+//      - values: elements of all cells back to back
+// As the cell id is (cellX << 32 | cellY) all cells of a column are next to each other
+// -> a query needs a single binary search per column and then reads the values linearly
+//
+// Changes after baking go into a small delta layer:
+//      - inserts go into a regular block hash grid that is queried additionally
+//      - removals overwrite baked values with a tombstone that is skipped
+// Once the delta grows too big (needsBake()) everything is baked again
+// .....................................................................
+
+template <typename V, int blockSize, int cellSize>
+struct BakedHashGrid final
+{
+    static constexpr V TOMBSTONE = std::numeric_limits<V>::max();
+    static constexpr int MIN_DELTA = 64; // Delta changes that are always tolerated before a rebake
+
+    magique::vector<CellID> cellKeys;                       // Sorted keys of non-empty cells
+    magique::vector<uint32_t> offsets;                      // Start of each cell in values
+    magique::vector<V> values;                              // Elements of all cells
+    SingleResolutionHashGrid<V, blockSize, cellSize> delta; // Inserted since the last bake
+    int deltaChanges = 0;                                   // Inserts and removals since the last bake
+
+    void insert(V val, const float x, const float y, const float w, const float h)
+    {
+        delta.insert(val, x, y, w, h);
+        ++deltaChanges;
+    }
+
+    template <typename Container>
+    void query(Container& elems, const float x, const float y, const float w, const float h) const
+    {
+        if (!cellKeys.empty())
+        {
+            const int x1 = floordiv(FloorToInt(x), cellSize);
+            const int y1 = floordiv(FloorToInt(y), cellSize);
+            const int x2 = floordiv(FloorToInt(x + w), cellSize);
+            const int y2 = floordiv(FloorToInt(y + h), cellSize);
+            for (int cellX = x1; cellX <= x2; ++cellX)
+            {
+                // Negative y ids are bigger than positive ones - the column range has to be split at 0
+                if (y1 < 0 && y2 >= 0)
+                {
+                    queryColumn(elems, cellX, y1, -1);
+                    queryColumn(elems, cellX, 0, y2);
+                }
+                else
+                {
+                    queryColumn(elems, cellX, y1, y2);
+                }
+            }
+        }
+        if (deltaChanges > 0)
+        {
+            delta.query(elems, x, y, w, h);
+        }
+    }
+
+    void clear()
+    {
+        cellKeys.clear();
+        offsets.clear();
+        values.clear();
+        delta.clear();
+        deltaChanges = 0;
+    }
+
+    template <typename T, typename Pred>
+    void removeIfWithHoles(T val, Pred pred)
+    {
+        for (auto& value : values)
+        {
+            if (value != TOMBSTONE && pred(val, value))
+            {
+                value = TOMBSTONE;
+                ++deltaChanges;
+            }
+        }
+        delta.removeIfWithHoles(val, pred);
+    }
+
+    // Same as removeIfWithHoles() but only visits the cells of the rect the element was inserted with
+    template <typename T, typename Pred>
+    void removeIfWithHoles(T val, Pred pred, const float x, const float y, const float w, const float h)
+    {
+        if (!cellKeys.empty())
+        {
+            const int x1 = floordiv(FloorToInt(x), cellSize);
+            const int y1 = floordiv(FloorToInt(y), cellSize);
+            const int x2 = floordiv(FloorToInt(x + w), cellSize);
+            const int y2 = floordiv(FloorToInt(y + h), cellSize);
+            for (int cellX = x1; cellX <= x2; ++cellX)
+            {
+                if (y1 < 0 && y2 >= 0)
+                {
+                    removeColumn(val, pred, cellX, y1, -1);
+                    removeColumn(val, pred, cellX, 0, y2);
+                }
+                else
+                {
+                    removeColumn(val, pred, cellX, y1, y2);
+                }
+            }
+        }
+        if (deltaChanges > 0)
+        {
+            delta.removeIfWithHoles(val, pred, x, y, w, h);
+        }
+    }
+
+    // Baked values keep their tombstones until the next bake
+    void patchHoles() { delta.patchHoles(); }
+
+    // Returns true if the delta is big enough that baking again is worth it
+    [[nodiscard]] bool needsBake() const
+    {
+        return deltaChanges > std::max(MIN_DELTA, static_cast<int>(values.size()) / 8);
+    }
+
+    // Merges the delta into the baked layout and drops all tombstones
+    void bake()
+    {
+        if (deltaChanges == 0)
+        {
+            return;
+        }
+
+        magique::vector<BakeEntry> entries;
+        entries.reserve(values.size());
+        for (int i = 0; i < cellKeys.size(); ++i)
+        {
+            for (uint32_t j = offsets[i]; j < offsets[i + 1]; ++j)
+            {
+                if (values[j] != TOMBSTONE)
+                    entries.push_back({cellKeys[i], values[j]});
+            }
+        }
+        for (const auto& [key, blockIdx] : delta.cellMap)
+        {
+            const auto* block = &delta.dataBlocks[blockIdx];
+            while (true)
+            {
+                for (int j = 0; j < block->size; ++j)
+                    entries.push_back({key, block->data[j]});
+                if (!block->hasNext())
+                    break;
+                block = &delta.dataBlocks[block->next];
+            }
+        }
+        std::ranges::sort(entries, [](const BakeEntry& a, const BakeEntry& b) { return a.key < b.key; });
+
+        cellKeys.clear();
+        offsets.clear();
+        values.clear();
+        values.reserve(entries.size());
+        for (const auto& [key, value] : entries)
+        {
+            if (cellKeys.empty() || cellKeys.back() != key)
+            {
+                cellKeys.push_back(key);
+                offsets.push_back(static_cast<uint32_t>(values.size()));
+            }
+            values.push_back(value);
+        }
+        offsets.push_back(static_cast<uint32_t>(values.size()));
+        delta.clear();
+        deltaChanges = 0;
+    }
+
+    // Replaces the content with an already baked layout (e.g. from disk) - the given data doesn't need to be aligned
+    //      - offsetData: has keyCount + 1 entries
+    void assign(const char* keyData, const int keyCount, const char* offsetData, const char* valueData,
+                const int valueCount)
+    {
+        clear();
+        cellKeys.resize(keyCount);
+        offsets.resize(keyCount + 1);
+        values.resize(valueCount);
+        memcpy(cellKeys.data(), keyData, keyCount * sizeof(CellID));
+        memcpy(offsets.data(), offsetData, (keyCount + 1) * sizeof(uint32_t));
+        memcpy(values.data(), valueData, valueCount * sizeof(V));
+    }
+
+    // Returns the amount of used cells
+    [[nodiscard]] int getCellCount() const { return static_cast<int>(cellKeys.size()) + delta.getCellCount(); }
+
+    [[nodiscard]] constexpr int getCellSize() const { return cellSize; }
+
+private:
+    struct BakeEntry final
+    {
+        CellID key;
+        V value;
+    };
+
+    template <typename Container>
+    void queryColumn(Container& elems, const int cellX, const int y1, const int y2) const
+    {
+        const auto endKey = GetCellID(cellX, y2);
+        auto it = std::lower_bound(cellKeys.begin(), cellKeys.end(), GetCellID(cellX, y1));
+        for (; it != cellKeys.end() && *it <= endKey; ++it)
+        {
+            const auto idx = it - cellKeys.begin();
+            for (uint32_t j = offsets[idx]; j < offsets[idx + 1]; ++j)
+            {
+                const V value = values[j];
+                if (value == TOMBSTONE) [[unlikely]]
+                    continue;
+                if constexpr (requires { elems.push_back(value); })
+                    elems.push_back(value);
+                else // Not a vector but a set
+                    elems.insert(value);
+            }
+        }
+    }
+
+    template <typename T, typename Pred>
+    void removeColumn(T val, Pred pred, const int cellX, const int y1, const int y2)
+    {
+        const auto endKey = GetCellID(cellX, y2);
+        auto it = std::lower_bound(cellKeys.begin(), cellKeys.end(), GetCellID(cellX, y1));
+        for (; it != cellKeys.end() && *it <= endKey; ++it)
+        {
+            const auto idx = it - cellKeys.begin();
+            for (uint32_t j = offsets[idx]; j < offsets[idx + 1]; ++j)
+            {
+                auto& value = values[j];
+                if (value != TOMBSTONE && pred(val, value))
+                {
+                    value = TOMBSTONE;
+                    ++deltaChanges;
+                }
+            }
+        }
+    }
+
+    static_assert(std::is_trivially_constructible_v<V> && std::is_trivially_destructible_v<V>);
+};
+
+#endif //MAGIQUE_BAKED_HASH_GRID_H
@@ -17,6 +17,13 @@ namespace magique
 
     template <typename K>
     using HashSet = ankerl::unordered_dense::set<K>;
+
+    template <typename K>
+    struct AlignedSet final
+    {
+        // To prevent false sharing
+        alignas(64) HashSet<K> set;
+    };
 } // namespace magique
 
 #endif //MAGIQUE_HASHMAPTYPE_H
\ No newline at end of file
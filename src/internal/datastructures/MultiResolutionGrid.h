@@ -2,6 +2,9 @@
 #ifndef MULTI_RESOLUTION_GRID_H
 #define MULTI_RESOLUTION_GRID_H
 
+#include <cmath>
+#include <limits>
+
 // This is a cache friendly "top-level" data structure
 // https://stackoverflow.com/questions/41946007/efficient-and-well-explained-implementation-of-a-quadtree-for-2d-collision-det
 // Originally inspired by the above post to just move all the data of the structure to the top level
@@ -25,26 +28,49 @@ inline CellID GetCellID(const int cellX, const int cellY)
 // Integer casting converts values from -0.99 up to 0.99 to 0 meaning that essential cells left and right of the origin
 // map to the same cell
 // To solve this we truly floor all values, meaning we always convert them to the lower whole number
-// -0.99 -> -1
+// -0.99 -> -1 (with FloorToInt()) and exact multiples stay in their cell: -64 / 64 -> -1
 // The template is used to allow compiler optimization for power of two divisors
 template <int div>
 int floordiv(const int x)
 {
     const int res = x / div;
-    if (x < 0) [[unlikely]]
+    if (x < 0 && res * div != x) [[unlikely]]
     {
         return res - 1;
     }
     return res;
 }
 
-template <int cellSize, typename Func>
-static void RasterizeRect(Func func, const float x, const float y, const float w, const float h)
+// Runtime version for grids with a cell size chosen at runtime
+inline int floordiv(const int x, const int div)
+{
+    const int res = x / div;
+    if (x < 0 && res * div != x) [[unlikely]]
+    {
+        return res - 1;
+    }
+    return res;
+}
+
+// Floors the coordinate before it's divided - casting alone would truncate towards 0
+inline int FloorToInt(const float x) { return static_cast<int>(std::floor(x)); }
+
+// Compile time version forwarding to the optimized template
+template <int div>
+int floordiv(const int x, std::integral_constant<int, div> /**/)
+{
+    return floordiv<div>(x);
+}
+
+// CellSize is either an int (runtime) or a std::integral_constant (compile time)
+template <typename CellSize, typename Func>
+static void RasterizeRect(Func func, const float x, const float y, const float w, const float h,
+                          const CellSize cellSize)
 {
-    const int x1 = floordiv<cellSize>(static_cast<int>(x));
-    const int y1 = floordiv<cellSize>(static_cast<int>(y));
-    const int x2 = floordiv<cellSize>(static_cast<int>(x + w));
-    const int y2 = floordiv<cellSize>(static_cast<int>(y + h));
+    const int x1 = floordiv(FloorToInt(x), cellSize);
+    const int y1 = floordiv(FloorToInt(y), cellSize);
+    const int x2 = floordiv(FloorToInt(x + w), cellSize);
+    const int y2 = floordiv(FloorToInt(y + h), cellSize);
     const bool differentX = x1 != x2;
     const bool differentY = y1 != y2;
 
@@ -71,10 +97,11 @@ static void RasterizeRect(Func func, const float x, const float y, const float w
     }
 
     // 4 corners, the 4 middle points of the edges and the middle point -> 9 potential cells
-    if (w < cellSize * 3 && h < cellSize * 3) [[likely]]
+    // Only exact below 2 cells - a bigger rect can touch 4 cells on an axis
+    if (w < cellSize * 2 && h < cellSize * 2) [[likely]]
     {
-        const int xhalf = floordiv<cellSize>(static_cast<int>(x + (w / 2.0F)));
-        const int yhalf = floordiv<cellSize>(static_cast<int>(y + (h / 2.0F)));
+        const int xhalf = floordiv(FloorToInt(x + (w / 2.0F)), cellSize);
+        const int yhalf = floordiv(FloorToInt(y + (h / 2.0F)), cellSize);
 
         // Process the corners
         func(x1, y1); // Top-left
@@ -131,6 +158,12 @@ static void RasterizeRect(Func func, const float x, const float y, const float w
     }
 }
 
+template <int cellSize, typename Func>
+static void RasterizeRect(Func func, const float x, const float y, const float w, const float h)
+{
+    RasterizeRect(func, x, y, w, h, std::integral_constant<int, cellSize>{});
+}
+
 template <typename T, int capacity>
 struct DataBlock final
 {
@@ -210,77 +243,218 @@ struct DataBlock final
 };
 
 // assuming 4 bytes as value size its 15 * 4 + 2 + 2 = 64 / one cache line
+// A cell size of 0 means it's chosen at runtime with setCellSize() - must only be changed while empty
+// Optionally cells inside given bounds are looked up in a flat array (dense) instead of the cell map (hashed)
+// -> cells outside the bounds still fall back to the cell map
 template <typename V, int blockSize = 15, int cellSize = 64 /*power of two is optimized*/>
 struct SingleResolutionHashGrid final
 {
+    static constexpr bool RUNTIME_CELL_SIZE = cellSize == 0;
+
     magique::HashMap<CellID, int32_t> cellMap;
     magique::vector<DataBlock<V, blockSize>> dataBlocks{};
+    magique::vector<int32_t> denseCells{}; // Block index of each cell inside the dense bounds or -1
+    magique::vector<int32_t> denseUsed{};  // Indices of all used dense cells - to clear and iterate them quickly
+    int denseX = 0, denseY = 0;            // Top left of the dense bounds in cells
+    int denseWidth = 0, denseHeight = 0;   // Size of the dense bounds in cells - 0 if disabled
+    int runtimeCellSize = 64;              // Only used if RUNTIME_CELL_SIZE
 
     void insert(V val, const float x, const float y, const float w, const float h)
     {
-        const auto insertFunction = [this, val](const int cellX, const int cellY)
-        {
-            const auto cellID = GetCellID(cellX, cellY);
-            insertElement(cellID, val);
-        };
-        RasterizeRect<cellSize>(insertFunction, x, y, w, h);
+        const auto insertFunction = [this, val](const int cellX, const int cellY) { insertElement(cellX, cellY, val); };
+        RasterizeRect(insertFunction, x, y, w, h, getCellSizeArg());
     }
 
     template <typename Container>
     void query(Container& elems, const float x, const float y, const float w, const float h) const
     {
         const auto queryFunction = [this, &elems](const int cellX, const int cellY)
-        {
-            const auto cellID = GetCellID(cellX, cellY);
-            queryElements(cellID, elems);
-        };
-        RasterizeRect<cellSize>(queryFunction, x, y, w, h);
+        { queryElements(cellX, cellY, elems); };
+        RasterizeRect(queryFunction, x, y, w, h, getCellSizeArg());
     }
 
     void clear()
     {
         cellMap.clear();
         dataBlocks.clear();
+        for (const auto idx : denseUsed)
+        {
+            denseCells[idx] = -1;
+        }
+        denseUsed.clear();
     }
 
     // This is only efficient when no elements are inserted anymore until the next clear - Leaves holes
     void removeWithHoles(V val)
     {
-        for (const auto& pair : cellMap) // Iterate through map to only work on 'root' blocks
-        {
-            auto& block = dataBlocks[pair.second];
-            DataBlock<V, blockSize>* start = &block;
-            start->remove(val);
-            while (start->hasNext())
+        forEachRootBlock(
+            [&](const int blockIdx)
             {
-                start = &dataBlocks[start->next];
+                DataBlock<V, blockSize>* start = &dataBlocks[blockIdx];
                 start->remove(val);
-            }
-        }
+                while (start->hasNext())
+                {
+                    start = &dataBlocks[start->next];
+                    start->remove(val);
+                }
+            });
     }
 
     template <typename T, typename Pred>
     void removeIfWithHoles(T val, Pred pred)
     {
-        for (const auto& pair : cellMap) // Iterate through map to only work on 'root' blocks
+        forEachRootBlock(
+            [&](const int blockIdx)
+            {
+                DataBlock<V, blockSize>* start = &dataBlocks[blockIdx];
+                start->removeIf(val, pred);
+                while (start->hasNext())
+                {
+                    start = &dataBlocks[start->next];
+                    start->removeIf(val, pred);
+                }
+            });
+    }
+
+    // Same as removeIfWithHoles() but only visits the cells of the rect the element was inserted with
+    template <typename T, typename Pred>
+    void removeIfWithHoles(T val, Pred pred, const float x, const float y, const float w, const float h)
+    {
+        const auto removeFunction = [&](const int cellX, const int cellY)
         {
-            auto& block = dataBlocks[pair.second];
-            DataBlock<V, blockSize>* start = &block;
+            const int blockIdx = findCell(cellX, cellY);
+            if (blockIdx == -1)
+                return;
+            DataBlock<V, blockSize>* start = &dataBlocks[blockIdx];
             start->removeIf(val, pred);
             while (start->hasNext())
             {
                 start = &dataBlocks[start->next];
                 start->removeIf(val, pred);
             }
-        }
+        };
+        RasterizeRect(removeFunction, x, y, w, h, getCellSizeArg());
     }
 
     // Patches the blocks removing any holes
     void patchHoles()
     {
-        for (const auto& pair : cellMap) // Iterate through map to only work on 'root' blocks
+        forEachRootBlock([&](const int blockIdx) { patchBlockChain(dataBlocks[blockIdx]); });
+    }
+
+    // Sets the world bounds in which cells are looked up directly - bounds with no area disable it
+    // Returns false (and stays hashed) if the bounds would need more than maxCells cells
+    // Note: Must only be changed while empty - nothing happens if the bounds map to the same cells
+    bool setDenseBounds(const float x, const float y, const float w, const float h, const int maxCells)
+    {
+        int x1 = 0, y1 = 0, width = 0, height = 0;
+        if (w > 0 && h > 0)
+        {
+            x1 = floordiv(FloorToInt(x), getCellSizeArg());
+            y1 = floordiv(FloorToInt(y), getCellSizeArg());
+            width = floordiv(FloorToInt(x + w), getCellSizeArg()) - x1 + 1;
+            height = floordiv(FloorToInt(y + h), getCellSizeArg()) - y1 + 1;
+            if (static_cast<int64_t>(width) * height > maxCells)
+            {
+                width = 0;
+                height = 0;
+            }
+        }
+        if (x1 == denseX && y1 == denseY && width == denseWidth && height == denseHeight)
+        {
+            return width != 0;
+        }
+        assert(cellMap.empty() && denseUsed.empty() && "Grid has to be empty");
+        denseX = x1;
+        denseY = y1;
+        denseWidth = width;
+        denseHeight = height;
+        denseCells.clear();
+        denseCells.resize(width * height, -1);
+        return width != 0;
+    }
+
+    // Returns the block index of the given cell - -1 if it doesn't exist
+    [[nodiscard]] int findCell(const int cellX, const int cellY) const
+    {
+        const int denseIdx = getDenseIndex(cellX, cellY);
+        if (denseIdx != -1)
         {
-            patchBlockChain(dataBlocks[pair.second]);
+            return denseCells[denseIdx];
+        }
+        const auto it = cellMap.find(GetCellID(cellX, cellY));
+        return it == cellMap.end() ? -1 : it->second;
+    }
+
+    // Returns the amount of used cells
+    [[nodiscard]] int getCellCount() const { return static_cast<int>(cellMap.size() + denseUsed.size()); }
+
+    // Calls func(element) for all elements of the given cell - returns true if func returned true (stops early)
+    template <typename Func>
+    bool forEachInCell(const int cellX, const int cellY, Func func) const
+    {
+        const int blockIdx = findCell(cellX, cellY);
+        if (blockIdx == -1)
+        {
+            return false;
+        }
+        const DataBlock<V, blockSize>* block = &dataBlocks[blockIdx];
+        while (true)
+        {
+            for (int i = 0; i < block->size; ++i)
+            {
+                if (func(block->data[i]))
+                {
+                    return true;
+                }
+            }
+            if (!block->hasNext())
+            {
+                return false;
+            }
+            block = &dataBlocks[block->next];
+        }
+    }
+
+    // Walks the cells along the ray in order (DDA) until maxDist - the direction has to be normalized
+    // Calls func(cellX, cellY, distance) with the distance at which the ray enters the cell - stops if func returns true
+    template <typename Func>
+    void traverseRay(const float ox, const float oy, const float dirX, const float dirY, const float maxDist,
+                     Func func) const
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        const auto size = static_cast<float>(getCellSize());
+        int cellX = static_cast<int>(std::floor(ox / size));
+        int cellY = static_cast<int>(std::floor(oy / size));
+        const int stepX = dirX > 0 ? 1 : -1;
+        const int stepY = dirY > 0 ? 1 : -1;
+        const float deltaX = dirX != 0 ? std::abs(size / dirX) : inf;
+        const float deltaY = dirY != 0 ? std::abs(size / dirY) : inf;
+        const float cellLeft = static_cast<float>(cellX) * size;
+        const float cellTop = static_cast<float>(cellY) * size;
+        const float borderX = dirX > 0 ? cellLeft + size - ox : ox - cellLeft; // Distance to the next cell border
+        const float borderY = dirY > 0 ? cellTop + size - oy : oy - cellTop;
+        float nextX = dirX != 0 ? borderX / std::abs(dirX) : inf;
+        float nextY = dirY != 0 ? borderY / std::abs(dirY) : inf;
+        float dist = 0;
+        while (dist <= maxDist)
+        {
+            if (func(cellX, cellY, dist))
+            {
+                return;
+            }
+            if (nextX < nextY)
+            {
+                dist = nextX;
+                nextX += deltaX;
+                cellX += stepX;
+            }
+            else
+            {
+                dist = nextY;
+                nextY += deltaY;
+                cellY += stepY;
+            }
         }
     }
 
@@ -292,9 +466,55 @@ struct SingleResolutionHashGrid final
 
     [[nodiscard]] constexpr int getBlockSize() const { return blockSize; }
 
-    [[nodiscard]] constexpr int getCellSize() const { return cellSize; }
+    [[nodiscard]] int getCellSize() const { return RUNTIME_CELL_SIZE ? runtimeCellSize : cellSize; }
+
+    void setCellSize(const int size)
+    {
+        static_assert(RUNTIME_CELL_SIZE, "Cell size is fixed at compile time");
+        assert(size > 0 && getCellCount() == 0 && "Invalid size or grid not empty");
+        if (size != runtimeCellSize)
+        {
+            runtimeCellSize = size;
+            setDenseBounds(0, 0, 0, 0, 0); // Dense bounds depend on the cell size
+        }
+    }
 
 private:
+    // Returns the index into the dense cells or -1 if outside the dense bounds
+    [[nodiscard]] int getDenseIndex(const int cellX, const int cellY) const
+    {
+        const int x = cellX - denseX;
+        const int y = cellY - denseY;
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(denseWidth) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(denseHeight))
+        {
+            return -1;
+        }
+        return y * denseWidth + x;
+    }
+
+    // Calls the function with the block index of each cell (not the overflow blocks)
+    template <typename Func>
+    void forEachRootBlock(Func func)
+    {
+        for (const auto& pair : cellMap)
+        {
+            func(pair.second);
+        }
+        for (const auto idx : denseUsed)
+        {
+            func(denseCells[idx]);
+        }
+    }
+
+    [[nodiscard]] auto getCellSizeArg() const
+    {
+        if constexpr (RUNTIME_CELL_SIZE)
+            return runtimeCellSize;
+        else
+            return std::integral_constant<int, cellSize>{};
+    }
+
     void patchBlockChain(DataBlock<V, blockSize>& startBlock)
     {
         DataBlock<V, blockSize>* start = &startBlock;
@@ -326,19 +546,35 @@ private:
         }
     }
 
-    void insertElement(const CellID id, V val)
+    void insertElement(const int cellX, const int cellY, V val)
     {
-        const auto it = cellMap.find(id);
         int blockIdx;
-        if (it == cellMap.end()) [[unlikely]] // Most elements should be together
+        const int denseIdx = getDenseIndex(cellX, cellY);
+        if (denseIdx != -1) // Direct lookup
         {
-            blockIdx = static_cast<int>(dataBlocks.size());
-            cellMap.insert({id, blockIdx});
-            dataBlocks.push_back({});
+            blockIdx = denseCells[denseIdx];
+            if (blockIdx == -1) [[unlikely]]
+            {
+                blockIdx = static_cast<int>(dataBlocks.size());
+                denseCells[denseIdx] = blockIdx;
+                denseUsed.push_back(denseIdx);
+                dataBlocks.push_back({});
+            }
         }
         else
         {
-            blockIdx = it->second;
+            const auto id = GetCellID(cellX, cellY);
+            const auto it = cellMap.find(id);
+            if (it == cellMap.end()) [[unlikely]] // Most elements should be together
+            {
+                blockIdx = static_cast<int>(dataBlocks.size());
+                cellMap.insert({id, blockIdx});
+                dataBlocks.push_back({});
+            }
+            else
+            {
+                blockIdx = it->second;
+            }
         }
 
         auto* block = &dataBlocks[blockIdx];
@@ -362,14 +598,13 @@ private:
     }
 
     template <typename Container>
-    void queryElements(const CellID id, Container& elems) const
+    void queryElements(const int cellX, const int cellY, Container& elems) const
     {
-        const auto it = cellMap.find(id);
-        if (it == cellMap.end()) [[unlikely]] // Most elements should be together
+        const int blockIdx = findCell(cellX, cellY);
+        if (blockIdx == -1) [[unlikely]] // Most elements should be together
         {
             return;
         }
-        const int blockIdx = it->second;
         const DataBlock<V, blockSize>* startBlock = &dataBlocks[blockIdx];
 
         startBlock->append(elems);
@@ -386,6 +621,138 @@ private:
 };
 
 
+// Hierarchical grid made of 3 single resolution grids with cell sizes 1x, factor x and factor^2 x the base size
+// Each element is only inserted into the level that matches its size (bigger side fits into a cell of that level)
+// -> big elements are not rasterized into many small cells and small elements don't share cells with big ones
+// Queries test all levels - but coarser levels are only touched if they contain any elements
+// A cell size of 0 means the base cell size is chosen at runtime with setCellSize() - must only be changed while empty
+template <typename V, int blockSize = 15, int cellSize = 64 /*power of two is optimized*/, int factor = 4>
+struct MultiResolutionHashGrid final
+{
+    static constexpr int LEVELS = 3;
+    static constexpr bool RUNTIME_CELL_SIZE = cellSize == 0;
+    SingleResolutionHashGrid<V, blockSize, cellSize> level0;
+    SingleResolutionHashGrid<V, blockSize, cellSize * factor> level1;
+    SingleResolutionHashGrid<V, blockSize, cellSize * factor * factor> level2;
+    magique::vector<V> coarseElements; // Elements of level 1 and 2 - each only once
+
+    MultiResolutionHashGrid()
+    {
+        if constexpr (RUNTIME_CELL_SIZE)
+            setCellSize(64);
+    }
+
+    void insert(V val, const float x, const float y, const float w, const float h)
+    {
+        const float size = w > h ? w : h;
+        const auto base = static_cast<float>(getCellSize());
+        if (size <= base) [[likely]]
+        {
+            level0.insert(val, x, y, w, h);
+            return;
+        }
+        coarseElements.push_back(val);
+        if (size <= base * factor)
+        {
+            level1.insert(val, x, y, w, h);
+        }
+        else
+        {
+            level2.insert(val, x, y, w, h);
+        }
+    }
+
+    template <typename Container>
+    void query(Container& elems, const float x, const float y, const float w, const float h) const
+    {
+        level0.query(elems, x, y, w, h);
+        if (!coarseElements.empty()) [[unlikely]]
+        {
+            level1.query(elems, x, y, w, h);
+            level2.query(elems, x, y, w, h);
+        }
+    }
+
+    // Queries only the levels that are finer than the level an element with the given bounds is inserted into
+    // Together with the elements of the same cell this finds all overlaps of the coarse elements
+    template <typename Container>
+    void queryFiner(Container& elems, const float x, const float y, const float w, const float h) const
+    {
+        const float size = w > h ? w : h;
+        const auto base = static_cast<float>(getCellSize());
+        if (size <= base)
+        {
+            return;
+        }
+        level0.query(elems, x, y, w, h);
+        if (size > base * factor)
+        {
+            level1.query(elems, x, y, w, h);
+        }
+    }
+
+    // Calls the given function with each level
+    template <typename Func>
+    void forEachLevel(Func func) const
+    {
+        func(level0);
+        func(level1);
+        func(level2);
+    }
+
+    void clear()
+    {
+        level0.clear();
+        level1.clear();
+        level2.clear();
+        coarseElements.clear();
+    }
+
+    // This is only efficient when no elements are inserted anymore until the next clear - Leaves holes
+    void removeWithHoles(V val)
+    {
+        level0.removeWithHoles(val);
+        if (coarseElements.erase(val))
+        {
+            level1.removeWithHoles(val);
+            level2.removeWithHoles(val);
+        }
+    }
+
+    // Patches the blocks removing any holes
+    void patchHoles()
+    {
+        level0.patchHoles();
+        level1.patchHoles();
+        level2.patchHoles();
+    }
+
+    void reserve(const int cells, const int expectedTotalEntities)
+    {
+        level0.reserve(cells, expectedTotalEntities);
+    }
+
+    [[nodiscard]] constexpr int getBlockSize() const { return blockSize; }
+
+    // Returns the cell size of the base level
+    [[nodiscard]] int getCellSize() const { return level0.getCellSize(); }
+
+    void setCellSize(const int size)
+    {
+        level0.setCellSize(size);
+        level1.setCellSize(size * factor);
+        level2.setCellSize(size * factor * factor);
+    }
+
+    // Sets the dense bounds for all levels - see SingleResolutionHashGrid::setDenseBounds()
+    bool setDenseBounds(const float x, const float y, const float w, const float h, const int maxCells)
+    {
+        level1.setDenseBounds(x, y, w, h, maxCells);
+        level2.setDenseBounds(x, y, w, h, maxCells);
+        return level0.setDenseBounds(x, y, w, h, maxCells);
+    }
+};
+
 // Structure that holds the given type for each map separately efficiently
 // This is likely the best solution as it does not require annotating the data with the map or checks on each lookup
 // This is as space efficient as it gets and has constant overhead and reasonable cache efficiency
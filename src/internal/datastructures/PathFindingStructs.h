@@ -2,6 +2,7 @@
 #define PATHFINDINGSTRUCTS_H
 
 #include <bitset>
+#include <limits>
 
 namespace magique
 {
@@ -72,38 +73,115 @@ namespace magique
     // This means there are 16 * 16 normal grids inside the enlarged grid
     // By dividing the normalize coordinate inside the current enlarged grid cell (value between 0 - 512) by 32
     // We get the index at which it is stored inside the bitset (flattened array)
+    // For lookups the blocks are also paged: an array over the area of all blocks holds the index of each block
+    // -> a lookup inside the area is a direct array access instead of hashing - outside of it nothing is marked
+    // Once the blocks are spread over too big of an area only the hashmap is used (with a cache of the last block)
     template <int mainGridBaseSize, int subGridSize = 16> // Fits into cache line (key/value pair)
     struct DenseLookupGrid final
     {
+        using Block = std::bitset<subGridSize * subGridSize>;
+
         // Is constexpr and power of 2 to get optimized division and modulo
         constexpr static int mainGridSize = mainGridBaseSize * subGridSize;
+        constexpr static int MAX_PAGES = 128 * 128; // Area in blocks - 2048x2048 cells
+
+        // Only add blocks with setMarked() or addBlock() - otherwise the pages don't know about them
+        HashMap<VisitedCellID, Block> visited{};
 
-        HashMap<VisitedCellID, std::bitset<subGridSize * subGridSize>> visited{};
+        std::vector<int> pages; // Index into the blocks of the hashmap - -1 if none
+        int pagesX = 0, pagesY = 0, pagesWidth = 0, pagesHeight = 0; // Paged area in blocks
+        bool usePages = true; // False once the blocks were too spread out
 
         [[nodiscard]] bool getIsMarked(const float x, const float y) const
         {
-            // < -1 0 < 1
-            const int cellX = floordiv<mainGridSize>(static_cast<int>(x));
-            const int cellY = floordiv<mainGridSize>(static_cast<int>(y));
-            const auto pathCell = GetVisitedCell(cellX, cellY);
-            const auto it = visited.find(pathCell);
-            if (it != visited.end()) // Get the position within the subgrid
+            const Block* block = findBlock(x, y);
+            if (block != nullptr) // Get the position within the subgrid
             {
-                const int vCellX = std::abs(static_cast<int>(x)) % mainGridSize / mainGridBaseSize;
-                const int vCellY = std::abs(static_cast<int>(y)) % mainGridSize / mainGridBaseSize;
-                return it->second[vCellX + (vCellY * subGridSize)];
+                return (*block)[GetBlockIndex(x, y)];
             }
             return false;
         }
 
-        void setMarked(const float x, const float y)
+        void setMarked(const float x, const float y) { addBlock(GetBlock(x, y)).set(GetBlockIndex(x, y), true); }
+
+        // Keeps the (possibly empty) block
+        void setUnmarked(const float x, const float y)
+        {
+            const auto it = visited.find(GetBlock(x, y));
+            if (it != visited.end())
+            {
+                it->second.reset(GetBlockIndex(x, y));
+            }
+        }
+
+        // Returns the block with the given key - adds it if it doesn't exist
+        Block& addBlock(const VisitedCellID key)
+        {
+            const auto [it, inserted] = visited.try_emplace(key);
+            if (inserted && usePages) [[unlikely]]
+            {
+                addPage(key, static_cast<int>(visited.size()) - 1); // Always added at the end
+            }
+            return it->second;
+        }
+
+        // Returns the block that contains the coordinates - nullptr if none
+        [[nodiscard]] const Block* findBlock(const float x, const float y) const
+        {
+            // Wrapped the same as the keys
+            const int blockX = static_cast<int16_t>(floordiv<mainGridSize>(static_cast<int>(x)));
+            const int blockY = static_cast<int16_t>(floordiv<mainGridSize>(static_cast<int>(y)));
+            if (usePages) [[likely]]
+            {
+                const auto relX = static_cast<uint32_t>(blockX - pagesX);
+                const auto relY = static_cast<uint32_t>(blockY - pagesY);
+                if (relX >= static_cast<uint32_t>(pagesWidth) || relY >= static_cast<uint32_t>(pagesHeight))
+                {
+                    return nullptr;
+                }
+                const int index = pages[relY * pagesWidth + relX];
+                return index != -1 ? &visited.values()[index].second : nullptr;
+            }
+
+            // Neighbor lookups mostly hit the same block - checked by key so it can't be outdated
+            struct LastBlock final
+            {
+                const DenseLookupGrid* grid = nullptr;
+                VisitedCellID key = 0;
+                int index = 0;
+            };
+            thread_local LastBlock last;
+            const auto key = GetVisitedCell(blockX, blockY);
+            const auto& values = visited.values();
+            if (last.grid == this && last.key == key && last.index < static_cast<int>(values.size()) &&
+                values[last.index].first == key)
+            {
+                return &values[last.index].second;
+            }
+            const auto it = visited.find(key);
+            if (it == visited.end())
+            {
+                return nullptr;
+            }
+            last = {this, key, static_cast<int>(it - visited.begin())};
+            return &it->second;
+        }
+
+        // Returns the key of the enlarged cell (block) that contains the coordinates
+        [[nodiscard]] static VisitedCellID GetBlock(const float x, const float y)
         {
+            // < -1 0 < 1
             const int cellX = floordiv<mainGridSize>(static_cast<int>(x));
             const int cellY = floordiv<mainGridSize>(static_cast<int>(y));
+            return GetVisitedCell(cellX, cellY);
+        }
+
+        // Returns the index of the coordinates inside the bitset of their block
+        [[nodiscard]] static int GetBlockIndex(const float x, const float y)
+        {
             const int vCellX = std::abs(static_cast<int>(x)) % mainGridSize / mainGridBaseSize;
             const int vCellY = std::abs(static_cast<int>(y)) % mainGridSize / mainGridBaseSize;
-            const auto cell = GetVisitedCell(cellX, cellY);
-            visited[cell].set(vCellX + (vCellY * subGridSize), true);
+            return vCellX + (vCellY * subGridSize);
         }
 
         void insert(const float x, const float y, const float w, const float h)
@@ -113,16 +191,87 @@ namespace magique
             RasterizeRect<mainGridBaseSize>(insertFunc, x, y, w, h);
         }
 
-        void clear() { visited.clear(); }
+        // Keeps the paged area - e.g. the dynamic grid is cleared and filled each tick
+        void clear()
+        {
+            if (usePages)
+            {
+                for (const auto& [key, block] : visited)
+                    pages[getPage(key)] = -1;
+            }
+            visited.clear();
+        }
+
+    private:
+        // Returns -1 if outside the paged area
+        [[nodiscard]] int getPage(const VisitedCellID key) const
+        {
+            const int relX = static_cast<int16_t>(key >> 16) - pagesX;
+            const int relY = static_cast<int16_t>(key & 0xFFFF) - pagesY;
+            if (relX < 0 || relY < 0 || relX >= pagesWidth || relY >= pagesHeight)
+            {
+                return -1;
+            }
+            return relY * pagesWidth + relX;
+        }
+
+        void addPage(const VisitedCellID key, const int index)
+        {
+            const int page = getPage(key);
+            if (page != -1) [[likely]]
+            {
+                pages[page] = index;
+                return;
+            }
+
+            // Grows the area by a quarter of its size in each direction - then all blocks are paged again
+            const int blockX = static_cast<int16_t>(key >> 16);
+            const int blockY = static_cast<int16_t>(key & 0xFFFF);
+            const bool isEmpty = pagesWidth == 0;
+            int minX = isEmpty ? blockX : std::min(pagesX, blockX);
+            int minY = isEmpty ? blockY : std::min(pagesY, blockY);
+            int maxX = isEmpty ? blockX : std::max(pagesX + pagesWidth - 1, blockX);
+            int maxY = isEmpty ? blockY : std::max(pagesY + pagesHeight - 1, blockY);
+            const int marginX = std::max(4, (maxX - minX) / 4);
+            const int marginY = std::max(4, (maxY - minY) / 4);
+            minX -= marginX;
+            minY -= marginY;
+            maxX += marginX;
+            maxY += marginY;
+            if ((maxX - minX + 1) * (maxY - minY + 1) > MAX_PAGES)
+            {
+                usePages = false;
+                pages = {};
+                return;
+            }
+            pagesX = minX;
+            pagesY = minY;
+            pagesWidth = maxX - minX + 1;
+            pagesHeight = maxY - minY + 1;
+            pages.assign(pagesWidth * pagesHeight, -1);
+            const auto& values = visited.values();
+            for (int i = 0; i < static_cast<int>(values.size()); ++i)
+            {
+                pages[getPage(values[i].first)] = i;
+            }
+        }
     };
 
-    // Lookup grid that takes all given positions relative to its center
-    // This works good inside a single search - cleared between each search
+    // Lookup grid that takes all given positions relative to its center - holds the open cost and closed state
+    // Each cell is stamped with the search that wrote it - cells with an older stamp count as empty
+    // -> starting a new search is O(1) - the cells are only reset once the stamp wraps around
     // Allows very fast lookups without a hashmap
-    template <typename T, int size>
-    struct StaticDenseLookupGrid final
+    template <int size>
+    struct SearchLookupGrid final
     {
-        std::array<T, size> rows[size]{};
+        struct Cell final
+        {
+            uint32_t stamp;
+            float cost; // Negative if closed
+        };
+
+        Cell cells[size * size]{};
+        uint32_t stamp = 1; // Current search
         int midX;
         int midY;
 
@@ -132,30 +281,477 @@ namespace magique
             midY = static_cast<int>(mid.y);
         }
 
-        [[nodiscard]] T getValue(const float x, const float y) const
+        // Returns the lowest open cost of the cell - 0 if not opened
+        [[nodiscard]] float getCost(const float x, const float y) const
         {
-            const auto relX = static_cast<int>(x) - midX + size / 2;
-            const auto relY = static_cast<int>(y) - midY + size / 2;
-            if (relX >= 0 && relX < size && relY >= 0 && relY < size) [[likely]]
+            const int idx = getIndex(x, y);
+            if (idx != -1 && cells[idx].stamp == stamp) [[likely]]
             {
-                return rows[relY][relX];
+                return cells[idx].cost;
             }
             return 0;
         }
 
-        void setValue(const float x, const float y, const T& value)
+        [[nodiscard]] bool getIsClosed(const float x, const float y) const
+        {
+            const int idx = getIndex(x, y);
+            return idx != -1 && cells[idx].stamp == stamp && cells[idx].cost < 0;
+        }
+
+        void setCost(const float x, const float y, const float cost)
+        {
+            const int idx = getIndex(x, y);
+            if (idx != -1) [[likely]]
+            {
+                cells[idx] = {stamp, cost};
+            }
+        }
+
+        void setClosed(const float x, const float y) { setCost(x, y, -1.0F); }
+
+        void clear()
+        {
+            ++stamp;
+            if (stamp == 0) [[unlikely]]
+            {
+                memset(cells, 0, sizeof(cells));
+                stamp = 1;
+            }
+        }
+
+    private:
+        [[nodiscard]] int getIndex(const float x, const float y) const
         {
             const auto relX = static_cast<int>(x) - midX + size / 2;
             const auto relY = static_cast<int>(y) - midY + size / 2;
             if (relX >= 0 && relX < size && relY >= 0 && relY < size) [[likely]]
             {
-                rows[relY][relX] = value;
+                return relY * size + relX;
             }
+            return -1;
         }
+    };
+
+    // Costs of both directions of a bidirectional search - stamped per search like the SearchLookupGrid
+    template <int size>
+    struct BidirectionalLookupGrid final
+    {
+        struct Side final
+        {
+            float gCost;     // Lowest cost found - NOT_REACHED if not reached
+            uint16_t parent; // Node in the pool it was reached from
+            uint16_t stepCount;
+        };
+
+        struct Cell final
+        {
+            uint32_t stamp;
+            Side sides[2];
+            bool isClosed[2];
+        };
+
+        static constexpr float NOT_REACHED = std::numeric_limits<float>::max();
 
-        void clear() { memset(rows, 0, size * size * sizeof(T)); }
+        Cell cells[size * size]{};
+        uint32_t stamp = 1; // Current search
+        int midX;
+        int midY;
+
+        void setMid(const int x, const int y)
+        {
+            midX = x;
+            midY = y;
+        }
+
+        // Returns nullptr if the side didn't reach the cell
+        [[nodiscard]] const Side* get(const int side, const int x, const int y) const
+        {
+            const int idx = getIndex(x, y);
+            if (idx != -1 && cells[idx].stamp == stamp && cells[idx].sides[side].gCost != NOT_REACHED) [[likely]]
+            {
+                return &cells[idx].sides[side];
+            }
+            return nullptr;
+        }
+
+        [[nodiscard]] bool getIsClosed(const int side, const int x, const int y) const
+        {
+            const int idx = getIndex(x, y);
+            return idx != -1 && cells[idx].stamp == stamp && cells[idx].isClosed[side];
+        }
+
+        void set(const int side, const int x, const int y, const Side& value)
+        {
+            Cell* cell = touch(x, y);
+            if (cell != nullptr) [[likely]]
+            {
+                cell->sides[side] = value;
+            }
+        }
+
+        void setClosed(const int side, const int x, const int y)
+        {
+            Cell* cell = touch(x, y);
+            if (cell != nullptr) [[likely]]
+            {
+                cell->isClosed[side] = true;
+            }
+        }
+
+        void clear()
+        {
+            ++stamp;
+            if (stamp == 0) [[unlikely]]
+            {
+                memset(cells, 0, sizeof(cells));
+                stamp = 1;
+            }
+        }
+
+    private:
+        // Resets cells of older searches
+        Cell* touch(const int x, const int y)
+        {
+            const int idx = getIndex(x, y);
+            if (idx == -1) [[unlikely]]
+            {
+                return nullptr;
+            }
+            Cell& cell = cells[idx];
+            if (cell.stamp != stamp)
+            {
+                cell = {stamp, {{NOT_REACHED, UINT16_MAX, 0}, {NOT_REACHED, UINT16_MAX, 0}}, {false, false}};
+            }
+            return &cell;
+        }
+
+        [[nodiscard]] int getIndex(const int x, const int y) const
+        {
+            const int relX = x - midX + size / 2;
+            const int relY = y - midY + size / 2;
+            if (relX >= 0 && relX < size && relY >= 0 && relY < size) [[likely]]
+            {
+                return relY * size + relX;
+            }
+            return -1;
+        }
+    };
+
+    // Precomputed straight jump distances of the static grid inside the map bounds (JPS+)
+    // Each entry is the distance to the next jump point, to the last free cell before a wall or to the table edge
+    // Scans that reach the edge continue cell by cell from there (the grid outside the bounds is not known)
+    struct JumpTable final
+    {
+        static constexpr uint16_t JUMP_POINT = 0;
+        static constexpr uint16_t WALL = 1 << 14;
+        static constexpr uint16_t EDGE = 2 << 14;
+        static constexpr uint16_t KIND_MASK = 3 << 14;
+        static constexpr uint16_t DIST_MASK = (1 << 14) - 1;
+        static constexpr int MAX_CELLS = 1 << 21; // Bigger maps are searched without table
+        static constexpr int DIRECTIONS[4][2] = {{0, -1}, {1, 0}, {0, 1}, {-1, 0}}; // North, East, South, West
+
+        vector<uint16_t> entries; // 4 entries per cell
+        int x = 0;                // Covered cells
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        bool isDirty = true; // Static grid changed since the last build
+
+        [[nodiscard]] bool contains(const int cellX, const int cellY) const
+        {
+            return cellX >= x && cellY >= y && cellX < x + width && cellY < y + height;
+        }
+
+        [[nodiscard]] uint16_t get(const int cellX, const int cellY, const int dir) const
+        {
+            return entries[((cellY - y) * width + (cellX - x)) * 4 + dir];
+        }
+
+        static int GetDirection(const int dx, const int dy) { return dy != 0 ? (dy < 0 ? 0 : 2) : (dx > 0 ? 1 : 3); }
+    };
+
+    // Node of the cluster graph - a cell where the cluster can be entered or left
+    struct ClusterNode final
+    {
+        int x, y;      // Cell
+        int firstEdge; // Edges of the node in the cluster
+        int edgeCount;
     };
 
+    // Edge to a node of the same cluster (shortest path inside it) or to a node of a neighboring cluster
+    struct ClusterEdge final
+    {
+        int x, y; // Cell of the target node
+        float cost;
+    };
+
+    struct PathCluster final
+    {
+        vector<ClusterNode> nodes;
+        vector<ClusterEdge> edges;
+        bool isDirty = true; // Cells of the cluster or its neighbors changed since the last build
+
+        [[nodiscard]] int findNode(const int cellX, const int cellY) const
+        {
+            for (int i = 0; i < nodes.size(); ++i)
+            {
+                if (nodes[i].x == cellX && nodes[i].y == cellY)
+                    return i;
+            }
+            return -1;
+        }
+    };
+
+    // Abstract graph for hierarchical pathfinding (HPA*) - a cluster is a block of the pathfinding grid
+    // Clusters are built on demand and rebuilt when they are marked dirty - the nodes on a border depend on both sides
+    struct ClusterGraph final
+    {
+        static constexpr int SIZE = 16; // Cells per side - same as a block of the pathfinding grid
+
+        HashMap<VisitedCellID, PathCluster> clusters;
+        int minX = 0, minY = 0, maxX = -1, maxY = -1; // Cells inside the map bounds (inclusive)
+
+        // Marks the cluster and its neighbors dirty
+        void invalidate(const int clusterX, const int clusterY)
+        {
+            for (int i = -1; i <= 1; ++i)
+            {
+                for (int j = -1; j <= 1; ++j)
+                {
+                    const auto it = clusters.find(GetVisitedCell(clusterX + j, clusterY + i));
+                    if (it != clusters.end())
+                        it->second.isDirty = true;
+                }
+            }
+        }
+    };
+
+    // True clearance of the static grid - the size of the biggest free square with the cell as its top left corner
+    // Stored in blocks of 16x16 cells (same as the pathfinding grids) that are computed on demand
+    // A block only depends on the grid blocks right and below it -> changing a grid block only invalidates 4 blocks
+    struct ClearanceMap final
+    {
+        static constexpr int MAX = 16;   // Bigger clearance is clamped - also the biggest supported agent size
+        static constexpr int BLOCK = 16; // Cells per side
+
+        using Block = std::array<uint8_t, BLOCK * BLOCK>;
+        HashMap<VisitedCellID, Block> blocks;
+
+        template <typename Grid>
+        [[nodiscard]] uint8_t get(const int cellX, const int cellY, const Grid& grid)
+        {
+            const int blockX = floordiv(cellX, BLOCK);
+            const int blockY = floordiv(cellY, BLOCK);
+            const auto [it, inserted] = blocks.try_emplace(GetVisitedCell(blockX, blockY));
+            if (inserted)
+            {
+                build(it->second, blockX, blockY, grid);
+            }
+            return it->second[(cellY - blockY * BLOCK) * BLOCK + (cellX - blockX * BLOCK)];
+        }
+
+        // Removes the blocks that depend on the given grid block (itself and the ones left and above it)
+        void invalidate(const int blockX, const int blockY)
+        {
+            for (int i = -1; i <= 0; ++i)
+            {
+                for (int j = -1; j <= 0; ++j)
+                    blocks.erase(GetVisitedCell(blockX + j, blockY + i));
+            }
+        }
+
+    private:
+        // Dynamic programming from the bottom right over the block and the cells its squares can reach
+        // Cells outside the window count as solid - this only limits cells that are further than MAX from the block
+        template <typename Grid>
+        static void build(Block& block, const int blockX, const int blockY, const Grid& grid)
+        {
+            constexpr int window = BLOCK + MAX - 1;
+            constexpr int cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+            uint8_t clearance[window + 1][window + 1]{};
+
+            // Looked up once per grid block instead of once per cell
+            VisitedCellID lastKey = 0;
+            const std::bitset<BLOCK * BLOCK>* lastBits = nullptr;
+            bool hasLast = false;
+            const auto isSolid = [&](const float x, const float y)
+            {
+                const auto key = Grid::GetBlock(x, y);
+                if (!hasLast || key != lastKey)
+                {
+                    const auto it = grid.visited.find(key);
+                    lastBits = it != grid.visited.end() ? &it->second : nullptr;
+                    lastKey = key;
+                    hasLast = true;
+                }
+                return lastBits != nullptr && (*lastBits)[Grid::GetBlockIndex(x, y)];
+            };
+
+            for (int i = window - 1; i >= 0; --i)
+            {
+                const auto y = static_cast<float>((blockY * BLOCK + i) * cellSize);
+                for (int j = window - 1; j >= 0; --j)
+                {
+                    const auto x = static_cast<float>((blockX * BLOCK + j) * cellSize);
+                    if (isSolid(x, y))
+                        continue;
+                    const int smallest = std::min({clearance[i][j + 1], clearance[i + 1][j], clearance[i + 1][j + 1]});
+                    clearance[i][j] = static_cast<uint8_t>(std::min(smallest + 1, MAX));
+                }
+            }
+            for (int i = 0; i < BLOCK; ++i)
+            {
+                for (int j = 0; j < BLOCK; ++j)
+                    block[i * BLOCK + j] = clearance[i][j];
+            }
+        }
+    };
+
+    // Integration and direction field towards a single goal cell - shared by all entities with the same goal
+    struct FlowField final
+    {
+        static constexpr int8_t NO_DIRECTION = -1;
+
+        vector<float> costs;       // Cost to reach the goal from each cell (integration field)
+        vector<int8_t> directions; // Index into the STAR movements towards the next cell - NO_DIRECTION if none
+        int x = 0, y = 0;          // Top left cell
+        int size = 0;              // Cells per side
+        uint64_t dynamicHash = 0;  // Hash of the dynamic grid it was computed with
+        uint32_t staticVersion = 0;
+        uint32_t lastUsed = 0; // Tick it was last sampled in
+
+        [[nodiscard]] bool contains(const int cellX, const int cellY) const
+        {
+            return cellX >= x && cellY >= y && cellX < x + size && cellY < y + size;
+        }
+
+        [[nodiscard]] int getIndex(const int cellX, const int cellY) const { return (cellY - y) * size + (cellX - x); }
+    };
+
+    // Hash of a dynamic grid - computed at most once per tick as the grids are rebuilt each tick
+    struct DynamicGridHash final
+    {
+        uint32_t tick = UINT32_MAX;
+        uint64_t hash = 0;
+    };
+
+    // Settings a path was searched with - all cells (not positions)
+    struct PathCacheKey final
+    {
+        int startX, startY, endX, endY;
+        uint16_t maxLen;
+        MapID map;
+        GridMode mode;
+        PathAlgorithm algorithm;
+        uint8_t agentSize;
+
+        bool operator==(const PathCacheKey& other) const = default;
+
+        [[nodiscard]] uint64_t hash() const
+        {
+            const uint64_t data[3] = {
+                (static_cast<uint64_t>(static_cast<uint32_t>(startX)) << 32) | static_cast<uint32_t>(startY),
+                (static_cast<uint64_t>(static_cast<uint32_t>(endX)) << 32) | static_cast<uint32_t>(endY),
+                maxLen | (static_cast<uint64_t>(map) << 16) | (static_cast<uint64_t>(mode) << 24) |
+                    (static_cast<uint64_t>(algorithm) << 32) | (static_cast<uint64_t>(agentSize) << 40),
+            };
+            return ankerl::unordered_dense::detail::wyhash::hash(data, sizeof(data));
+        }
+    };
+
+    // Cells of a cached path inside a block of the pathfinding grids
+    struct PathCacheRegion final
+    {
+        VisitedCellID block;
+        std::bitset<16 * 16> cells; // Same layout as the blocks of DenseLookupGrid
+    };
+
+    struct CachedPath final
+    {
+        PathCacheKey key;
+        std::vector<Point> path;
+        vector<PathCacheRegion> regions; // Path is invalid once any of its cells is marked in the grids
+        int prev = -1;                   // Towards the most recently used
+        int next = -1;                   // Towards the least recently used
+    };
+
+    // Found paths with least recently used eviction - the entries are linked in order of their last use
+    struct PathCache final
+    {
+        std::vector<CachedPath> entries;
+        HashMap<uint64_t, int> lookup; // Key hash to entry
+        int capacity = 0;              // 0 if disabled
+        int head = -1;                 // Most recently used
+        int tail = -1;                 // Least recently used
+        uint32_t hits = 0;             // Since the last perf overlay update
+        uint32_t misses = 0;
+
+        // Returns the entry with the given key and marks it as used - nullptr if not cached
+        CachedPath* find(const PathCacheKey& key)
+        {
+            const auto it = lookup.find(key.hash());
+            if (it == lookup.end() || entries[it->second].key != key)
+                return nullptr;
+            moveToFront(it->second);
+            return &entries[it->second];
+        }
+
+        // Returns the entry for the key to (over)write - evicts the least recently used entry if full
+        CachedPath& insert(const PathCacheKey& key)
+        {
+            const auto hash = key.hash();
+            int idx;
+            if (const auto it = lookup.find(hash); it != lookup.end())
+            {
+                idx = it->second; // Same key or a hash collision - either way the old entry is replaced
+            }
+            else if (static_cast<int>(entries.size()) < capacity)
+            {
+                idx = static_cast<int>(entries.size());
+                entries.emplace_back();
+                lookup[hash] = idx;
+            }
+            else
+            {
+                idx = tail;
+                lookup.erase(entries[idx].key.hash());
+                lookup[hash] = idx;
+            }
+            auto& entry = entries[idx];
+            entry.key = key;
+            moveToFront(idx);
+            return entry;
+        }
+
+        void clear()
+        {
+            entries.clear();
+            lookup.clear();
+            head = -1;
+            tail = -1;
+        }
+
+    private:
+        void moveToFront(const int idx)
+        {
+            if (idx == head)
+                return;
+            auto& entry = entries[idx];
+            if (entry.prev != -1) // Unlink - new entries are not linked yet
+                entries[entry.prev].next = entry.next;
+            if (entry.next != -1)
+                entries[entry.next].prev = entry.prev;
+            if (idx == tail)
+                tail = entry.prev;
+            entry.prev = -1;
+            entry.next = head;
+            if (head != -1)
+                entries[head].prev = idx;
+            head = idx;
+            if (tail == -1)
+                tail = idx;
+        }
+    };
 
 } // namespace magique
 #endif //PATHFINDINGSTRUCTS_H
\ No newline at end of file
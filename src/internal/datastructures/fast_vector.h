@@ -160,7 +160,7 @@ fast_vector<T>& fast_vector<T>::operator=(const fast_vector& other) noexcept
 
         if constexpr (std::is_trivially_copyable_v<T>)
         {
-            mem(new_data, other.m_data, other.m_size * sizeof(T));
+            memcpy(new_data, other.m_data, other.m_size * sizeof(T));
         }
         else
         {
@@ -193,11 +193,22 @@ fast_vector<T>& fast_vector<T>::operator=(fast_vector&& other) noexcept
 {
     if (this != &other)
     {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (size_type i = 0; i < m_size; ++i)
+            {
+                m_data[i].~T();
+            }
+        }
+        free(m_data);
+
         m_data = other.m_data;
         m_size = other.m_size;
         m_capacity = other.m_capacity;
 
         other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
     }
     return *this;
 }
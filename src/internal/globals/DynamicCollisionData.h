@@ -19,16 +19,90 @@ namespace magique
 
     using CollPairCollector = AlignedVec<PairInfo>[MAGIQUE_WORKER_THREADS + 1];
     using EntityCollector = AlignedVec<entt::entity>[MAGIQUE_WORKER_THREADS + 1];
-    using EntityHashGrid =
-        SingleResolutionHashGrid<entt::entity, MAGIQUE_MAX_ENTITIES_CELL, MAGIQUE_COLLISION_CELL_SIZE>;
+    using EntityHashGrid = MultiResolutionHashGrid<entt::entity, MAGIQUE_MAX_ENTITIES_CELL, 0>; // Runtime cell size
+
+    // Samples entity sizes and cell occupancy of a map to pick the best base cell size
+    struct CellSizeTuner final
+    {
+        static constexpr int SAMPLE_TICKS = 300; // Ticks until a new cell size is chosen
+        double sizeSum = 0;                      // Sum of the bigger bounding box side of each entity
+        double occupancySum = 0;                 // Sum of the average elements per (base) cell of each tick
+        int entityCount = 0;
+        int ticks = 0;
+
+        void addTick(const EntityHashGrid& grid)
+        {
+            const auto& level = grid.level0;
+            if (level.getCellCount() != 0)
+            {
+                int elements = 0;
+                for (const auto& block : level.dataBlocks)
+                {
+                    elements += block.size;
+                }
+                occupancySum += static_cast<double>(elements) / level.getCellCount();
+            }
+            ticks++;
+        }
+
+        // Returns the best cell size once enough ticks are sampled - otherwise 0
+        // Cells about twice the average entity size - halved if the cells get too crowded
+        int evaluate()
+        {
+            if (ticks < SAMPLE_TICKS || entityCount == 0)
+            {
+                return 0;
+            }
+            const double avgSize = sizeSum / entityCount;
+            const double avgOccupancy = occupancySum / ticks;
+            int size = 8;
+            while (size < 512 && size < avgSize * 2.0)
+            {
+                size *= 2;
+            }
+            if (avgOccupancy > MAGIQUE_MAX_ENTITIES_CELL / 2.0 && size > 8)
+            {
+                size /= 2;
+            }
+            *this = {};
+            return size;
+        }
+    };
 
     struct DynamicCollisionData final
     {
+        static constexpr int MAX_DENSE_CELLS = 1 << 18; // Bounded maps up to 1MB of cells use a dense grid
+
         MapHolder<EntityHashGrid> mapEntityGrids{}; // Separate hashgrid for each map
         HashSet<uint64_t> pairSet;                  // Filters unique collision pairs
+        HashSet<uint64_t> contacts;                 // Colliding pairs of the last tick - for enter, stay and exit
         CollPairCollector collisionPairs{};         // Collision pair collectors
+        EntityCollector queryCollectors{};          // Query collectors for the coarse grid levels
+        HashMap<entt::entity, Point> sweepStarts;   // Start of tick positions of continuous entities
+        HashSet<entt::entity> sweepQuery;           // Query cache for the continuous sweep
+        uint16_t cellSizes[UINT8_MAX]{};            // Base cell size of the entity grid of each map
+        CellSizeTuner tuners[UINT8_MAX]{};          // Cell size auto tuner of each map
 
-        DynamicCollisionData() { pairSet.reserve(1000); }
+        // Parallel event dispatch
+        vector<PairInfo> parallelPairs;                // Pairs where all scripts are thread safe
+        vector<PairInfo> batchedPairs;                 // Parallel pairs sorted after their batch
+        vector<uint16_t> pairBatches;                  // Batch of each parallel pair
+        vector<int> batchOffsets;                      // Start of each batch in the batched pairs
+        HashMap<entt::entity, uint16_t> entityBatches; // Next batch an entity can be in
+
+        DynamicCollisionData()
+        {
+            pairSet.reserve(1000);
+            contacts.reserve(1000);
+            std::fill_n(cellSizes, UINT8_MAX, static_cast<uint16_t>(MAGIQUE_COLLISION_CELL_SIZE));
+        }
+
+        // Order independent key - smaller id first
+        static uint64_t GetPairKey(const entt::entity e1, const entt::entity e2)
+        {
+            const auto first = static_cast<uint64_t>(std::min(e1, e2));
+            return (first << 32) | static_cast<uint32_t>(std::max(e1, e2));
+        }
 
         bool isMarked(entt::entity e1, uint32_t e2)
         {
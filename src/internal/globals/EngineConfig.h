@@ -53,6 +53,8 @@ namespace magique
         bool showCompassOverlay = false;            // Status of the compass overlay
         bool showHitboxes = false;                  // Shows red outlines for the hitboxes
         bool enableCollisionSystem = true;          // Enables the static and dynamic collision systems
+        bool parallelCollisionEvents = false;       // Dispatches thread safe collision events across workers
+        bool autoTuneCellSize = false;              // Picks the entity grid cell size of each map automatically
         bool isClientMode = false;                  // Flag to disable certain engine tasks on multiplayer clients
 
         void init()
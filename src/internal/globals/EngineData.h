@@ -37,6 +37,20 @@ namespace magique
         }
     };
 
+    struct SpatialQueryData final
+    {
+        std::vector<RaycastHit> hits;                       // Result of the last raycast
+        std::vector<entt::entity> entities;                 // Result of the last circle or nearest query
+        std::vector<std::pair<float, entt::entity>> sorted; // Candidates with their distance
+        HashSet<entt::entity> visited;                      // Filters duplicates - entities can be in multiple cells
+
+        // Batch queries - each part has its own buffers to prevent false sharing
+        static constexpr int MIN_PARALLEL_QUERIES = 32; // Smaller batches run only on the main thread
+        AlignedVec<entt::entity> partEntities[COL_WORK_PARTS];
+        AlignedVec<int> partCounts[COL_WORK_PARTS];
+        AlignedSet<entt::entity> partVisited[COL_WORK_PARTS];
+    };
+
     struct CameraShakeData final
     {
         Point direction;
@@ -63,6 +77,7 @@ namespace magique
         GameState gameState{INT32_MAX};              // Global gamestate
         MapID cameraMap = MapID(UINT8_MAX);          // Map the camera is in
         NearbyQueryData nearbyQueryData;             // Caches the parameters of the last query to skip similar calls
+        SpatialQueryData spatialQueryData;           // Result buffers of the raycast, circle and nearest queries
         entt::entity playerEntity = entt::null;      // Manually set player entity
         float engineTime = 0.0F;                     // Time since engine start
         uint32_t engineTicks = 0;                    // Ticks since engine start
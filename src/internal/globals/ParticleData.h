@@ -2,23 +2,326 @@
 #ifndef MAGIQUE_PARTICLEDATA_H
 #define MAGIQUE_PARTICLEDATA_H
 
+#include <algorithm>
 #include <functional>
+#include <thread>
+#include <tuple>
 #include <raylib/rlgl.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include <magique/core/Particles.h>
+#include <magique/util/JobSystem.h>
 #include <magique/util/Logging.h>
 
 #include "external/raylib-compat/rshapes_compat.h"
 #include "internal/datastructures/VectorType.h"
+#include "internal/globals/JobScheduler.h"
 #include "magique/util/Math.h"
 
+//-----------------------------------------------
+// Particle Data
+//-----------------------------------------------
+// .....................................................................
+// Particles are stored as structure of arrays - each field is its own contiguous stream
+// This way the integration step only touches the streams it needs and is done with up to AVX2 intrinsics
+// Gravity is copied from the emitter on creation - the functions are looked up through the emitter pointer
+// Angular particles need their emission center and a square root each tick - they stay as whole particles
+// .....................................................................
+
 namespace magique
 {
+    struct ParticleStreams final
+    {
+        vector<float> x, y;                   // Position
+        vector<float> vx, vy;                 // Velocity
+        vector<float> gx, gy;                 // Gravity - pixel/tick
+        vector<float> scale;                  // Current scale
+        vector<uint16_t> age;                 // Current age
+        vector<uint16_t> lifeTime;            // Lifetime
+        vector<Color> color;                  // Current color
+        vector<int16_t> width, height;        // Base dimensions
+        vector<const ScreenEmitter*> emitter; // Function pointers are shared across all instances
+
+        [[nodiscard]] int size() const { return x.size(); }
+
+        // Returns all streams - to do the same for each of them
+        auto streams() { return std::tie(x, y, vx, vy, gx, gy, scale, age, lifeTime, color, width, height, emitter); }
+
+        void add(const ScreenParticle& p)
+        {
+            const auto& data = p.emitter->getData();
+            x.push_back(p.pos.x);
+            y.push_back(p.pos.y);
+            vx.push_back(p.vx);
+            vy.push_back(p.vy);
+            gx.push_back(data.gravX);
+            gy.push_back(data.gravY);
+            scale.push_back(p.scale);
+            age.push_back(p.age);
+            lifeTime.push_back(p.lifeTime);
+            color.push_back(p.getColor());
+            width.push_back(p.p1);
+            height.push_back(p.p2);
+            emitter.push_back(p.emitter);
+        }
+
+        // Gathers the particle at the given index - only needed for the tick function
+        [[nodiscard]] ScreenParticle get(const int i) const
+        {
+            ScreenParticle p{};
+            p.emitter = emitter[i];
+            p.pos = {x[i], y[i]};
+            p.p1 = width[i];
+            p.p2 = height[i];
+            p.vx = vx[i];
+            p.vy = vy[i];
+            p.scale = scale[i];
+            p.age = age[i];
+            p.lifeTime = lifeTime[i];
+            p.shape = Shape::RECT;
+            p.setColor(color[i]);
+            return p;
+        }
+
+        void set(const int i, const ScreenParticle& p)
+        {
+            x[i] = p.pos.x;
+            y[i] = p.pos.y;
+            width[i] = p.p1;
+            height[i] = p.p2;
+            vx[i] = p.vx;
+            vy[i] = p.vy;
+            scale[i] = p.scale;
+            age[i] = p.age;
+            lifeTime[i] = p.lifeTime;
+            color[i] = p.getColor();
+        }
+
+        // Removes the particles in [start, end) that reached their lifetime - the order is not kept
+        // The holes are filled with the last particles of the range
+        // Returns: the new end of the range
+        int removeDead(const int start, const int end)
+        {
+            [[maybe_unused]] const uint16_t* ages = age.data();
+            [[maybe_unused]] const uint16_t* lifeTimes = lifeTime.data();
+            int liveEnd = end;
+            int i = end;
+            // Goes backwards so the particle swapped in from the back was already checked
+#if defined(__AVX2__)
+            const __m256i zero = _mm256_setzero_si256();
+            for (; i - 16 >= start; i -= 16)
+            {
+                const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ages + i - 16));
+                const __m256i l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lifeTimes + i - 16));
+                const __m256i left = _mm256_subs_epu16(l, a); // 0 if age >= lifetime
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi16(left, zero)) != 0) [[unlikely]]
+                    liveEnd = removeDeadRange(i - 16, i, liveEnd);
+            }
+#elif defined(__SSE2__)
+            const __m128i zero = _mm_setzero_si128();
+            for (; i - 8 >= start; i -= 8)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ages + i - 8));
+                const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lifeTimes + i - 8));
+                const __m128i left = _mm_subs_epu16(l, a); // 0 if age >= lifetime
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(left, zero)) != 0) [[unlikely]]
+                    liveEnd = removeDeadRange(i - 8, i, liveEnd);
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            for (; i - 8 >= start; i -= 8)
+            {
+                const uint16x8_t left = vqsubq_u16(vld1q_u16(lifeTimes + i - 8), vld1q_u16(ages + i - 8));
+                if (vminvq_u16(left) == 0) [[unlikely]]
+                    liveEnd = removeDeadRange(i - 8, i, liveEnd);
+            }
+#endif
+            return removeDeadRange(start, i, liveEnd);
+        }
+
+        // Advances the particles in [start, end) by one tick - position, velocity and age
+        void integrate(const int start, const int end)
+        {
+            float* px = x.data();
+            float* py = y.data();
+            float* pvx = vx.data();
+            float* pvy = vy.data();
+            const float* pgx = gx.data();
+            const float* pgy = gy.data();
+            uint16_t* ages = age.data();
+
+            int i = start;
+#if defined(__AVX2__)
+            for (; i + 8 <= end; i += 8)
+            {
+                const __m256 velX = _mm256_loadu_ps(pvx + i);
+                const __m256 velY = _mm256_loadu_ps(pvy + i);
+                _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), velX));
+                _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), velY));
+                _mm256_storeu_ps(pvx + i, _mm256_add_ps(velX, _mm256_loadu_ps(pgx + i)));
+                _mm256_storeu_ps(pvy + i, _mm256_add_ps(velY, _mm256_loadu_ps(pgy + i)));
+            }
+#elif defined(__SSE2__)
+            for (; i + 4 <= end; i += 4)
+            {
+                const __m128 velX = _mm_loadu_ps(pvx + i);
+                const __m128 velY = _mm_loadu_ps(pvy + i);
+                _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), velX));
+                _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), velY));
+                _mm_storeu_ps(pvx + i, _mm_add_ps(velX, _mm_loadu_ps(pgx + i)));
+                _mm_storeu_ps(pvy + i, _mm_add_ps(velY, _mm_loadu_ps(pgy + i)));
+            }
+#elif defined(__ARM_NEON)
+            for (; i + 4 <= end; i += 4)
+            {
+                const float32x4_t velX = vld1q_f32(pvx + i);
+                const float32x4_t velY = vld1q_f32(pvy + i);
+                vst1q_f32(px + i, vaddq_f32(vld1q_f32(px + i), velX));
+                vst1q_f32(py + i, vaddq_f32(vld1q_f32(py + i), velY));
+                vst1q_f32(pvx + i, vaddq_f32(velX, vld1q_f32(pgx + i)));
+                vst1q_f32(pvy + i, vaddq_f32(velY, vld1q_f32(pgy + i)));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                px[i] += pvx[i];
+                py[i] += pvy[i];
+                pvx[i] += pgx[i]; // already changed from pixel/s into pixel/tick
+                pvy[i] += pgy[i];
+            }
+
+            i = start;
+#if defined(__AVX2__)
+            const __m256i one16 = _mm256_set1_epi16(1);
+            for (; i + 16 <= end; i += 16)
+            {
+                auto* ptr = reinterpret_cast<__m256i*>(ages + i);
+                _mm256_storeu_si256(ptr, _mm256_add_epi16(_mm256_loadu_si256(ptr), one16));
+            }
+#elif defined(__SSE2__)
+            const __m128i one8 = _mm_set1_epi16(1);
+            for (; i + 8 <= end; i += 8)
+            {
+                auto* ptr = reinterpret_cast<__m128i*>(ages + i);
+                _mm_storeu_si128(ptr, _mm_add_epi16(_mm_loadu_si128(ptr), one8));
+            }
+#elif defined(__ARM_NEON)
+            const uint16x8_t one8 = vdupq_n_u16(1);
+            for (; i + 8 <= end; i += 8)
+            {
+                vst1q_u16(ages + i, vaddq_u16(vld1q_u16(ages + i), one8));
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                ++ages[i];
+            }
+        }
+
+        // Calls the scale and color functions of the particles in [start, end) - safe to call from workers
+        // Returns: true if any of the particles has a tick function
+        bool callFunctions(const int start, const int end)
+        {
+            const ScreenEmitter* last = nullptr;
+            const internal::EmitterData* data = nullptr;
+            bool hasTickFunction = false;
+            for (int i = start; i < end; ++i)
+            {
+                // Particles of an emitter are created together - only look it up when it changes
+                if (emitter[i] != last) [[unlikely]]
+                {
+                    last = emitter[i];
+                    const auto& emData = last->getData();
+                    hasTickFunction |= emData.tickFunc != nullptr;
+                    data = emData.scaleFunc || emData.colorFunc ? &emData : nullptr;
+                }
+                if (data == nullptr) [[likely]]
+                    continue;
+
+                // Same as before the age was increased
+                const float relTime = static_cast<float>(age[i] - 1) / static_cast<float>(lifeTime[i]);
+                if (data->scaleFunc != nullptr)
+                {
+                    scale[i] = data->scaleFunc(scale[i], relTime);
+                }
+
+                if (data->colorFunc != nullptr)
+                {
+                    color[i] = data->colorFunc(color[i], relTime);
+                }
+            }
+            return hasTickFunction;
+        }
+
+        // Calls the tick functions of the first n particles - only on the main thread
+        void callTickFunctions(const int n)
+        {
+            const ScreenEmitter* last = nullptr;
+            const void* tickFunc = nullptr;
+            for (int i = 0; i < n; ++i)
+            {
+                if (emitter[i] != last) [[unlikely]]
+                {
+                    last = emitter[i];
+                    tickFunc = last->getData().tickFunc;
+                }
+                if (tickFunc == nullptr) [[likely]]
+                    continue;
+
+                // Can create new particles - streams might be reallocated
+                const float relTime = static_cast<float>(age[i] - 1) / static_cast<float>(lifeTime[i]);
+                auto p = get(i);
+                (*static_cast<const EmitterBase::TickFunction*>(tickFunc))(p, relTime);
+                set(i, p);
+            }
+        }
+
+        // Copies count particles starting at from to the given index - the ranges must not overlap
+        void move(const int from, const int to, const int count)
+        {
+            const auto copy = [from, to, count](auto&... stream)
+            { (std::copy_n(stream.data() + from, count, stream.data() + to), ...); };
+            std::apply(copy, streams());
+        }
+
+        // Shrinks all streams to the given size
+        void shrink(const int newSize)
+        {
+            std::apply([newSize](auto&... stream) { (stream.set_size(newSize), ...); }, streams());
+        }
+
+    private:
+        // Removes the dead particles in [start, end) - everything in [end, liveEnd) has to be alive
+        // Returns: the new live end
+        int removeDeadRange(const int start, const int end, int liveEnd)
+        {
+            for (int i = end - 1; i >= start; --i)
+            {
+                if (age[i] >= lifeTime[i])
+                {
+                    --liveEnd;
+                    std::apply([i, liveEnd](auto&... stream) { ((stream[i] = stream[liveEnd]), ...); }, streams());
+                }
+            }
+            return liveEnd;
+        }
+    };
+
     // Data driven
     struct ParticleData final
     {
-        vector<ScreenParticle> rectangles;
-        vector<ScreenParticle> circles;
+        static constexpr int MAX_PARTS = MAGIQUE_WORKER_THREADS + 1; // Main thread also updates a part
+        static constexpr int MIN_PART_SIZE = 25'000;                 // Smaller parts are not worth a job
+
+        ParticleStreams rectangles;
+        vector<ScreenParticle> angular;
+        vector<ScreenParticle> pending; // Created while the workers update the streams
         float scale = 1.0F;
 
         void addParticle(const ScreenParticle& sp)
@@ -26,7 +329,12 @@ namespace magique
             switch (sp.shape)
             {
             case Shape::RECT:
-                rectangles.push_back(sp);
+                if (parts > 0) [[unlikely]]
+                    pending.push_back(sp);
+                else if (sp.angular) [[unlikely]]
+                    angular.push_back(sp);
+                else
+                    rectangles.add(sp);
                 break;
             case Shape::CIRCLE:
                 LOG_FATAL("Method not implemented");
@@ -56,7 +364,22 @@ namespace magique
             rlTexCoord2f((shapeRect.x + shapeRect.width) / texShapes.width, shapeRect.y / texShapes.height);
 
             rlBegin(RL_QUADS);
-            for (const auto& p : rectangles)
+            const auto& rects = rectangles;
+            for (int i = 0; i < rects.size(); ++i)
+            {
+                const auto& c = rects.color[i];
+                const float x = rects.x[i];
+                const float y = rects.y[i];
+                const float w = rects.width[i] * rects.scale[i];
+                const float h = rects.height[i] * rects.scale[i];
+                rlColor4ub(c.r, c.g, c.b, c.a);
+                rlVertex2f(x, y);
+                rlVertex2f(x, y + h);
+                rlVertex2f(x + w, y + h);
+                rlVertex2f(x + w, y);
+            }
+
+            for (const auto& p : angular)
             {
                 rlColor4ub(p.r, p.g, p.b, p.a);
                 rlVertex2f(p.pos.x, p.pos.y);
@@ -69,64 +392,179 @@ namespace magique
             rlSetTexture(0);
         }
 
-        void update()
+        // Parts that can be updated at all - the main thread and each live worker
+        static int getLiveParts()
+        {
+            return std::min(MAX_PARTS, static_cast<int>(global::SCHEDULER.threads.size()) + 1);
+        }
+
+        // Parts that actually run at the same time - more parts than cores only wait on each other
+        static int getUsableParts()
+        {
+            static const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            return std::min(cores, getLiveParts());
+        }
+
+        // Splits the particles into parts and hands all but the last one to the workers
+        // Everything until finishUpdate() runs concurrently with the particle update
+        void startUpdate(const int maxParts = getUsableParts())
+        {
+            const int size = rectangles.size();
+            parts = std::clamp(size / MIN_PART_SIZE, 1, std::min(maxParts, getLiveParts()));
+            const int partSize = size / parts;
+            for (int j = 0; j < parts; ++j)
+            {
+                partStarts[j] = j * partSize;
+            }
+            partStarts[parts] = size;
+
+            handles.fill(jobHandle::null);
+            for (int j = 0; j < parts - 1; ++j)
+            {
+                const auto updatePart = [](ParticleData* data, const int part) { data->updatePart(part); };
+                handles[j] = AddJob(CreateExplicitJob(updatePart, this, j));
+            }
+        }
+
+        // Updates the last part on the main thread, waits for the workers and stitches the parts together
+        void finishUpdate()
+        {
+            updatePart(parts - 1);
+            if (parts > 1)
+            {
+                AwaitJobs(handles);
+            }
+            stitchParts();
+
+            bool hasTickFunction = false;
+            for (int j = 0; j < parts; ++j)
+            {
+                hasTickFunction |= partTickFunctions[j];
+            }
+            parts = 0; // Particles are added directly again
+
+            if (hasTickFunction) [[unlikely]]
+            {
+                // Particles created by tick functions start next tick
+                rectangles.callTickFunctions(rectangles.size());
+            }
+
+            for (const auto& p : pending)
+            {
+                addParticle(p);
+            }
+            pending.clear();
+            updateAngular();
+        }
+
+        void update(const int maxParts = getUsableParts())
+        {
+            startUpdate(maxParts);
+            finishUpdate();
+        }
+
+        // Parts of the current update - 0 if not updating
+        [[nodiscard]] int getParts() const { return parts; }
+
+    private:
+        std::array<jobHandle, MAX_PARTS> handles{};
+        std::array<int, MAX_PARTS + 1> partStarts{};
+        std::array<int, MAX_PARTS> partEnds{};          // End of the alive particles of each part after updating
+        std::array<bool, MAX_PARTS> partTickFunctions{}; // If a part has particles with a tick function
+        int parts = 0;                                   // Parts of the current update - 0 if not updating
+
+        // Compacts the part (removes dead particles) and moves the rest - can be called from any thread
+        void updatePart(const int part)
+        {
+            const int start = partStarts[part];
+            const int end = rectangles.removeDead(start, partStarts[part + 1]);
+            rectangles.integrate(start, end);
+            partTickFunctions[part] = rectangles.callFunctions(start, end);
+            partEnds[part] = end;
+        }
+
+        // Fills the holes at the end of each part with the particles of the last parts
+        // Only moves as many particles as died
+        void stitchParts()
         {
-            const auto updateVec = [](vector<ScreenParticle>& vec)
+            int alive = 0;
+            for (int j = 0; j < parts; ++j)
             {
-                for (int i = 0; i < vec.size(); ++i)
+                alive += partEnds[j] - partStarts[j];
+            }
+
+            int hole = 0; // Part whose hole is filled
+            int holeStart = partEnds[0];
+            int source = parts - 1; // Part the particles are taken from
+            int sourceEnd = partEnds[source];
+            while (true)
+            {
+                while (hole < source && holeStart == partStarts[hole + 1])
                 {
-                    auto& p = vec[i];
-                    const float relTime = static_cast<float>(p.age) / static_cast<float>(p.lifeTime);
-                    if (relTime >= 1.0F) [[unlikely]]
-                    {
-                        vec[i] = vec.back();
-                        vec.pop_back();
-                    }
-                    else
-                    {
-                        const auto& emitter = p.emitter->data;
-                        ++p.age;
-
-                        if (p.angular) [[unlikely]]
-                        {
-                            auto diff = Point{p.pos.x, p.pos.y} - p.emissionCenter;
-                            const float radius = diff.magnitude();
-
-                            auto radialDir = diff / radius;
-                            const auto tangentDir = radialDir.perpendicular(true);
-
-                            p.pos.x += radialDir.x * -p.vy + tangentDir.x * p.vx;
-                            p.pos.y += radialDir.y * -p.vy + tangentDir.y * p.vx;
-
-                            p.vy += p.emitter->data.angularGravity;
-                        }
-                        else
-                        {
-                            p.pos.x += p.vx;
-                            p.pos.y += p.vy;
-                            p.vx += emitter.gravX; // already changed from pixel/s into pixel/tick
-                            p.vy += emitter.gravY;
-                        }
-
-                        if (emitter.scaleFunc != nullptr)
-                        {
-                            p.scale = emitter.scaleFunc(p.scale, relTime);
-                        }
-
-                        if (emitter.colorFunc != nullptr)
-                        {
-                            p.setColor(emitter.colorFunc(p.getColor(), relTime));
-                        }
-
-                        if (emitter.tickFunc != nullptr)
-                        {
-                            (*static_cast<EmitterBase::TickFunction*>(emitter.tickFunc))(p, relTime);
-                        }
-                    }
+                    ++hole;
+                    holeStart = partEnds[hole];
                 }
-            };
-            updateVec(rectangles);
-            updateVec(circles);
+                while (source > hole && sourceEnd == partStarts[source])
+                {
+                    --source;
+                    sourceEnd = partEnds[source];
+                }
+                if (hole >= source)
+                    break;
+
+                const int count = std::min(partStarts[hole + 1] - holeStart, sourceEnd - partStarts[source]);
+                rectangles.move(sourceEnd - count, holeStart, count);
+                holeStart += count;
+                sourceEnd -= count;
+            }
+            rectangles.shrink(alive);
+        }
+
+        void updateAngular()
+        {
+            for (int i = 0; i < angular.size(); ++i)
+            {
+                auto& p = angular[i];
+                const float relTime = static_cast<float>(p.age) / static_cast<float>(p.lifeTime);
+                if (relTime >= 1.0F) [[unlikely]]
+                {
+                    angular[i--] = angular.back(); // Checks the swapped in particle next
+                    angular.pop_back();
+                    continue;
+                }
+
+                const auto& emitter = p.emitter->getData();
+                ++p.age;
+
+                auto diff = Point{p.pos.x, p.pos.y} - p.emissionCenter;
+                const float radius = diff.magnitude();
+
+                auto radialDir = diff / radius;
+                const auto tangentDir = radialDir.perpendicular(true);
+
+                p.pos.x += radialDir.x * -p.vy + tangentDir.x * p.vx;
+                p.pos.y += radialDir.y * -p.vy + tangentDir.y * p.vx;
+
+                p.vy += emitter.angularGravity;
+
+                if (emitter.scaleFunc != nullptr)
+                {
+                    p.scale = emitter.scaleFunc(p.scale, relTime);
+                }
+
+                if (emitter.colorFunc != nullptr)
+                {
+                    p.setColor(emitter.colorFunc(p.getColor(), relTime));
+                }
+
+                if (emitter.tickFunc != nullptr)
+                {
+                    // Copy since the tick function can create new particles
+                    auto copy = p;
+                    (*static_cast<EmitterBase::TickFunction*>(emitter.tickFunc))(copy, relTime);
+                    angular[i] = copy;
+                }
+            }
         }
     };
 
@@ -138,4 +576,4 @@ namespace magique
     }
 } // namespace magique
 
-#endif //MAGIQUE_PARTICLEDATA_H
\ No newline at end of file
+#endif //MAGIQUE_PARTICLEDATA_H
@@ -2,18 +2,24 @@
 #ifndef MAGIQUE_PATHFINDING_DATA_H
 #define MAGIQUE_PATHFINDING_DATA_H
 
+#include <atomic>
 #include <magique/core/Types.h>
+#include <magique/gamedev/PathFinding.h>
 
 #include "external/cxstructs/cxstructs/PriorityQueue.h"
 #include "internal/globals/StaticCollisionData.h"
 #include "internal/utils/CollisionPrimitives.h"
 #include "internal/datastructures/PathFindingStructs.h"
+#include "internal/types/Spinlock.h"
 
 //-----------------------------------------------
 // Pathfinding Data
 //-----------------------------------------------
 // .....................................................................
 // Uses a stateless A* implementation with custom hashset and priority queue and octile distance heuristic
+// The search state is separate (PathSearch) so batched requests can be solved on multiple threads
+// Long paths use an abstract graph of map clusters (HPA*) that is built on demand - see PathFinding.cpp
+// Path planners keep their search tree between searches and only repair the parts that became invalid
 // Also weights the heuristics in favor of closing in on the target
 // For collision lookups hashmaps are used with bitset to pack bit data
 // There are two classes of solid objects: static and dynamic
@@ -25,37 +31,1001 @@ namespace magique
 {
     using PathFindingGrid = DenseLookupGrid<MAGIQUE_PATHFINDING_CELL_SIZE>;
 
+    // State of a single jump point search - a jump is blocked by solid cells and by leaving the search bounds
+    struct JumpPointSearch final
+    {
+        const PathFindingGrid* staticGrid = nullptr;
+        const PathFindingGrid* dynamicGrid = nullptr;
+        const JumpTable* table = nullptr; // Only set if the dynamic grid is empty
+        int endX = 0, endY = 0;
+        int minX = 0, minY = 0, maxX = 0, maxY = 0; // Search bounds (inclusive)
+
+        [[nodiscard]] bool isBlocked(const int x, const int y) const
+        {
+            if (x < minX || y < minY || x > maxX || y > maxY)
+                return true;
+            const auto cellX = static_cast<float>(x * MAGIQUE_PATHFINDING_CELL_SIZE);
+            const auto cellY = static_cast<float>(y * MAGIQUE_PATHFINDING_CELL_SIZE);
+            return staticGrid->getIsMarked(cellX, cellY) || dynamicGrid->getIsMarked(cellX, cellY);
+        }
+
+        [[nodiscard]] bool hasForcedStraight(const int x, const int y, const int dx, const int dy) const
+        {
+            return (isBlocked(x + dy, y + dx) && !isBlocked(x + dx + dy, y + dy + dx)) ||
+                (isBlocked(x - dy, y - dx) && !isBlocked(x + dx - dy, y + dy - dx));
+        }
+
+        [[nodiscard]] bool hasForcedDiagonal(const int x, const int y, const int dx, const int dy) const
+        {
+            return (isBlocked(x - dx, y) && !isBlocked(x - dx, y + dy)) ||
+                (isBlocked(x, y - dy) && !isBlocked(x + dx, y - dy));
+        }
+
+        // Returns the directions worth searching from the cell when arriving in the given direction
+        int getPrunedDirections(const int x, const int y, const int dx, const int dy, int (&dirs)[8][2]) const
+        {
+            int count = 0;
+            const auto add = [&](const int dirX, const int dirY)
+            {
+                dirs[count][0] = dirX;
+                dirs[count++][1] = dirY;
+            };
+            if (dx != 0 && dy != 0)
+            {
+                add(dx, 0);
+                add(0, dy);
+                add(dx, dy);
+                if (isBlocked(x - dx, y) && !isBlocked(x - dx, y + dy))
+                    add(-dx, dy);
+                if (isBlocked(x, y - dy) && !isBlocked(x + dx, y - dy))
+                    add(dx, -dy);
+            }
+            else
+            {
+                add(dx, dy);
+                if (isBlocked(x + dy, y + dx) && !isBlocked(x + dx + dy, y + dy + dx))
+                    add(dx + dy, dy + dx);
+                if (isBlocked(x - dy, y - dx) && !isBlocked(x + dx - dy, y + dy - dx))
+                    add(dx - dy, dy - dx);
+            }
+            return count;
+        }
+
+        // Returns true if a jump point (or the end) is found going straight from the given cell
+        bool jumpStraight(int x, int y, const int dx, const int dy, int& jumpX, int& jumpY) const
+        {
+            if (table != nullptr && table->contains(x, y))
+            {
+                const auto entry = table->get(x, y, JumpTable::GetDirection(dx, dy));
+                const int dist = entry & JumpTable::DIST_MASK;
+                const int kind = entry & JumpTable::KIND_MASK;
+                // Steps until the search bounds are left
+                const int inBounds = dx > 0 ? maxX - x : dx < 0 ? x - minX : dy > 0 ? maxY - y : y - minY;
+                const int endSteps = dx != 0 ? (endY == y ? (endX - x) * dx : -1) : (endX == x ? (endY - y) * dy : -1);
+                if (endSteps > 0 && endSteps <= std::min(dist, inBounds))
+                {
+                    jumpX = endX;
+                    jumpY = endY;
+                    return true;
+                }
+                if (kind == JumpTable::WALL || dist > inBounds || (kind == JumpTable::EDGE && dist == inBounds))
+                    return false;
+                if (kind == JumpTable::JUMP_POINT)
+                {
+                    jumpX = x + dx * dist;
+                    jumpY = y + dy * dist;
+                    return true;
+                }
+                // Edge of the table - continue cell by cell
+                x += dx * dist;
+                y += dy * dist;
+            }
+
+            while (true)
+            {
+                x += dx;
+                y += dy;
+                if (isBlocked(x, y))
+                    return false;
+                if ((x == endX && y == endY) || hasForcedStraight(x, y, dx, dy))
+                {
+                    jumpX = x;
+                    jumpY = y;
+                    return true;
+                }
+            }
+        }
+
+        // Returns true if a jump point (or the end) is found going diagonal from the given cell
+        bool jumpDiagonal(int x, int y, const int dx, const int dy, int& jumpX, int& jumpY) const
+        {
+            while (true)
+            {
+                x += dx;
+                y += dy;
+                if (isBlocked(x, y))
+                    return false;
+                int straightX, straightY;
+                if ((x == endX && y == endY) || hasForcedDiagonal(x, y, dx, dy) ||
+                    jumpStraight(x, y, dx, 0, straightX, straightY) || jumpStraight(x, y, 0, dy, straightX, straightY))
+                {
+                    jumpX = x;
+                    jumpY = y;
+                    return true;
+                }
+            }
+        }
+    };
+
+    // Scratch state of a single search - each thread that searches needs its own
+    struct PathSearch final
+    {
+        static constexpr int cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+
+        SearchLookupGrid<200> lookup{}; // Open costs and closed cells - not cleared between searches
+        cxstructs::PriorityQueue<GridNode> frontier{500};
+        cxstructs::PriorityQueue<GridNode> backFrontier{500}; // Only used by the bidirectional search
+        BidirectionalLookupGrid<200> meetLookup{};             // Costs of both sides of the bidirectional search
+        GridNode nodePool[MAGIQUE_MAX_PATH_SEARCH_CAPACITY];
+        JumpPointSearch jumpSearch;
+        int expandedNodes = 0; // Nodes expanded by the last search
+
+        // Checks if the given coordinates are in a solid tile - directly takes the grids to avoid the lookup
+        [[nodiscard]] static bool IsCellSolid(const float x, const float y, const PathFindingGrid& staticGrid,
+                                              const PathFindingGrid& dynamicGrid)
+        {
+            if (staticGrid.getIsMarked(x, y)) [[unlikely]]
+            {
+                return true;
+            }
+            return dynamicGrid.getIsMarked(x, y);
+        }
+
+        // Checks if an agent of the given size (in cells) with its top left corner in the cell touches solid cells
+        [[nodiscard]] static bool IsAreaSolid(const int cellX, const int cellY, const int agentSize,
+                                              ClearanceMap& clearance, const PathFindingGrid& staticGrid,
+                                              const PathFindingGrid& dynamicGrid)
+        {
+            if (clearance.get(cellX, cellY, staticGrid) < agentSize)
+            {
+                return true;
+            }
+            if (dynamicGrid.visited.empty()) [[likely]]
+            {
+                return false;
+            }
+            for (int i = 0; i < agentSize; ++i)
+            {
+                for (int j = 0; j < agentSize; ++j)
+                {
+                    const auto x = static_cast<float>((cellX + j) * cellSize);
+                    const auto y = static_cast<float>((cellY + i) * cellSize);
+                    if (dynamicGrid.getIsMarked(x, y))
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        // Agents bigger than a cell need the clearance map of the static grid
+        bool findPath(std::vector<Point>& path, const Point startC, const Point endC, const PathFindingGrid& staticGrid,
+                      const PathFindingGrid& dynamicGrid, const uint16_t maxPathLen, GridMode mode,
+                      const int agentSize = 1, ClearanceMap* clearance = nullptr)
+        {
+            const Point start = {std::floor(startC.x / cellSize), std::floor(startC.y / cellSize)};
+            const Point end = {std::floor(endC.x / cellSize), std::floor(endC.y / cellSize)};
+
+            // Setup
+            uint16_t iterations = 0;
+            frontier.clear();
+            path.clear();
+            path.reserve(maxPathLen + 1);
+            lookup.clear();
+            lookup.setMid(start);
+
+            const auto isSolid = [&](const Point& cell)
+            {
+                if (agentSize > 1) [[unlikely]]
+                {
+                    const int cellX = static_cast<int>(cell.x);
+                    const int cellY = static_cast<int>(cell.y);
+                    return IsAreaSolid(cellX, cellY, agentSize, *clearance, staticGrid, dynamicGrid);
+                }
+                return IsCellSolid(cell.x * cellSize, cell.y * cellSize, staticGrid, dynamicGrid);
+            };
+
+            // Viability check
+            if (isSolid(end)) [[unlikely]]
+            {
+                return false;
+            }
+
+            const PathFindingHeuristicFunc hFunc = PATH_HEURISTICS[(int)mode];
+            const PathFindingMoveCostFunc mFunc = MOVE_COST[(int)mode];
+            const auto& movement = MOVEMENTS[(int)mode];
+
+            frontier.emplace(start, 0.0F, hFunc(start, end), UINT16_MAX, 0); // Initial node
+            while (!frontier.empty() && iterations < MAGIQUE_MAX_PATH_SEARCH_CAPACITY)
+            {
+                nodePool[iterations] = frontier.top();
+                auto& current = nodePool[iterations];
+                if (current.position == end) [[unlikely]]
+                {
+                    expandedNodes = iterations;
+                    constructPath(current, path);
+                    return true;
+                }
+                if (current.stepCount >= maxPathLen) [[unlikely]]
+                {
+                    expandedNodes = iterations;
+                    return false;
+                }
+                frontier.pop();
+                lookup.setClosed(current.position.x, current.position.y);
+                for (const auto& dir : movement)
+                {
+                    Point const newPos = {current.position.x + dir.x, current.position.y + dir.y};
+
+                    // Is not visited and not solid
+                    if (lookup.getIsClosed(newPos.x, newPos.y) || isSolid(newPos)) [[unlikely]]
+                    {
+                        continue;
+                    }
+
+                    const auto val = lookup.getCost(newPos.x, newPos.y);
+                    const float gCost = mFunc(dir) + current.gCost;
+                    const auto hCost = hFunc(newPos, end);
+                    const auto newPathLen = static_cast<uint16_t>(current.stepCount + 1U);
+                    const auto newFCost = hCost + gCost;
+
+                    if (val != 0.0F && newFCost >= val)
+                    {
+                        continue;
+                    }
+                    frontier.push({newPos, gCost, newFCost, iterations, newPathLen});
+                    lookup.setCost(newPos.x, newPos.y, newFCost);
+                }
+                iterations++;
+            }
+            expandedNodes = iterations;
+            return false;
+        }
+
+        // Jump point search (only GridMode::STAR) - same movement and costs as findPath() but always the shortest path
+        // Uses the precomputed jump table if given - only valid if the dynamic grid is empty
+        bool findJumpPath(std::vector<Point>& path, const Point startC, const Point endC,
+                          const PathFindingGrid& staticGrid, const PathFindingGrid& dynamicGrid, const JumpTable* table,
+                          const uint16_t maxPathLen)
+        {
+            const int startX = static_cast<int>(std::floor(startC.x / cellSize));
+            const int startY = static_cast<int>(std::floor(startC.y / cellSize));
+            const int endX = static_cast<int>(std::floor(endC.x / cellSize));
+            const int endY = static_cast<int>(std::floor(endC.y / cellSize));
+            const Point start = {static_cast<float>(startX), static_cast<float>(startY)};
+
+            // Setup
+            uint16_t iterations = 0;
+            frontier.clear();
+            path.clear();
+            path.reserve(maxPathLen + 1);
+            lookup.clear();
+            lookup.setMid(start);
+
+            auto& search = jumpSearch;
+            search.staticGrid = &staticGrid;
+            search.dynamicGrid = &dynamicGrid;
+            search.table = table;
+            search.endX = endX;
+            search.endY = endY;
+            // Cells further away cannot be part of a path within the limit - also keeps the search inside the caches
+            const int radius = std::min(static_cast<int>(maxPathLen), 99);
+            search.minX = startX - radius;
+            search.minY = startY - radius;
+            search.maxX = startX + radius;
+            search.maxY = startY + radius;
+
+            // Viability check
+            if (search.isBlocked(endX, endY)) [[unlikely]]
+            {
+                expandedNodes = 0;
+                return false;
+            }
+
+            frontier.emplace(start, 0.0F, OctileDistance(startX, startY, endX, endY), UINT16_MAX, 0);
+            while (!frontier.empty() && iterations < MAGIQUE_MAX_PATH_SEARCH_CAPACITY)
+            {
+                const GridNode node = frontier.top();
+                frontier.pop();
+                if (lookup.getIsClosed(node.position.x, node.position.y)) // Duplicate with a higher cost
+                    continue;
+
+                nodePool[iterations] = node;
+                const auto& current = nodePool[iterations];
+                const int x = static_cast<int>(current.position.x);
+                const int y = static_cast<int>(current.position.y);
+                if (x == endX && y == endY) [[unlikely]]
+                {
+                    expandedNodes = iterations;
+                    constructJumpPath(current, path);
+                    return true;
+                }
+                lookup.setClosed(current.position.x, current.position.y);
+
+                // Natural and forced neighbors given the direction we came from
+                int dirs[8][2];
+                int dirCount = 0;
+                if (current.parent == UINT16_MAX)
+                {
+                    for (const auto& dir : MOVEMENTS[(int)GridMode::STAR])
+                    {
+                        dirs[dirCount][0] = static_cast<int>(dir.x);
+                        dirs[dirCount++][1] = static_cast<int>(dir.y);
+                    }
+                }
+                else
+                {
+                    const auto& parent = nodePool[current.parent].position;
+                    dirCount = search.getPrunedDirections(x, y, Sign(x - static_cast<int>(parent.x)),
+                                                          Sign(y - static_cast<int>(parent.y)), dirs);
+                }
+
+                for (int i = 0; i < dirCount; ++i)
+                {
+                    const int dx = dirs[i][0];
+                    const int dy = dirs[i][1];
+                    int jumpX, jumpY;
+                    const bool found = dx != 0 && dy != 0 ? search.jumpDiagonal(x, y, dx, dy, jumpX, jumpY)
+                                                          : search.jumpStraight(x, y, dx, dy, jumpX, jumpY);
+                    const auto jumpPos = Point{static_cast<float>(jumpX), static_cast<float>(jumpY)};
+                    if (!found || lookup.getIsClosed(jumpPos.x, jumpPos.y))
+                        continue;
+
+                    const int steps = std::max(std::abs(jumpX - x), std::abs(jumpY - y));
+                    const auto newPathLen = static_cast<uint16_t>(current.stepCount + steps);
+                    if (newPathLen > maxPathLen)
+                        continue;
+
+                    const float gCost = current.gCost + static_cast<float>(steps) * (dx != 0 && dy != 0 ? 1.40F : 1.0F);
+                    const float newFCost = gCost + OctileDistance(jumpX, jumpY, endX, endY);
+                    const auto val = lookup.getCost(jumpPos.x, jumpPos.y);
+                    if (val != 0.0F && newFCost >= val)
+                        continue;
+                    frontier.push({jumpPos, gCost, newFCost, iterations, newPathLen});
+                    lookup.setCost(jumpPos.x, jumpPos.y, newFCost);
+                }
+                iterations++;
+            }
+            expandedNodes = iterations;
+            return false;
+        }
+
+        // Bidirectional A* - both sides share the node pool and expand the one with the smaller frontier
+        // Stops once neither side can find a cheaper connection (Pohl) - the heuristic is not weighted so it's optimal
+        bool findBidirectionalPath(std::vector<Point>& path, const Point startC, const Point endC,
+                                   const PathFindingGrid& staticGrid, const PathFindingGrid& dynamicGrid,
+                                   const uint16_t maxPathLen, const GridMode mode)
+        {
+            constexpr int FORWARD = 0;
+            constexpr int BACKWARD = 1;
+            const int startX = static_cast<int>(std::floor(startC.x / cellSize));
+            const int startY = static_cast<int>(std::floor(startC.y / cellSize));
+            const int endX = static_cast<int>(std::floor(endC.x / cellSize));
+            const int endY = static_cast<int>(std::floor(endC.y / cellSize));
+
+            // Setup
+            uint16_t iterations = 0;
+            frontier.clear();
+            backFrontier.clear();
+            path.clear();
+            path.reserve(maxPathLen + 1);
+            meetLookup.clear();
+            meetLookup.setMid((startX + endX) / 2, (startY + endY) / 2);
+            expandedNodes = 0;
+
+            // Viability check
+            if (IsCellSolid(endX * cellSize, endY * cellSize, staticGrid, dynamicGrid)) [[unlikely]]
+            {
+                return false;
+            }
+            if (startX == endX && startY == endY) [[unlikely]]
+            {
+                return true;
+            }
+
+            const auto moveCost = MOVE_COST[(int)mode];
+            const auto& movement = MOVEMENTS[(int)mode];
+            const int roots[2][2] = {{startX, startY}, {endX, endY}};
+            const auto heuristic = [&](const int side, const int x, const int y)
+            {
+                const int* target = roots[1 - side];
+                if (mode == GridMode::CROSS)
+                    return static_cast<float>(std::abs(x - target[0]) + std::abs(y - target[1]));
+                return OctileDistance(x, y, target[0], target[1]);
+            };
+
+            cxstructs::PriorityQueue<GridNode>* queues[2] = {&frontier, &backFrontier};
+            for (int side = FORWARD; side <= BACKWARD; ++side)
+            {
+                const int x = roots[side][0];
+                const int y = roots[side][1];
+                meetLookup.set(side, x, y, {0.0F, UINT16_MAX, 0});
+                const Point root = {static_cast<float>(x), static_cast<float>(y)};
+                queues[side]->emplace(root, 0.0F, heuristic(side, x, y), UINT16_MAX, 0);
+            }
+
+            float bestCost = BidirectionalLookupGrid<200>::NOT_REACHED;
+            Point meetCell{};
+            uint16_t meetParents[2] = {UINT16_MAX, UINT16_MAX}; // Last node of each side before the meeting cell
+            while (iterations < MAGIQUE_MAX_PATH_SEARCH_CAPACITY && !frontier.empty() && !backFrontier.empty())
+            {
+                // A cheaper connection would have a lower combined cost on both sides
+                if (std::max(frontier.top().fCost, backFrontier.top().fCost) >= bestCost)
+                    break;
+
+                const int side = frontier.size() <= backFrontier.size() ? FORWARD : BACKWARD;
+                const int other = 1 - side;
+                auto& queue = *queues[side];
+                const GridNode node = queue.top();
+                queue.pop();
+                const int x = static_cast<int>(node.position.x);
+                const int y = static_cast<int>(node.position.y);
+                if (meetLookup.getIsClosed(side, x, y) || node.stepCount >= maxPathLen) // Duplicate or too long
+                    continue;
+
+                nodePool[iterations] = node;
+                meetLookup.setClosed(side, x, y);
+                for (const auto& dir : movement)
+                {
+                    const int newX = x + static_cast<int>(dir.x);
+                    const int newY = y + static_cast<int>(dir.y);
+                    if (IsCellSolid(newX * cellSize, newY * cellSize, staticGrid, dynamicGrid))
+                        continue;
+
+                    // Connects with the other side
+                    const float gCost = node.gCost + moveCost(dir);
+                    const auto newPathLen = static_cast<uint16_t>(node.stepCount + 1U);
+                    if (const auto* reached = meetLookup.get(other, newX, newY))
+                    {
+                        if (gCost + reached->gCost < bestCost && newPathLen + reached->stepCount <= maxPathLen)
+                        {
+                            bestCost = gCost + reached->gCost;
+                            meetCell = {static_cast<float>(newX), static_cast<float>(newY)};
+                            meetParents[side] = iterations;
+                            meetParents[other] = reached->parent;
+                        }
+                    }
+
+                    if (meetLookup.getIsClosed(side, newX, newY))
+                        continue;
+                    const auto* known = meetLookup.get(side, newX, newY);
+                    if (known != nullptr && gCost >= known->gCost)
+                        continue;
+                    meetLookup.set(side, newX, newY, {gCost, iterations, newPathLen});
+                    const Point newPos = {static_cast<float>(newX), static_cast<float>(newY)};
+                    queue.push({newPos, gCost, gCost + heuristic(side, newX, newY), iterations, newPathLen});
+                }
+                iterations++;
+            }
+            expandedNodes = iterations;
+            if (bestCost == BidirectionalLookupGrid<200>::NOT_REACHED)
+            {
+                return false;
+            }
+            const Point start = {static_cast<float>(startX), static_cast<float>(startY)};
+            constructBidirectionalPath(meetCell, meetParents, start, path);
+            return true;
+        }
+
+    private:
+        static int Sign(const int value) { return (value > 0) - (value < 0); }
+
+        static float OctileDistance(const int x1, const int y1, const int x2, const int y2)
+        {
+            const int dx = std::abs(x1 - x2);
+            const int dy = std::abs(y1 - y2);
+            return static_cast<float>(std::min(dx, dy)) * 1.40F + static_cast<float>(std::abs(dx - dy));
+        }
+
+        void constructJumpPath(const GridNode& current, std::vector<Point>& path) const
+        {
+            // Jump points are connected by straight or diagonal lines - all cells in between are added
+            const GridNode* curr = &current;
+            while (curr->parent != UINT16_MAX)
+            {
+                const auto& parent = nodePool[curr->parent].position;
+                const int dx = Sign(static_cast<int>(parent.x - curr->position.x));
+                const int dy = Sign(static_cast<int>(parent.y - curr->position.y));
+                int x = static_cast<int>(curr->position.x);
+                int y = static_cast<int>(curr->position.y);
+                while (x != static_cast<int>(parent.x) || y != static_cast<int>(parent.y))
+                {
+                    path.push_back({(static_cast<float>(x) * cellSize) + (cellSize / 2.0F),
+                                    (static_cast<float>(y) * cellSize) + (cellSize / 2.0F)});
+                    x += dx;
+                    y += dy;
+                }
+                curr = &nodePool[curr->parent];
+            }
+        }
+
+        void constructBidirectionalPath(const Point meetCell, const uint16_t parents[2], const Point start,
+                                        std::vector<Point>& path) const
+        {
+            const auto toPoint = [](const Point& cell)
+            { return Point{(cell.x * cellSize) + (cellSize / 2.0F), (cell.y * cellSize) + (cellSize / 2.0F)}; };
+
+            // The backward nodes lead to the end - the end is the first point
+            for (uint16_t idx = parents[1]; idx != UINT16_MAX; idx = nodePool[idx].parent)
+            {
+                path.push_back(toPoint(nodePool[idx].position));
+            }
+            std::reverse(path.begin(), path.end());
+            if (meetCell != start)
+            {
+                path.push_back(toPoint(meetCell));
+            }
+            // The forward nodes lead to the start - excluding the start
+            for (uint16_t idx = parents[0]; idx != UINT16_MAX && nodePool[idx].parent != UINT16_MAX;
+                 idx = nodePool[idx].parent)
+            {
+                path.push_back(toPoint(nodePool[idx].position));
+            }
+        }
+
+        void constructPath(const GridNode& current, std::vector<Point>& path) const
+        {
+            const GridNode* curr = &current;
+            while (curr->parent != UINT16_MAX)
+            {
+                const Point p = {(curr->position.x * cellSize) + (cellSize / 2.0F),
+                                 (curr->position.y * cellSize) + (cellSize / 2.0F)};
+                path.push_back(p);
+                curr = &nodePool[curr->parent];
+            }
+        }
+    };
+
+    // Search tree of a PathPlanner - kept between searches and rooted at the start cell of the last search
+    // Expanded (closed) nodes always hold the exact cost from the root - they stay valid when the goal moves
+    // Uses an admissible heuristic (not weighted) so the found paths are always the shortest
+    struct IncrementalSearch final
+    {
+        enum class NodeState : uint8_t
+        {
+            OPEN,
+            CLOSED,
+            DROPPED, // Not part of the tree anymore - removed from the lookup
+        };
+
+        // Costs and steps are from the first root - only differences to the current root matter
+        struct Node final
+        {
+            int x, y;
+            float gCost;
+            int parent;
+            int stepCount;
+            NodeState state;
+        };
+
+        struct OpenNode final
+        {
+            float fCost;
+            float gCost; // Outdated if it doesn't match the node anymore
+            int node;
+
+            // Min heap - prefers deeper nodes on ties
+            bool operator<(const OpenNode& other) const
+            {
+                return fCost > other.fCost || (fCost == other.fCost && gCost < other.gCost);
+            }
+        };
+
+        std::vector<Node> nodes;
+        std::vector<int> closed;            // In expansion order - parents are always before their children
+        std::vector<OpenNode> open;         // Binary heap
+        HashMap<VisitedCellID, int> lookup; // Cell to node - only nodes that are part of the tree
+        int root = 0;
+        MapID map{};
+        GridMode mode = GridMode::STAR;
+        int goalX = 0, goalY = 0;   // Goal the open nodes are ordered for
+        uint32_t staticVersion = 0; // Version of the static grids the tree was built with
+        uint64_t dynamicHash = 0;   // Hash of the dynamic grid the tree was built with
+        int expandedNodes = 0;      // Nodes expanded by the last search
+        bool isEmpty = true;
+        bool isOrdered = false; // If the open nodes are ordered for the goal
+
+        // Keeps at most this many expanded nodes - the search is started from scratch otherwise
+        static constexpr int MAX_CLOSED = 16 * MAGIQUE_MAX_PATH_SEARCH_CAPACITY;
+
+        void reset()
+        {
+            nodes.clear();
+            closed.clear();
+            open.clear();
+            lookup.clear();
+            isEmpty = true;
+        }
+
+        // Moves the root to the new start (if it was expanded) and repairs the tree for the changed grids
+        // Only the expanded nodes that still have their exact cost are kept - the nodes around them are opened again
+        void repair(const int startX, const int startY, const bool gridChanged, const PathFindingGrid& staticGrid,
+                    const PathFindingGrid& dynamicGrid)
+        {
+            const int newRoot = find(startX, startY);
+            if (newRoot == -1 || nodes[newRoot].state != NodeState::CLOSED ||
+                static_cast<int>(closed.size()) > MAX_CLOSED)
+            {
+                setRoot(startX, startY);
+                return;
+            }
+            const auto& movement = MOVEMENTS[(int)mode];
+            const auto moveCost = MOVE_COST[(int)mode];
+
+            // Only the subtree of the new root keeps its costs - without cells that became solid
+            std::vector<uint8_t> keep(nodes.size(), 0);
+            for (const int idx : closed)
+            {
+                const auto& node = nodes[idx];
+                if (idx == newRoot)
+                    keep[idx] = 1;
+                else if (node.parent != -1 && keep[node.parent] != 0)
+                    keep[idx] = gridChanged ? !IsSolid(node.x, node.y, staticGrid, dynamicGrid) : 1;
+            }
+
+            // Cells that became free can only shorten the paths to nodes with a higher cost than their own
+            std::vector<Node> freed;
+            if (gridChanged)
+            {
+                float threshold = std::numeric_limits<float>::max();
+                for (const int idx : closed)
+                {
+                    const auto& node = nodes[idx];
+                    if (keep[idx] == 0)
+                        continue;
+                    for (const auto& dir : movement)
+                    {
+                        const int x = node.x + static_cast<int>(dir.x);
+                        const int y = node.y + static_cast<int>(dir.y);
+                        // All free neighbors of expanded nodes are known - unknown ones were solid before
+                        if (find(x, y) != -1 || IsSolid(x, y, staticGrid, dynamicGrid))
+                            continue;
+                        const float gCost = node.gCost + moveCost(dir);
+                        threshold = std::min(threshold, gCost);
+                        freed.push_back({x, y, gCost, idx, node.stepCount + 1, NodeState::OPEN});
+                    }
+                }
+                for (const int idx : closed)
+                {
+                    if (nodes[idx].gCost >= threshold)
+                        keep[idx] = 0;
+                }
+            }
+
+            root = newRoot;
+            nodes[root].parent = -1;
+            int count = 0;
+            for (const int idx : closed)
+            {
+                if (keep[idx] != 0)
+                    closed[count++] = idx;
+            }
+            closed.resize(count);
+
+            // All other nodes are opened again if next to a kept node - the ones with a kept parent keep their cost
+            open.clear();
+            const int nodeCount = static_cast<int>(nodes.size());
+            for (int idx = 0; idx < nodeCount; ++idx)
+            {
+                auto& node = nodes[idx];
+                if (keep[idx] != 0 || node.state == NodeState::DROPPED)
+                    continue;
+                if (gridChanged && IsSolid(node.x, node.y, staticGrid, dynamicGrid))
+                {
+                    drop(idx);
+                    continue;
+                }
+                if (node.state == NodeState::OPEN && keep[node.parent] != 0)
+                {
+                    open.push_back({0.0F, node.gCost, idx});
+                    continue;
+                }
+                node.gCost = std::numeric_limits<float>::max();
+                for (const auto& dir : movement)
+                {
+                    const int neighbor = find(node.x + static_cast<int>(dir.x), node.y + static_cast<int>(dir.y));
+                    if (neighbor == -1 || keep[neighbor] == 0 || nodes[neighbor].gCost + moveCost(dir) >= node.gCost)
+                        continue;
+                    node.gCost = nodes[neighbor].gCost + moveCost(dir);
+                    node.parent = neighbor;
+                    node.stepCount = nodes[neighbor].stepCount + 1;
+                }
+                if (node.gCost == std::numeric_limits<float>::max())
+                {
+                    drop(idx);
+                    continue;
+                }
+                node.state = NodeState::OPEN;
+                open.push_back({0.0F, node.gCost, idx});
+            }
+            for (const auto& node : freed)
+            {
+                if (keep[node.parent] != 0)
+                    generate(node.x, node.y, node.parent, node.gCost);
+            }
+            isOrdered = false;
+
+            if (nodes.size() > 2 * lookup.size() + MAGIQUE_MAX_PATH_SEARCH_CAPACITY)
+            {
+                compact();
+            }
+        }
+
+        // Continues the search until the goal is expanded - reuses the tree if the goal was already reached
+        bool findPath(std::vector<Point>& path, const int endX, const int endY, const int maxPathLen,
+                      const PathFindingGrid& staticGrid, const PathFindingGrid& dynamicGrid)
+        {
+            path.clear();
+            expandedNodes = 0;
+            if (IsSolid(endX, endY, staticGrid, dynamicGrid)) [[unlikely]]
+            {
+                return false;
+            }
+
+            const int rootSteps = nodes[root].stepCount;
+            const int endIdx = find(endX, endY);
+            if (endIdx != -1 && nodes[endIdx].state == NodeState::CLOSED)
+            {
+                if (nodes[endIdx].stepCount - rootSteps > maxPathLen)
+                    return false;
+                constructPath(endIdx, path);
+                return true;
+            }
+
+            // Reorder for the new goal - outdated entries are dropped
+            if (!isOrdered || endX != goalX || endY != goalY)
+            {
+                isOrdered = true;
+                goalX = endX;
+                goalY = endY;
+                int count = 0;
+                for (const auto& entry : open)
+                {
+                    const auto& node = nodes[entry.node];
+                    if (node.state != NodeState::OPEN || node.gCost != entry.gCost)
+                        continue;
+                    open[count++] = {node.gCost + heuristic(node.x, node.y), node.gCost, entry.node};
+                }
+                open.resize(count);
+                std::make_heap(open.begin(), open.end());
+            }
+
+            const auto& movement = MOVEMENTS[(int)mode];
+            const auto moveCost = MOVE_COST[(int)mode];
+            while (!open.empty() && expandedNodes < MAGIQUE_MAX_PATH_SEARCH_CAPACITY)
+            {
+                const auto entry = open.front();
+                auto& current = nodes[entry.node];
+                if (current.state != NodeState::OPEN || current.gCost != entry.gCost) // Duplicate with a higher cost
+                {
+                    std::pop_heap(open.begin(), open.end());
+                    open.pop_back();
+                    continue;
+                }
+                if (current.x == endX && current.y == endY) [[unlikely]]
+                {
+                    constructPath(entry.node, path);
+                    return true;
+                }
+                if (current.stepCount - rootSteps >= maxPathLen) [[unlikely]]
+                {
+                    return false; // Stays open for the next search
+                }
+                std::pop_heap(open.begin(), open.end());
+                open.pop_back();
+                current.state = NodeState::CLOSED;
+                closed.push_back(entry.node);
+                ++expandedNodes;
+
+                const int x = current.x;
+                const int y = current.y;
+                const float gCost = current.gCost;
+                for (const auto& dir : movement)
+                {
+                    const int newX = x + static_cast<int>(dir.x);
+                    const int newY = y + static_cast<int>(dir.y);
+                    if (IsSolid(newX, newY, staticGrid, dynamicGrid))
+                        continue;
+                    generate(newX, newY, entry.node, gCost + moveCost(dir));
+                }
+            }
+            return false;
+        }
+
+    private:
+        static bool IsSolid(const int x, const int y, const PathFindingGrid& staticGrid,
+                            const PathFindingGrid& dynamicGrid)
+        {
+            constexpr float cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+            return PathSearch::IsCellSolid(static_cast<float>(x) * cellSize, static_cast<float>(y) * cellSize,
+                                           staticGrid, dynamicGrid);
+        }
+
+        [[nodiscard]] int find(const int x, const int y) const
+        {
+            const auto it = lookup.find(GetVisitedCell(x, y));
+            return it != lookup.end() ? it->second : -1;
+        }
+
+        // Manhattan or octile distance - never overestimates
+        [[nodiscard]] float heuristic(const int x, const int y) const
+        {
+            const int dx = std::abs(x - goalX);
+            const int dy = std::abs(y - goalY);
+            if (mode == GridMode::CROSS)
+                return static_cast<float>(dx + dy);
+            return static_cast<float>(std::min(dx, dy)) * 1.40F + static_cast<float>(std::abs(dx - dy));
+        }
+
+        void setRoot(const int x, const int y)
+        {
+            reset();
+            nodes.push_back({x, y, 0.0F, -1, 0, NodeState::OPEN});
+            lookup[GetVisitedCell(x, y)] = 0;
+            open.push_back({0.0F, 0.0F, 0});
+            root = 0;
+            isEmpty = false;
+            isOrdered = false;
+        }
+
+        void drop(const int idx)
+        {
+            nodes[idx].state = NodeState::DROPPED;
+            lookup.erase(GetVisitedCell(nodes[idx].x, nodes[idx].y));
+        }
+
+        // Adds or improves the open node of the cell
+        void generate(const int x, const int y, const int parent, const float gCost)
+        {
+            const auto [it, inserted] = lookup.try_emplace(GetVisitedCell(x, y), static_cast<int>(nodes.size()));
+            const int stepCount = nodes[parent].stepCount + 1;
+            if (inserted)
+            {
+                nodes.push_back({x, y, gCost, parent, stepCount, NodeState::OPEN});
+            }
+            else
+            {
+                auto& node = nodes[it->second];
+                if (node.state == NodeState::CLOSED || gCost >= node.gCost)
+                    return;
+                node.gCost = gCost;
+                node.parent = parent;
+                node.stepCount = stepCount;
+            }
+            open.push_back({gCost + heuristic(x, y), gCost, it->second});
+            std::push_heap(open.begin(), open.end());
+        }
+
+        // Removes the dropped nodes - costs and steps start from the root again
+        void compact()
+        {
+            const float rootCost = nodes[root].gCost;
+            const int rootSteps = nodes[root].stepCount;
+            std::vector<int> newIndex(nodes.size(), -1);
+            std::vector<Node> oldNodes;
+            std::swap(oldNodes, nodes);
+            lookup.clear();
+            const auto add = [&](const int idx)
+            {
+                newIndex[idx] = static_cast<int>(nodes.size());
+                auto& node = nodes.emplace_back(oldNodes[idx]);
+                node.gCost -= rootCost;
+                node.stepCount -= rootSteps;
+                lookup[GetVisitedCell(node.x, node.y)] = newIndex[idx];
+            };
+            for (auto& idx : closed) // Parents before children
+            {
+                add(idx);
+                idx = newIndex[idx];
+            }
+            int count = 0;
+            for (const auto& entry : open)
+            {
+                const auto& node = oldNodes[entry.node];
+                if (node.state != NodeState::OPEN || node.gCost != entry.gCost) // Outdated
+                    continue;
+                add(entry.node);
+                open[count++] = {entry.fCost - rootCost, node.gCost - rootCost, newIndex[entry.node]};
+            }
+            open.resize(count);
+            std::make_heap(open.begin(), open.end());
+            for (auto& node : nodes)
+            {
+                if (node.parent != -1)
+                    node.parent = newIndex[node.parent];
+            }
+            root = 0;
+        }
+
+        void constructPath(int idx, std::vector<Point>& path) const
+        {
+            constexpr float cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+            while (idx != root)
+            {
+                const auto& node = nodes[idx];
+                path.push_back({static_cast<float>(node.x) * cellSize + cellSize / 2.0F,
+                                static_cast<float>(node.y) * cellSize + cellSize / 2.0F});
+                idx = node.parent;
+            }
+        }
+    };
+
+    // A queued search - solved together with all other requests of the tick
+    struct PathRequest final
+    {
+        PathCallback callback;
+        Point start;
+        Point end;
+        const PathFindingGrid* staticGrid = nullptr; // Grids are resolved before the batch is solved
+        const PathFindingGrid* dynamicGrid = nullptr;
+        const JumpTable* table = nullptr;
+        ClearanceMap* clearance = nullptr; // Only for agents bigger than a cell - built on demand so not shared
+        MapID map;
+        uint16_t maxLen;
+        GridMode mode;
+        PathAlgorithm algorithm;
+        uint8_t agentSize = 1;
+        bool found = false;
+        bool isCached = false; // Found in the path cache - not searched
+    };
+
     struct PathFindingData final
     {
         // Constants
         static constexpr int cellSize = MAGIQUE_PATHFINDING_CELL_SIZE;
+        static constexpr int MIN_PARALLEL_REQUESTS = 8; // Smaller batches are solved only on the main thread
 
         // Grid data for each map - if cell is usable for pathfinding or not
         MapHolder<PathFindingGrid> mapsStaticGrids;
         MapHolder<PathFindingGrid> mapsDynamicGrids;
+        MapHolder<JumpTable> mapsJumpTables;      // Built on demand for jump point search
+        MapHolder<ClusterGraph> mapsClusterGraphs; // Built on demand for long paths
+        MapHolder<ClearanceMap> mapsClearance;     // Built on demand for agents bigger than a cell
 
         // A star cache
         std::vector<Point> pathCache;
-        StaticDenseLookupGrid<bool, 200> visited{};
-        StaticDenseLookupGrid<float, 200> openCost{};
-        cxstructs::PriorityQueue<GridNode> frontier{500};
-        GridNode nodePool[MAGIQUE_MAX_PATH_SEARCH_CAPACITY];
+        PathSearch search;     // Used by all searches on the main thread
+        int expandedNodes = 0; // Nodes expanded by the last search
 
         // Lookup table for entity types and entities
         HashSet<entt::entity> solidEntities;
         HashSet<EntityType> solidTypes;
 
+        // Batched requests - see PathRequestSystem.h
+        Spinlock requestLock;                                          // Requests can be added from any thread
+        std::vector<PathRequest> pendingRequests;                      // Added since the last batch
+        std::vector<PathRequest> batchRequests;                        // Currently solved
+        std::vector<std::vector<Point>> batchPaths;                    // Kept to reuse the memory
+        std::array<PathSearch, MAGIQUE_WORKER_THREADS> workerSearches; // The main thread uses its own
+
+        // Flow fields
+        HashMap<uint64_t, FlowField> flowFields;        // Cached by map and goal cell
+        HashMap<MapID, DynamicGridHash> dynamicHashes; // Detects changed dynamic grids
+        uint32_t staticGridVersion = 0;                 // Incremented when any static grid changes
+
+        // Found paths - see SetPathCache()
+        PathCache cachedPaths;
+
+        // Search trees of the path planners
+        HashMap<int, IncrementalSearch> planners;
+        int nextPlannerID = 0;
+
         //----------------- METHODS -----------------//
 
         // Checks if the given coordinates are in a solid tile - directly takes the grids to avoid the lookup
         [[nodiscard]] static bool IsCellSolid(const float x, const float y, const PathFindingGrid& staticGrid,
                                               const PathFindingGrid& dynamicGrid)
         {
-            if (staticGrid.getIsMarked(x, y)) [[unlikely]]
-            {
-                return true;
-            }
-            return dynamicGrid.getIsMarked(x, y);
+            return PathSearch::IsCellSolid(x, y, staticGrid, dynamicGrid);
         }
 
         [[nodiscard]] bool getIsPathSolid(const entt::entity e, const EntityType type) const
@@ -63,35 +1033,56 @@ namespace magique
             return solidTypes.contains(type) || solidEntities.contains(e);
         }
 
+        // Marks all cells of the grid that intersect the given rect - optionally only cells inside the clip (in cells)
+        static void RasterizeRect(PathFindingGrid& grid, const float x, const float y, const float w, const float h,
+                                  const int clipX1 = std::numeric_limits<int>::min(),
+                                  const int clipY1 = std::numeric_limits<int>::min(),
+                                  const int clipX2 = std::numeric_limits<int>::max(),
+                                  const int clipY2 = std::numeric_limits<int>::max())
+        {
+            const int startX = std::max(clipX1, static_cast<int>(std::floor(x / cellSize)));
+            const int startY = std::max(clipY1, static_cast<int>(std::floor(y / cellSize)));
+            const int endX = std::min(clipX2, static_cast<int>(std::floor((x + w) / cellSize)));
+            const int endY = std::min(clipY2, static_cast<int>(std::floor((y + h) / cellSize)));
+
+            // Loop through potentially intersecting grid cells
+            for (int i = startY; i <= endY; ++i)
+            {
+                const auto cellY = static_cast<float>(i) * cellSize;
+                for (int j = startX; j <= endX; ++j)
+                {
+                    const auto cellX = static_cast<float>(j) * cellSize;
+                    // Check for intersection and mark the grid cell
+                    if (RectToRect(x, y, w, h, cellX, cellY, cellSize, cellSize))
+                    {
+                        grid.setMarked(cellX, cellY);
+                    }
+                }
+            }
+        }
+
         // Updates the pathfinding grid for the given map
         void updateStaticPathGrid(const MapID map)
         {
             const auto& staticData = global::STATIC_COLL_DATA;
             auto& staticGrid = mapsStaticGrids[map];
-            staticGrid.clear();
+            ++staticGridVersion;
+            if (mapsJumpTables.contains(map))
+            {
+                mapsJumpTables[map].isDirty = true;
+            }
 
-            const auto rasterizeRect = [&](const float x, const float y, const float w, const float h)
+            // Keep the old grid to only invalidate the clusters and clearance that changed
+            const bool hasBlockData = mapsClusterGraphs.contains(map) || mapsClearance.contains(map);
+            PathFindingGrid previous;
+            if (hasBlockData)
             {
-                const int startX = static_cast<int>(std::floor(x / cellSize));
-                const int startY = static_cast<int>(std::floor(y / cellSize));
-                const int endX = static_cast<int>(std::floor((x + w) / cellSize));
-                const int endY = static_cast<int>(std::floor((y + h) / cellSize));
+                std::swap(previous, staticGrid);
+            }
+            staticGrid.clear();
 
-                // Loop through potentially intersecting grid cells
-                for (int i = startY; i <= endY; ++i)
-                {
-                    const auto cellY = static_cast<float>(i) * cellSize;
-                    for (int j = startX; j <= endX; ++j)
-                    {
-                        const auto cellX = static_cast<float>(j) * cellSize;
-                        // Check for intersection and mark the grid cell
-                        if (RectToRect(x, y, w, h, cellX, cellY, cellSize, cellSize))
-                        {
-                            staticGrid.setMarked(cellX, cellY);
-                        }
-                    }
-                }
-            };
+            const auto rasterizeRect = [&](const float x, const float y, const float w, const float h)
+            { RasterizeRect(staticGrid, x, y, w, h); };
 
             // Add world bounds
             if (staticData.getIsWorldBoundSet())
@@ -145,95 +1136,358 @@ namespace magique
                     }
                 }
             }
+
+            if (hasBlockData)
+            {
+                invalidateBlocks(map, previous.visited);
+            }
         }
 
-        bool findPath(std::vector<Point>& path, const Point startC, const Point endC, const MapID map,
-                      const uint16_t maxPathLen, GridMode mode)
+        // Updates only the cells of the static grid that intersect the given rect - e.g. for a loaded or unloaded chunk
+        // Clears them and rasterizes all colliders touching them again - then only the changed blocks are invalidated
+        void updateStaticPathRect(const MapID map, const Rectangle& rect)
         {
-            const Point start = {std::floor(startC.x / cellSize), std::floor(startC.y / cellSize)};
-            const Point end = {std::floor(endC.x / cellSize), std::floor(endC.y / cellSize)};
+            const auto& staticData = global::STATIC_COLL_DATA;
+            auto& staticGrid = mapsStaticGrids[map];
+            const int x1 = static_cast<int>(std::floor(rect.x / cellSize));
+            const int y1 = static_cast<int>(std::floor(rect.y / cellSize));
+            const int x2 = static_cast<int>(std::floor((rect.x + rect.width) / cellSize));
+            const int y2 = static_cast<int>(std::floor((rect.y + rect.height) / cellSize));
 
-            // Setup
-            uint16_t iterations = 0;
-            frontier.clear();
-            path.clear();
-            path.reserve(maxPathLen + 1);
-            visited.clear(); // Costly - big memsets
-            openCost.clear();
-            visited.setMid(start);
-            openCost.setMid(start);
+            // Keep the old blocks to only invalidate the ones that changed
+            constexpr int blockPixels = PathFindingGrid::mainGridSize;
+            const int blockX1 = floordiv<blockPixels>(x1 * cellSize);
+            const int blockY1 = floordiv<blockPixels>(y1 * cellSize);
+            const int blockX2 = floordiv<blockPixels>(x2 * cellSize);
+            const int blockY2 = floordiv<blockPixels>(y2 * cellSize);
+            std::vector<std::pair<VisitedCellID, PathFindingGrid::Block>> previous;
+            for (int i = blockY1; i <= blockY2; ++i)
+            {
+                for (int j = blockX1; j <= blockX2; ++j)
+                {
+                    const auto key = GetVisitedCell(j, i);
+                    const auto it = staticGrid.visited.find(key);
+                    previous.emplace_back(key, it != staticGrid.visited.end() ? it->second : PathFindingGrid::Block{});
+                }
+            }
+
+            for (int i = y1; i <= y2; ++i)
+            {
+                for (int j = x1; j <= x2; ++j)
+                    staticGrid.setUnmarked(static_cast<float>(j * cellSize), static_cast<float>(i * cellSize));
+            }
+
+            // Everything that touches the cells - a bit bigger so colliders ending on a cell border are found
+            const float areaX = static_cast<float>(x1 * cellSize) - 1.0F;
+            const float areaY = static_cast<float>(y1 * cellSize) - 1.0F;
+            const float areaW = static_cast<float>((x2 - x1 + 1) * cellSize) + 2.0F;
+            const float areaH = static_cast<float>((y2 - y1 + 1) * cellSize) + 2.0F;
+            const auto rasterizeRect = [&](const float x, const float y, const float w, const float h)
+            { RasterizeRect(staticGrid, x, y, w, h, x1, y1, x2, y2); };
+
+            if (staticData.getIsWorldBoundSet())
+            {
+                constexpr float depth = MAGIQUE_WORLD_BOUND_DEPTH;
+                const auto wBounds = staticData.worldBounds;
+                rasterizeRect(wBounds.x - depth, wBounds.y - depth, depth, wBounds.height + depth);
+                rasterizeRect(wBounds.x, wBounds.y - depth, wBounds.width, depth);
+                rasterizeRect(wBounds.x + wBounds.width, wBounds.y - depth, depth, wBounds.height + depth);
+                rasterizeRect(wBounds.x, wBounds.y + wBounds.height, wBounds.width, depth);
+            }
+
+            std::vector<StaticID> ids;
+            if (staticData.mapObjectGrids.contains(map))
+                staticData.mapObjectGrids[map].query(ids, areaX, areaY, areaW, areaH);
+            if (staticData.mapTileGrids.contains(map))
+                staticData.mapTileGrids[map].query(ids, areaX, areaY, areaW, areaH);
+            if (staticData.mapGroupGrids.contains(map))
+                staticData.mapGroupGrids[map].query(ids, areaX, areaY, areaW, areaH);
+            for (const auto id : ids)
+            {
+                const auto& [x, y, w, h] = staticData.colliderStorage.get(StaticIDHelper::GetObjectNum(id));
+                rasterizeRect(x, y, w, h);
+            }
+
+            bool changed = false;
+            auto* graph = mapsClusterGraphs.contains(map) ? &mapsClusterGraphs[map] : nullptr;
+            auto* clearance = mapsClearance.contains(map) ? &mapsClearance[map] : nullptr;
+            for (const auto& [key, block] : previous)
+            {
+                const auto it = staticGrid.visited.find(key);
+                if ((it != staticGrid.visited.end() ? it->second : PathFindingGrid::Block{}) == block)
+                    continue;
+                changed = true;
+                const auto blockX = static_cast<int16_t>(key >> 16);
+                const auto blockY = static_cast<int16_t>(key & 0xFFFF);
+                if (graph != nullptr)
+                    graph->invalidate(blockX, blockY);
+                if (clearance != nullptr)
+                    clearance->invalidate(blockX, blockY);
+            }
+            if (!changed)
+            {
+                return;
+            }
+            ++staticGridVersion;
+            if (mapsJumpTables.contains(map) && !mapsJumpTables[map].isDirty)
+            {
+                updateJumpTable(mapsJumpTables[map], staticGrid, x1, y1, x2, y2);
+            }
+        }
+
+        // Marks all cached data of the static grid as outdated - for when the grid is written directly
+        void markStaticGridChanged(const MapID map)
+        {
+            ++staticGridVersion;
+            if (mapsJumpTables.contains(map))
+            {
+                mapsJumpTables[map].isDirty = true;
+            }
+            if (mapsClusterGraphs.contains(map))
+            {
+                mapsClusterGraphs[map].clusters.clear();
+            }
+            if (mapsClearance.contains(map))
+            {
+                mapsClearance[map].blocks.clear();
+            }
+        }
+
+        // Invalidates the clusters and clearance of the blocks that differ between the previous and current static grid
+        void invalidateBlocks(const MapID map, const decltype(PathFindingGrid::visited)& previous)
+        {
+            auto* graph = mapsClusterGraphs.contains(map) ? &mapsClusterGraphs[map] : nullptr;
+            auto* clearance = mapsClearance.contains(map) ? &mapsClearance[map] : nullptr;
+            const auto& current = mapsStaticGrids[map].visited;
+            const auto invalidate = [&](const VisitedCellID key)
+            {
+                const auto blockX = static_cast<int16_t>(key >> 16);
+                const auto blockY = static_cast<int16_t>(key & 0xFFFF);
+                if (graph != nullptr)
+                    graph->invalidate(blockX, blockY);
+                if (clearance != nullptr)
+                    clearance->invalidate(blockX, blockY);
+            };
+
+            for (const auto& [key, block] : current)
+            {
+                const auto it = previous.find(key);
+                if (it == previous.end() || it->second != block)
+                    invalidate(key);
+            }
+            for (const auto& [key, block] : previous)
+            {
+                if (!current.contains(key))
+                    invalidate(key);
+            }
+        }
+
+        bool findPath(std::vector<Point>& path, const Point start, const Point end, const MapID map,
+                      const uint16_t maxPathLen, const GridMode mode, const int agentSize = 1)
+        {
             const auto& staticGrid = mapsStaticGrids[map];
             const auto& dynamicGrid = mapsDynamicGrids[map];
+            auto* clearance = agentSize > 1 ? &mapsClearance[map] : nullptr;
+            const bool found =
+                search.findPath(path, start, end, staticGrid, dynamicGrid, maxPathLen, mode, agentSize, clearance);
+            expandedNodes = search.expandedNodes;
+            return found;
+        }
 
-            // Viability check
-            if (IsCellSolid(end.x * cellSize, end.y * cellSize, staticGrid, dynamicGrid)) [[unlikely]]
+        bool findJumpPath(std::vector<Point>& path, const Point start, const Point end, const MapID map,
+                          const uint16_t maxPathLen)
+        {
+            const auto& staticGrid = mapsStaticGrids[map];
+            const auto& dynamicGrid = mapsDynamicGrids[map];
+            const JumpTable* table = dynamicGrid.visited.empty() ? getJumpTable(map) : nullptr;
+            const bool found = search.findJumpPath(path, start, end, staticGrid, dynamicGrid, table, maxPathLen);
+            expandedNodes = search.expandedNodes;
+            return found;
+        }
+
+        bool findBidirectionalPath(std::vector<Point>& path, const Point start, const Point end, const MapID map,
+                                   const uint16_t maxPathLen, const GridMode mode)
+        {
+            const auto& staticGrid = mapsStaticGrids[map];
+            const auto& dynamicGrid = mapsDynamicGrids[map];
+            const bool found = search.findBidirectionalPath(path, start, end, staticGrid, dynamicGrid, maxPathLen, mode);
+            expandedNodes = search.expandedNodes;
+            return found;
+        }
+
+        static PathCacheKey GetCacheKey(const Point start, const Point end, const MapID map, const uint16_t maxLen,
+                                        const GridMode mode, PathAlgorithm algorithm, const int agentSize = 1)
+        {
+            if (agentSize > 1 || (algorithm == PathAlgorithm::JUMP_POINT && mode != GridMode::STAR)) // Fall back to A*
+                algorithm = PathAlgorithm::A_STAR;
+            return {static_cast<int>(std::floor(start.x / cellSize)),
+                    static_cast<int>(std::floor(start.y / cellSize)),
+                    static_cast<int>(std::floor(end.x / cellSize)),
+                    static_cast<int>(std::floor(end.y / cellSize)),
+                    maxLen,
+                    map,
+                    mode,
+                    algorithm,
+                    static_cast<uint8_t>(agentSize)};
+        }
+
+        // Assigns the cached path of the key if none of its cells became solid since - counts hits and misses
+        bool getCachedPath(const PathCacheKey& key, std::vector<Point>& path)
+        {
+            const auto* entry = cachedPaths.find(key);
+            if (entry == nullptr || getIsPathBlocked(*entry))
             {
+                ++cachedPaths.misses;
                 return false;
             }
+            ++cachedPaths.hits;
+            path.assign(entry->path.begin(), entry->path.end());
+            return true;
+        }
 
-            const PathFindingHeuristicFunc hFunc = PATH_HEURISTICS[(int)mode];
-            const PathFindingMoveCostFunc mFunc = MOVE_COST[(int)mode];
-            const auto& movement = MOVEMENTS[(int)mode];
-
-            frontier.emplace(start, 0.0F, hFunc(start, end), UINT16_MAX, 0); // Initial node
-            while (!frontier.empty() && iterations < MAGIQUE_MAX_PATH_SEARCH_CAPACITY)
+        // Caches the found path and the regions it passes through - all cells covered by the agent
+        void cachePath(const PathCacheKey& key, const std::vector<Point>& path)
+        {
+            auto& entry = cachedPaths.insert(key);
+            entry.path.assign(path.begin(), path.end());
+            entry.regions.clear();
+            const auto addCell = [&](const float x, const float y)
             {
-                nodePool[iterations] = frontier.top();
-                auto& current = nodePool[iterations];
-                if (current.position == end) [[unlikely]]
+                const auto block = PathFindingGrid::GetBlock(x, y);
+                PathCacheRegion* region = nullptr;
+                for (auto& curr : entry.regions)
                 {
-                    constructPath(current, path);
-                    return true;
+                    if (curr.block == block)
+                        region = &curr;
                 }
-                if (current.stepCount >= maxPathLen) [[unlikely]]
+                if (region == nullptr)
                 {
-                    return false;
+                    entry.regions.push_back({block, {}});
+                    region = &entry.regions.back();
                 }
-                frontier.pop();
-                visited.setValue(current.position.x, current.position.y, true);
-                for (const auto& dir : movement)
+                region->cells.set(PathFindingGrid::GetBlockIndex(x, y));
+            };
+            for (const auto& point : path)
+            {
+                for (int i = 0; i < key.agentSize; ++i)
                 {
-                    Point const newPos = {current.position.x + dir.x, current.position.y + dir.y};
-                    const auto newPosCoX = newPos.x * cellSize;
-                    const auto newPosCoY = newPos.y * cellSize;
+                    for (int j = 0; j < key.agentSize; ++j)
+                        addCell(point.x + static_cast<float>(j * cellSize), point.y + static_cast<float>(i * cellSize));
+                }
+            }
+        }
 
-                    // Is not visited and not solid
-                    if (visited.getValue(newPos.x, newPos.y) ||
-                        IsCellSolid(newPosCoX, newPosCoY, staticGrid, dynamicGrid)) [[unlikely]]
-                    {
-                        continue;
-                    }
+        // Returns the jump table of the map - builds it if the static grid changed - nullptr if the map is too big
+        JumpTable* getJumpTable(const MapID map)
+        {
+            const auto bounds = global::STATIC_COLL_DATA.getMapBounds(map);
+            if (bounds.width <= 0 || bounds.height <= 0)
+                return nullptr;
 
-                    const auto val = openCost.getValue(newPos.x, newPos.y);
-                    const float gCost = mFunc(dir) + current.gCost;
-                    const auto hCost = hFunc(newPos, end);
-                    const auto newPathLen = static_cast<uint16_t>(current.stepCount + 1U);
-                    const auto newFCost = hCost + gCost;
+            const int x = static_cast<int>(std::floor(bounds.x / cellSize));
+            const int y = static_cast<int>(std::floor(bounds.y / cellSize));
+            const int width = static_cast<int>(std::ceil((bounds.x + bounds.width) / cellSize)) - x;
+            const int height = static_cast<int>(std::ceil((bounds.y + bounds.height) / cellSize)) - y;
+            if (static_cast<int64_t>(width) * height > JumpTable::MAX_CELLS || width > JumpTable::DIST_MASK ||
+                height > JumpTable::DIST_MASK)
+                return nullptr;
 
-                    if (val != 0.0F && newFCost >= val)
-                    {
-                        continue;
-                    }
-                    frontier.push({newPos, gCost, newFCost, iterations, newPathLen});
-                    openCost.setValue(newPos.x, newPos.y, newFCost);
-                }
-                iterations++;
+            auto& table = mapsJumpTables[map];
+            if (table.isDirty || table.x != x || table.y != y || table.width != width || table.height != height)
+            {
+                buildJumpTable(table, mapsStaticGrids[map], x, y, width, height);
             }
-            return false;
+            return &table;
         }
 
     private:
-        void constructPath(const GridNode& current, std::vector<Point>& path) const
+        [[nodiscard]] bool getIsPathBlocked(const CachedPath& entry)
         {
-            const GridNode* curr = &current;
-            while (curr->parent != UINT16_MAX)
+            const auto& staticGrid = mapsStaticGrids[entry.key.map];
+            const auto& dynamicGrid = mapsDynamicGrids[entry.key.map];
+            for (const auto& [block, cells] : entry.regions)
             {
-                const Point p = {(curr->position.x * cellSize) + (cellSize / 2.0F),
-                                 (curr->position.y * cellSize) + (cellSize / 2.0F)};
-                path.push_back(p);
-                curr = &nodePool[curr->parent];
+                const auto staticIt = staticGrid.visited.find(block);
+                if (staticIt != staticGrid.visited.end() && (staticIt->second & cells).any())
+                    return true;
+                const auto dynamicIt = dynamicGrid.visited.find(block);
+                if (dynamicIt != dynamicGrid.visited.end() && (dynamicIt->second & cells).any())
+                    return true;
+            }
+            return false;
+        }
+
+        // Computes each entry from the next cell in the direction - so the cells are visited against it
+        static void buildJumpTable(JumpTable& table, const PathFindingGrid& grid, const int x, const int y,
+                                   const int width, const int height)
+        {
+            table.x = x;
+            table.y = y;
+            table.width = width;
+            table.height = height;
+            table.entries.resize(width * height * 4);
+            for (int dir = 0; dir < 4; ++dir)
+            {
+                buildJumpEntries(table, grid, dir, 0, height, 0, width);
+            }
+            table.isDirty = false;
+        }
+
+        // Recomputes the entries the changed cells (inclusive) depend on - horizontal entries only depend on their row
+        // and the rows next to it, vertical ones on their column and the columns next to it
+        static void updateJumpTable(JumpTable& table, const PathFindingGrid& grid, const int x1, const int y1,
+                                    const int x2, const int y2)
+        {
+            const int rowStart = std::max(0, y1 - 1 - table.y);
+            const int rowEnd = std::min(table.height, y2 + 2 - table.y);
+            const int colStart = std::max(0, x1 - 1 - table.x);
+            const int colEnd = std::min(table.width, x2 + 2 - table.x);
+            if (rowStart < rowEnd)
+            {
+                buildJumpEntries(table, grid, 1, rowStart, rowEnd, 0, table.width); // East
+                buildJumpEntries(table, grid, 3, rowStart, rowEnd, 0, table.width); // West
+            }
+            if (colStart < colEnd)
+            {
+                buildJumpEntries(table, grid, 0, 0, table.height, colStart, colEnd); // North
+                buildJumpEntries(table, grid, 2, 0, table.height, colStart, colEnd); // South
             }
         }
+
+        // Computes the entries of the direction for the rows and columns (relative to the table - end exclusive)
+        static void buildJumpEntries(JumpTable& table, const PathFindingGrid& grid, const int dir, const int rowStart,
+                                     const int rowEnd, const int colStart, const int colEnd)
+        {
+            const auto isBlocked = [&](const int cellX, const int cellY)
+            { return grid.getIsMarked(static_cast<float>(cellX * cellSize), static_cast<float>(cellY * cellSize)); };
+            const int dx = JumpTable::DIRECTIONS[dir][0];
+            const int dy = JumpTable::DIRECTIONS[dir][1];
+            const int width = table.width;
+            for (int i = rowStart; i < rowEnd; ++i)
+            {
+                const int row = dy > 0 ? rowEnd - 1 - (i - rowStart) : i;
+                for (int j = colStart; j < colEnd; ++j)
+                {
+                    const int col = dx > 0 ? colEnd - 1 - (j - colStart) : j;
+                    const int cellX = table.x + col;
+                    const int cellY = table.y + row;
+                    const int nextX = cellX + dx;
+                    const int nextY = cellY + dy;
+                    uint16_t entry;
+                    if (!table.contains(nextX, nextY))
+                        entry = JumpTable::EDGE;
+                    else if (isBlocked(nextX, nextY))
+                        entry = JumpTable::WALL;
+                    else if ((isBlocked(nextX + dy, nextY + dx) && !isBlocked(nextX + dx + dy, nextY + dy + dx)) ||
+                             (isBlocked(nextX - dy, nextY - dx) && !isBlocked(nextX + dx - dy, nextY + dy - dx)))
+                        entry = JumpTable::JUMP_POINT | 1; // Next cell has a forced neighbor
+                    else
+                        entry = table.get(nextX, nextY, dir) + 1; // Same kind - one further
+                    table.entries[(row * width + col) * 4 + dir] = entry;
+                }
+            }
+        }
+
     };
 
     namespace global
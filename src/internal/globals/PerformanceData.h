@@ -6,6 +6,9 @@
 #include "external/raylib-compat/rlgl_compat.h"
 
 #include "internal/utils/OSUtil.h"
+#include "internal/globals/EngineData.h"
+#include "internal/globals/DynamicCollisionData.h"
+#include "internal/globals/PathFindingData.h"
 #if defined(MAGIQUE_LAN) || defined(MAGIQUE_STEAM)
 #include "internal/globals/MultiplayerData.h"
 #endif
@@ -30,7 +33,7 @@ namespace magique
         uint32_t drawTickTime = 0;
         int tickCounter = 0;
         int updateDelayTicks = 15;
-        PerformanceBlock blocks[7]{}; // 7 blocks for FPS, CPU, GPU, DrawCalls, Upload, Download, Ping
+        PerformanceBlock blocks[9]{}; // FPS, CPU, GPU, DrawCalls, Upload, Download, Ping, CellSize, PathCache
 
 #if MAGIQUE_PROFILING == 1
         vector<uint32_t> logicTimes;
@@ -167,6 +170,34 @@ namespace magique
                 block++;
                 blocks[block].width = 0;
             }
+
+            block++;
+            if (global::ENGINE_CONFIG.autoTuneCellSize) // Show the chosen entity grid cell size of the camera map
+            {
+                const auto map = static_cast<int>(global::ENGINE_DATA.cameraMap);
+                snprintf(blocks[block].text, 32, "Cell: %d", static_cast<int>(global::DY_COLL_DATA.cellSizes[map]));
+                blocks[block].width = MeasureTextEx(font, blocks[block].text, fs, 1.0F).x * 1.1F;
+            }
+            else
+            {
+                blocks[block].width = 0;
+            }
+
+            block++;
+            auto& pathCache = global::PATH_DATA.cachedPaths;
+            const auto lookups = pathCache.hits + pathCache.misses;
+            if (pathCache.capacity > 0 && lookups > 0) // Hit rate since the last update
+            {
+                const auto hitRate = static_cast<int>(pathCache.hits * 100ULL / lookups);
+                snprintf(blocks[block].text, sizeof(blocks[block].text), "Path Hits: %d%%", hitRate);
+                blocks[block].width = MeasureTextEx(font, blocks[block].text, fs, 1.0F).x * 1.1F;
+                pathCache.hits = 0;
+                pathCache.misses = 0;
+            }
+            else
+            {
+                blocks[block].width = 0;
+            }
             tickCounter = 0;
 
 #if MAGIQUE_PROFILING == 1
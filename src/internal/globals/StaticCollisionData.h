@@ -7,6 +7,7 @@
 #include "internal/datastructures/VectorType.h"
 #include "internal/datastructures/HashTypes.h"
 #include "internal/datastructures/MultiResolutionGrid.h"
+#include "internal/datastructures/BakedHashGrid.h"
 
 //-----------------------------------------------
 // Static Collision Data
@@ -33,9 +34,10 @@ namespace magique
         EntityType entityType; // entity type - for the script
     };
 
-    using ColliderHashGrid = SingleResolutionHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 64>; // power of two
-    using TileHashGrid = SingleResolutionHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 32>;      // power of two
-    using GroupHashGrid = SingleResolutionHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 32>;     // power of two
+    // Static content is baked into a packed layout after loading - later changes go into a small delta layer
+    using ColliderHashGrid = BakedHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 64>; // power of two
+    using TileHashGrid = BakedHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 32>;      // power of two
+    using GroupHashGrid = BakedHashGrid<StaticID, MAGIQUE_MAX_ENTITIES_CELL, 32>;     // power of two
 
     using StaticPairCollector = AlignedVec<StaticPair>[MAGIQUE_WORKER_THREADS + 1];
     using ColliderCollector = AlignedVec<StaticID>[MAGIQUE_WORKER_THREADS + 1];
@@ -70,6 +72,26 @@ namespace magique
             collider.p2 = 0;
             freeList.push_back(objectNum);
         }
+
+        // Appends the colliders as a contiguous range (skips the free list) - returns the index of the first one
+        uint32_t insertRange(const char* colliderData, const int count)
+        {
+            const auto first = colliders.size();
+            colliders.resize(first + count);
+            memcpy(colliders.data() + first, colliderData, count * sizeof(StaticCollider)); // Count can be 0
+            return first;
+        }
+
+        // Removes the collider but keeps its index reserved - allows to load it again under the same index
+        void disable(const uint32_t objectNum) { colliders[objectNum] = {0, 0, 0, 0}; }
+
+        void enable(const uint32_t objectNum, const float x, const float y, const float width, const float height)
+        {
+            colliders[objectNum] = {x, y, width, height};
+        }
+
+        // Frees the index of a disabled collider
+        void release(const uint32_t objectNum) { freeList.push_back(objectNum); }
     };
 
     struct StaticIDHelper final // Helps to get individual parts from the static ids
@@ -101,17 +123,179 @@ namespace magique
             int groupId = -1;
         };
 
+        struct TileChunkLink final // Identifies a chunk across maps
+        {
+            MapID map{};
+            int chunk = -1; // -1 if none
+        };
+
+        struct TileChunkInfo final // Saves the ids of a tile chunk - they stay reserved while the chunk is unloaded
+        {
+            vector<uint32_t> objectIds;
+            TileChunkLink prev;        // Next more recently used loaded chunk of a streamed map
+            TileChunkLink next;        // Next less recently used loaded chunk of a streamed map
+            uint32_t lastUsedTick = 0; // Tick the chunk was last close to an actor
+            bool isLoaded = true;
+        };
+
+        struct TileColliderSlot final // Position of a tile collider in the loaded ids of its map and of its chunk
+        {
+            uint32_t mapIdx = 0;
+            uint32_t chunkIdx = 0;
+        };
+
         // Maps + which colliders where loaded for each map (can be many for each map)
         HashMap<MapID, vector<TileObjectInfo>> tileObjectMap;
-        // Tiles + what colliders where loaded per map
+        // Tiles + what colliders where loaded per map (only loaded chunks)
         HashMap<MapID, vector<uint32_t>> tilesCollisionMap;
+        // Tile chunks of each map - chunk index is chunkY * chunksX + chunkX
+        HashMap<MapID, vector<TileChunkInfo>> tileChunkMap;
         // What groups where loaded for ach map (can be many for each map)
         HashMap<MapID, vector<ManualGroupInfo>> groupMap;
+        // Loaded chunks of streamed maps from most to least recently used - unloading takes from the tail
+        TileChunkLink lruHead;
+        TileChunkLink lruTail;
+        // Slot of each tile collider - indexed by object num - allows to remove them in constant time
+        vector<TileColliderSlot> tileSlots;
+
+        TileChunkInfo& getChunk(const TileChunkLink& link) { return tileChunkMap[link.map][link.chunk]; }
+
+        // Adds the tile collider to the loaded ids of the map and to the ids of the chunk
+        void addTileCollider(const MapID map, const int chunk, const uint32_t objectNum)
+        {
+            if (tileSlots.size() <= static_cast<int>(objectNum))
+                tileSlots.resize(objectNum + 1);
+            auto& mapIds = tilesCollisionMap[map];
+            auto& chunkIds = tileChunkMap[map][chunk].objectIds;
+            tileSlots[objectNum] = {static_cast<uint32_t>(mapIds.size()), static_cast<uint32_t>(chunkIds.size())};
+            mapIds.push_back(objectNum);
+            chunkIds.push_back(objectNum);
+        }
+
+        // Removes the tile collider from the loaded ids of the map - the last id takes its place
+        void unloadTileCollider(const MapID map, const uint32_t objectNum)
+        {
+            auto& mapIds = tilesCollisionMap[map];
+            const auto idx = tileSlots[objectNum].mapIdx;
+            mapIds[idx] = mapIds.back();
+            tileSlots[mapIds[idx]].mapIdx = idx;
+            mapIds.pop_back();
+        }
+
+        // Removes the tile collider from the loaded ids of the map and from the ids of the chunk
+        void removeTileCollider(const MapID map, const int chunk, const uint32_t objectNum)
+        {
+            unloadTileCollider(map, objectNum);
+            auto& chunkIds = tileChunkMap[map][chunk].objectIds;
+            const auto idx = tileSlots[objectNum].chunkIdx;
+            chunkIds[idx] = chunkIds.back();
+            tileSlots[chunkIds[idx]].chunkIdx = idx;
+            chunkIds.pop_back();
+        }
+
+        // Moves the chunk to the front of the LRU list - inserts it if it's not in the list
+        void touchChunk(const MapID map, const int chunk)
+        {
+            if (lruHead.map == map && lruHead.chunk == chunk)
+                return;
+            auto& info = tileChunkMap[map][chunk];
+            if (info.prev.chunk != -1) // Only the head has no previous chunk
+                unlinkChunk(map, chunk);
+            info.next = lruHead;
+            info.prev = {};
+            if (lruHead.chunk != -1)
+                getChunk(lruHead).prev = {map, chunk};
+            else
+                lruTail = {map, chunk};
+            lruHead = {map, chunk};
+        }
+
+        // Removes the chunk from the LRU list
+        void unlinkChunk(const MapID map, const int chunk)
+        {
+            auto& info = tileChunkMap[map][chunk];
+            if (info.prev.chunk != -1)
+                getChunk(info.prev).next = info.next;
+            else
+                lruHead = info.next;
+            if (info.next.chunk != -1)
+                getChunk(info.next).prev = info.prev;
+            else
+                lruTail = info.prev;
+            info.prev = {};
+            info.next = {};
+        }
+    };
+
+    struct TileCollisionLayer final // Full solid tiles are merged into rectangles - allows incremental updates
+    {
+        static constexpr uint32_t NO_COLLIDER = UINT32_MAX;
+        vector<uint16_t> tiles;     // Tile data of the layer - to build chunks again after they were unloaded
+        vector<int16_t> cells;      // Tile class of each full solid tile - -1 if empty or a custom collision rect
+        vector<uint32_t> colliders; // Object num of the collider covering each tile - NO_COLLIDER if none
+        int layer = 0;              // The tilemap layer index
+    };
+
+    struct TileCollisionMask final // Tile collision state of a loaded map
+    {
+        vector<TileCollisionLayer> layers;
+        vector<uint8_t> mergeScratch; // Marks merged or covered cells while merging
+        vector<uint8_t> regionFlags;  // Marks the tiles of the regions that are merged again on an update
+        vector<int> region;           // Tiles of the regions that are merged again on an update
+        vector<uint32_t> reuseIds;    // Reserved ids of the chunk that is loaded
+        int reuseNext = 0;            // Next id to reuse
+        int width = 0;                // Size in tiles
+        int height = 0;
+        int chunkSize = 0; // Size of a chunk in tiles - covers the whole map if not streamed
+        int chunksX = 0;   // Amount of chunks
+        int chunksY = 0;
+        float tileSize = 0;      // Scaled size of a tile
+        bool isStreamed = false; // If chunks are loaded and unloaded around actors
+
+        [[nodiscard]] int getChunk(const int tileX, const int tileY) const
+        {
+            return tileY / chunkSize * chunksX + tileX / chunkSize;
+        }
+
+        TileCollisionLayer* getLayer(const int layer)
+        {
+            for (auto& tileLayer : layers)
+            {
+                if (tileLayer.layer == layer)
+                    return &tileLayer;
+            }
+            return nullptr;
+        }
+    };
+
+    // Header of pre-baked tile collision (see SetTileCollisionBake()) - all data is stored raw and unaligned:
+    //      - per layer: layer index (int), tiles (uint16), cells (int16), colliders (uint32 - index of the collider)
+    //      - colliders (StaticCollider)
+    //      - tile grid: cell keys (CellID), offsets (uint32 - one more than keys), values (StaticID - with the index)
+    //      - pathfinding grid: blocks of (VisitedCellID, bitset)
+    struct BakedTileCollisionHeader final
+    {
+        static constexpr uint32_t MAGIC = 0x4354514D; // "MQTC"
+        static constexpr int VERSION = 1;
+
+        uint32_t magic = MAGIC;
+        int version = VERSION;
+        int width = 0; // Size in tiles
+        int height = 0;
+        float tileSize = 0; // Scaled size of a tile
+        int layerCount = 0;
+        int colliderCount = 0;
+        int cellKeyCount = 0;
+        int valueCount = 0;
+        int pathBlockCount = 0;
+        int pathCellSize = 0;  // Has to match the pathfinding grid of the engine
+        int pathBlockSize = 0; // Bytes of a single block
     };
 
     struct StaticCollisionData final
     {
-        Rectangle worldBounds{}; // World bounds
+        Rectangle worldBounds{};              // World bounds
+        HashMap<MapID, Rectangle> mapBounds; // Size of the loaded tilemaps - allows dense grids
 
         //----------------- COLLISION SYSTEM  -----------------//
         StaticPairCollector pairCollector;     // Collects pairs for all types entity + (world, object, tiles, custom)
@@ -132,10 +316,53 @@ namespace magique
         const TileSet* tileSet = nullptr; // Only use for equality checks
         float tileSetScale = 1.0f;
         HashMap<uint16_t, TileInfo> markedTilesMap; // which tiles are marked and their tile info
+        HashMap<MapID, TileCollisionMask> tileMasks; // Tile collision state per map - to update single tiles
+
+        //----------------- STREAMING -----------------//
+        static constexpr int CHUNK_TILES = 64; // Size of a streamed chunk in tiles
+        static constexpr int COLLIDER_BYTES = sizeof(StaticCollider) + 2 * sizeof(StaticID); // Estimated per collider
+        bool streamTileChunks = false; // Applies to maps added afterward
+        int streamingBudget = 0;       // Bytes the colliders of loaded chunks can use before unused ones are unloaded
+        int streamedMaps = 0;          // Maps whose tile collision is streamed
+        int loadedChunkBytes = 0;      // Bytes of the colliders in loaded chunks of streamed maps
+
+        // Bakes all grids whose delta layer got too big - called once per tick before the grids are queried
+        void rebakeGrids()
+        {
+            const auto rebake = [](auto& holder)
+            {
+                for (auto& grid : holder.elements)
+                {
+                    if (grid.needsBake()) [[unlikely]]
+                        grid.bake();
+                }
+            };
+            rebake(mapObjectGrids);
+            rebake(mapTileGrids);
+            rebake(mapGroupGrids);
+        }
 
         [[nodiscard]] bool getIsWorldBoundSet() const { return worldBounds.width != 0 && worldBounds.height != 0; }
+
+        // Returns the known bounds of the map (tilemap size or world bounds) - an empty rect if unknown
+        [[nodiscard]] Rectangle getMapBounds(const MapID map) const
+        {
+            const auto it = mapBounds.find(map);
+            if (it != mapBounds.end())
+            {
+                return it->second;
+            }
+            return worldBounds;
+        }
     };
 
+    // Loads the tile chunks around actors and unloads the least recently used ones over the memory budget
+    void StreamTileCollisionChunks();
+
+    // Bakes the collision of the given tile layers (as loaded by AddTileCollisions()) into the given buffer
+    void BakeTileCollisions(vector<char>& out, const TileMap& tileMap, const TileSet& tileSet, float scale,
+                            const vector<int>& layers);
+
     namespace global
     {
         inline StaticCollisionData STATIC_COLL_DATA{};
@@ -11,12 +11,18 @@
 //    -> uses custom cache friendly hashgrid (with third-party hashmap)
 //    -> first checks if inside camera bounds otherwise if close to any actor
 // 2. Multithreaded broad phase (scalable to any amount)
-//    -> iterate all hash grid cells
+//    -> iterate all hash grid cells of each level (1x, 4x and 16x cell size - entities go into the fitting level)
+//    -> entities of the coarse levels additionally query the finer levels
 //    -> Collision is checked with SIMD enabled primitive functions
 //    -> if colliding collision pair is stored
 //    -> uses separate pair collectors to prevent false sharing
-// 3. Single threaded pass over all pairs invoking event methods
-//    -> Uses custom Hashset with uint64_t key to mark checked pairs
+// 3. Single threaded pass over continuous entities (CollisionC::continuous)
+//    -> queries the grid with the bounding box swept from the start of the tick
+//    -> if not colliding at the end the (relative) movement is swept -> time of impact is saved in the info
+// 4. Single threaded pass over all pairs invoking event methods
+//    -> Uses custom Hashset with uint64_t key to mark checked pairs (order independent)
+//    -> the marked pairs are kept until the next tick to detect contact enter, stay and exit
+//    -> optionally pairs with thread safe scripts are colored into conflict free batches and dispatched in parallel
 //
 // Note: Can still be optimized -> Using a AABB tree (or bounding volume hierarchy) avoids the hashset and will probably
 //       have faster lookups times but MUCH more complex to manage and move objects efficiently
@@ -26,7 +32,7 @@
 // Problems:
 // - Sticky corners
 // - Double collisions
-// - Tunneling
+// - Tunneling (solved with opt-in continuous collision for fast entities)
 
 // Ouickfixes:
 // - Detect corner collisions and skip  => contributes to tunneling
@@ -61,7 +67,10 @@ namespace magique
 {
     void CheckCollision(const PositionC&, const CollisionC&, const PositionC&, const CollisionC&, CollisionInfo& i);
     void HandleCollisionPairs();
+    void HandleContactExits();
+    void HandleParallelPairs();
     void CheckHashGridCells(float beginPercent, float endPercent, int thread);
+    void CheckContinuousEntities();
 
     //----------------- SYSTEM -----------------//
 
@@ -86,66 +95,272 @@ namespace magique
         {
             CheckHashGridCells(0.0F, 1.0F, COL_WORK_PARTS - 1);
         }
+        if (!global::DY_COLL_DATA.sweepStarts.empty()) [[unlikely]]
+        {
+            CheckContinuousEntities();
+        }
         HandleCollisionPairs();
     }
 
     //----------------- IMPLEMENTATION -----------------//
 
+    template <typename Grid>
+    void CheckGridBlocks(const Grid& hashGrid, const float beginP, const float endP, const int thread,
+                         vector<PairInfo>& pairs)
+    {
+        const auto& group = internal::POSITION_GROUP;
+        const int size = hashGrid.getCellCount();
+        int startIdx = static_cast<int>(beginP * static_cast<float>(size));
+        int endIdx = static_cast<int>(endP * static_cast<float>(size));
+        if (size < COL_WORK_PARTS)
+        {
+            // If cant be split into parts let main thread do all of it alone
+            if (thread != COL_WORK_PARTS - 1)
+                return;
+            startIdx = 0;
+            endIdx = size;
+        }
+        const auto* start = hashGrid.dataBlocks.begin() + startIdx;
+        const auto* end = hashGrid.dataBlocks.begin() + endIdx;
+        for (const auto* it = start; it != end; ++it)
+        {
+            const auto& block = *it;
+            const auto* dStart = block.data;
+            const auto* dEnd = block.data + block.size;
+            for (const auto* dIt1 = dStart; dIt1 != dEnd; ++dIt1)
+            {
+                const auto first = *dIt1;
+                auto [posA, colA] = group.get<const PositionC, CollisionC>(first);
+                for (const auto* dIt2 = dIt1 + 1; dIt2 != dEnd; ++dIt2)
+                {
+                    const auto second = *dIt2;
+                    auto [posB, colB] = group.get<const PositionC, CollisionC>(second);
+                    if (!colA.detects(colB) && !colB.detects(colA))
+                    {
+                        continue; // Not checking for each other
+                    }
+                    CollisionInfo info{};
+                    CheckCollisionEntities(posA, colA, posB, colB, info);
+                    if (info.isColliding())
+                    {
+                        pairs.push_back(PairInfo{info, first, second});
+                    }
+                }
+            }
+        }
+    }
+
+    // Checks the elements of the coarse levels against all elements in the finer levels
+    inline void CheckCoarseElements(const EntityHashGrid& hashGrid, const float beginP, const float endP,
+                                    const int thread, vector<PairInfo>& pairs)
+    {
+        const auto& group = internal::POSITION_GROUP;
+        auto& query = global::DY_COLL_DATA.queryCollectors[thread].vec;
+        const auto& coarse = hashGrid.coarseElements;
+        const int size = static_cast<int>(coarse.size());
+        int startIdx = static_cast<int>(beginP * static_cast<float>(size));
+        int endIdx = static_cast<int>(endP * static_cast<float>(size));
+        if (size < COL_WORK_PARTS) // Coarse elements are usually few - main thread does all
+        {
+            if (thread != COL_WORK_PARTS - 1)
+                return;
+            startIdx = 0;
+            endIdx = size;
+        }
+        for (int i = startIdx; i < endIdx; ++i)
+        {
+            const auto first = coarse[i];
+            auto [posA, colA] = group.get<const PositionC, CollisionC>(first);
+            const auto bb = GetEntityBoundingBox(posA, colA);
+            hashGrid.queryFiner(query, bb.x, bb.y, bb.width, bb.height);
+            for (const auto second : query)
+            {
+                auto [posB, colB] = group.get<const PositionC, CollisionC>(second);
+                if (!colA.detects(colB) && !colB.detects(colA))
+                {
+                    continue;
+                }
+                CollisionInfo info{};
+                CheckCollisionEntities(posA, colA, posB, colB, info);
+                if (info.isColliding())
+                {
+                    pairs.push_back(PairInfo{info, first, second});
+                }
+            }
+            query.clear();
+        }
+    }
+
     inline void CheckHashGridCells(const float beginP, const float endP, const int thread)
     {
         const auto& data = global::ENGINE_DATA;
         auto& dynamic = global::DY_COLL_DATA;
-        const auto& group = internal::POSITION_GROUP;
 
         auto& pairs = dynamic.collisionPairs[thread].vec;
         for (const auto loadedMap : data.loadedMaps)
         {
             const auto& hashGrid = dynamic.mapEntityGrids[loadedMap];
-            const int size = static_cast<int>(hashGrid.cellMap.size());
-            if (size < COL_WORK_PARTS && thread != COL_WORK_PARTS - 1)
+            hashGrid.forEachLevel([&](const auto& level) { CheckGridBlocks(level, beginP, endP, thread, pairs); });
+            if (!hashGrid.coarseElements.empty()) [[unlikely]]
+            {
+                CheckCoarseElements(hashGrid, beginP, endP, thread, pairs);
+            }
+        }
+    }
+
+    inline void CheckContinuousEntities()
+    {
+        const auto& group = internal::POSITION_GROUP;
+        auto& dynamic = global::DY_COLL_DATA;
+
+        const auto& sweepStarts = dynamic.sweepStarts;
+        auto& query = dynamic.sweepQuery;
+        auto& pairs = dynamic.collisionPairs[COL_WORK_PARTS - 1].vec; // Runs on the main thread
+        for (const auto& [first, start] : sweepStarts)
+        {
+            if (!group.contains(first)) [[unlikely]] // Could be destroyed during the tick
             {
-                // If cant be split into parts let main thread do it alone
                 continue;
             }
+            auto [posA, colA] = group.get<const PositionC, CollisionC>(first);
+            const Point moveA = {posA.x - start.x, posA.y - start.y};
+            if ((moveA.x == 0.0F && moveA.y == 0.0F) || !dynamic.mapEntityGrids.contains(posA.map))
+            {
+                continue; // Not moved - already handled by the normal pass
+            }
 
-            const int startIdx = static_cast<int>(beginP * static_cast<float>(size));
-            const int endIdx = static_cast<int>(endP * static_cast<float>(size));
-            const auto* start = hashGrid.dataBlocks.begin() + startIdx;
-            const auto* end = hashGrid.dataBlocks.begin() + endIdx;
-            for (const auto* it = start; it != end; ++it)
+            const auto bbA = GetEntityBoundingBox(posA, colA);
+            const auto swept = GetSweptBoundingBox(bbA, moveA);
+            dynamic.mapEntityGrids[posA.map].query(query, swept.x, swept.y, swept.width, swept.height);
+            for (const auto second : query)
             {
-                const auto& block = *it;
-                const auto* dStart = block.data;
-                const auto* dEnd = block.data + block.size;
-                for (const auto* dIt1 = dStart; dIt1 != dEnd; ++dIt1)
+                if (second == first || !group.contains(second)) [[unlikely]]
+                {
+                    continue;
+                }
+                auto [posB, colB] = group.get<const PositionC, CollisionC>(second);
+                if (posB.map != posA.map || (!colA.detects(colB) && !colB.detects(colA)))
+                {
+                    continue;
+                }
+                CollisionInfo info{};
+                CheckCollisionEntities(posA, colA, posB, colB, info);
+                if (!info.isColliding()) // Only sweep if it's not colliding at the end
                 {
-                    const auto first = *dIt1;
-                    auto [posA, colA] = group.get<const PositionC, CollisionC>(first);
-                    for (const auto* dIt2 = dIt1 + 1; dIt2 != dEnd; ++dIt2)
+                    auto bbB = GetEntityBoundingBox(posB, colB);
+                    Point moveB{};
+                    if (colB.continuous) // Sweep the relative movement if both move continuous
                     {
-                        const auto second = *dIt2;
-                        auto [posB, colB] = group.get<const PositionC, CollisionC>(second);
-                        if (!colA.detects(colB) && !colB.detects(colA))
+                        const auto it = sweepStarts.find(second);
+                        if (it != sweepStarts.end())
                         {
-                            continue; // Not checking for each other
-                        }
-                        CollisionInfo info{};
-                        CheckCollisionEntities(posA, colA, posB, colB, info);
-                        if (info.isColliding())
-                        {
-                            pairs.push_back(PairInfo{info, first, second});
+                            moveB = {posB.x - it->second.x, posB.y - it->second.y};
+                            bbB.x -= moveB.x;
+                            bbB.y -= moveB.y;
                         }
                     }
+                    const float dx = moveA.x - moveB.x;
+                    const float dy = moveA.y - moveB.y;
+                    SweptRectToRect(bbA.x - moveA.x, bbA.y - moveA.y, bbA.width, bbA.height, dx, dy, bbB.x, bbB.y,
+                                    bbB.width, bbB.height, info);
+                    info.collisionPoint.x += moveB.x * info.timeOfImpact; // Back into world space
+                    info.collisionPoint.y += moveB.y * info.timeOfImpact;
+                }
+                if (info.isColliding())
+                {
+                    pairs.push_back(PairInfo{info, first, second});
                 }
             }
+            query.clear();
         }
     }
 
-    inline void HandleCollisionPairs()
+    // Invokes the events for one side of the pair - skips the per-tick events if the script doesn't receive them
+    inline void InvokePairEvents(EntityScript* script, const entt::entity self, const entt::entity other,
+                                 CollisionInfo& info, const bool isStay)
+    {
+        if (!script->receivesCollisionTicks())
+        {
+            EntityScript::AccumulateCollision(info); // Same as the default onDynamicCollision
+            if (!isStay)
+                InvokeEventDirect<onCollisionEnter>(script, self, other, info);
+            return;
+        }
+        InvokeEventDirect<onDynamicCollision>(script, self, other, info);
+        if (isStay)
+            InvokeEventDirect<onCollisionStay>(script, self, other, info);
+        else
+            InvokeEventDirect<onCollisionEnter>(script, self, other, info);
+    }
+
+    // Invokes all events for both entities of the pair - entities have to exist
+    inline void DispatchPair(PairInfo& pairInfo, const EntityType type1, const EntityType type2)
     {
         const auto& scriptVec = global::SCRIPT_DATA.scripts;
+        const auto& contacts = global::DY_COLL_DATA.contacts;
+#if MAGIQUE_CHECK_EXISTS_BEFORE_EVENT == 1
         const auto& group = internal::POSITION_GROUP;
+#endif
+
+        const auto e1 = pairInfo.e1;
+        const auto e2 = pairInfo.e2;
+        auto& col1 = GetComponent<CollisionC>(e1);
+        auto& col2 = GetComponent<CollisionC>(e2);
+
+        // Prepare second info - with the fresh data
+        auto secondInfo = pairInfo.info;
+        secondInfo.normalVector.x *= -1;
+        secondInfo.normalVector.y *= -1;
+
+        // Existing contact from last tick -> stay otherwise enter
+        const bool isStay = contacts.contains(DynamicCollisionData::GetPairKey(e1, e2));
+
+        if (col1.detects(col2))
+        {
+            // Already checked if both entities exist
+            InvokePairEvents(scriptVec[type1], e1, e2, pairInfo.info, isStay);
+
+            if (pairInfo.info.getIsAccumulated())
+            {
+                AccumulateInfo(col1, col2.shape, pairInfo.info);
+            }
+        }
+
+        if (col2.detects(col1))
+        {
+            // Call for second entity
+#if MAGIQUE_CHECK_EXISTS_BEFORE_EVENT == 1
+            bool invokeEvent = group.contains(e1) && group.contains(e2); // Needs recheck as first could delete
+            if (invokeEvent)
+#endif
+            {
+                InvokePairEvents(scriptVec[type2], e2, e1, secondInfo, isStay);
+            }
+
+            if (secondInfo.getIsAccumulated())
+            {
+                AccumulateInfo(col2, col2.shape, secondInfo);
+            }
+        }
+    }
+
+    // Returns true if all scripts that receive events for this pair are thread safe
+    inline bool IsPairThreadSafe(const PairInfo& pairInfo, const EntityType type1, const EntityType type2)
+    {
+        const auto& scriptVec = global::SCRIPT_DATA.scripts;
+        const auto& col1 = GetComponent<const CollisionC>(pairInfo.e1);
+        const auto& col2 = GetComponent<const CollisionC>(pairInfo.e2);
+        if (col1.detects(col2) && !scriptVec[type1]->isThreadSafe())
+        {
+            return false;
+        }
+        return !col2.detects(col1) || scriptVec[type2]->isThreadSafe();
+    }
+
+    inline void HandleCollisionPairs()
+    {
         auto& dynamic = global::DY_COLL_DATA;
+        const bool parallel = global::ENGINE_CONFIG.parallelCollisionEvents;
 
         auto& colPairs = dynamic.collisionPairs;
         auto& pairSet = dynamic.pairSet;
@@ -158,7 +373,8 @@ namespace magique
                 const auto e2 = pairInfo.e2;
 
                 // This cannot be avoided as duplicates are inserted into the hashgrid
-                if (dynamic.isMarked(e1, static_cast<uint32_t>(e2)))
+                // Smaller id first so the continuous pass can't duplicate pairs of the normal pass
+                if (dynamic.isMarked(std::min(e1, e2), static_cast<uint32_t>(std::max(e1, e2))))
                 {
                     continue;
                 }
@@ -170,45 +386,172 @@ namespace magique
                 {
                     continue;
                 }
-                auto& col1 = GetComponent<CollisionC>(e1);
-                auto& col2 = GetComponent<CollisionC>(e2);
 
-                // Prepare second info - with the fresh data
-                auto secondInfo = pairInfo.info;
-                secondInfo.normalVector.x *= -1;
-                secondInfo.normalVector.y *= -1;
-
-                if (col1.detects(col2))
+                if (parallel)
                 {
-                    // Already checked if both entities exist
-                    InvokeEventDirect<onDynamicCollision>(scriptVec[p1->type], e1, e2, pairInfo.info);
-
-                    if (pairInfo.info.getIsAccumulated())
+                    auto& entityBatches = dynamic.entityBatches;
+                    if (IsPairThreadSafe(pairInfo, p1->type, p2->type))
                     {
-                        AccumulateInfo(col1, col2.shape, pairInfo.info);
+                        dynamic.parallelPairs.push_back(pairInfo); // Deferred until an entity of it is used serially
+                        entityBatches.try_emplace(e1, static_cast<uint16_t>(0));
+                        entityBatches.try_emplace(e2, static_cast<uint16_t>(0));
+                        continue;
                     }
-                }
-
-                if (col2.detects(col1))
-                {
-                    // Call for second entity
-#if MAGIQUE_CHECK_EXISTS_BEFORE_EVENT == 1
-                    bool invokeEvent = group.contains(e1) && group.contains(e2); // Needs recheck as first could delete
-                    if (invokeEvent)
-#endif
-                        InvokeEventDirect<onDynamicCollision>(scriptVec[p2->type], e2, e1, secondInfo);
-
-                    if (secondInfo.getIsAccumulated())
+                    // Flushes all pending batches to keep the event order per entity
+                    // With many mixed pairs this degrades to a fully serial dispatch
+                    if (entityBatches.contains(e1) || entityBatches.contains(e2))
                     {
-                        AccumulateInfo(col2, col2.shape, secondInfo);
+                        HandleParallelPairs();
                     }
                 }
+                DispatchPair(pairInfo, p1->type, p2->type);
             }
             vec.clear();
         }
+        if (!dynamic.parallelPairs.empty())
+        {
+            HandleParallelPairs();
+        }
+        HandleContactExits();
         pairSet.clear();
     }
 
+    //----------------- PARALLEL -----------------//
+
+    inline void DispatchPairRange(const int start, const int end)
+    {
+        auto& batchedPairs = global::DY_COLL_DATA.batchedPairs;
+        for (int i = start; i < end; ++i)
+        {
+            auto& pairInfo = batchedPairs[i];
+            // Serial events dispatched before could have destroyed the entities
+            const auto p1 = TryGetComponent<const PositionC>(pairInfo.e1);
+            const auto p2 = TryGetComponent<const PositionC>(pairInfo.e2);
+            if (p1 == nullptr || p2 == nullptr) [[unlikely]]
+            {
+                continue;
+            }
+            DispatchPair(pairInfo, p1->type, p2->type);
+        }
+    }
+
+    // Colors the pairs greedily so no entity appears twice in a batch then dispatches batch by batch across workers
+    // The batch of a pair is always after the last batch of both its entities -> order per entity is the same
+    inline void HandleParallelPairs()
+    {
+        auto& dynamic = global::DY_COLL_DATA;
+        auto& pairs = dynamic.parallelPairs;
+        auto& batchedPairs = dynamic.batchedPairs;
+        auto& pairBatches = dynamic.pairBatches;
+        auto& offsets = dynamic.batchOffsets;
+        auto& entityBatches = dynamic.entityBatches;
+
+        // Assign the batches
+        const int pairCount = static_cast<int>(pairs.size());
+        int batchCount = 0;
+        pairBatches.resize(pairCount);
+        for (int i = 0; i < pairCount; ++i)
+        {
+            auto& batch1 = entityBatches[pairs[i].e1];
+            auto& batch2 = entityBatches[pairs[i].e2];
+            const uint16_t batch = std::max(batch1, batch2);
+            pairBatches[i] = batch;
+            batch1 = batch + 1;
+            batch2 = batch + 1;
+            batchCount = std::max(batchCount, batch + 1);
+        }
+
+        // Counting sort after the batch
+        offsets.resize(batchCount + 1, 0);
+        for (int i = 0; i < pairCount; ++i)
+        {
+            offsets[pairBatches[i] + 1]++;
+        }
+        for (int i = 0; i < batchCount; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        batchedPairs.resize(pairCount);
+        for (int i = 0; i < pairCount; ++i)
+        {
+            batchedPairs[offsets[pairBatches[i]]++] = pairs[i];
+        }
+        for (int i = batchCount; i > 0; --i) // Shift back to the batch starts
+        {
+            offsets[i] = offsets[i - 1];
+        }
+        offsets[0] = 0;
+
+        // Dispatch - batches have to be sequential
+        for (int b = 0; b < batchCount; ++b)
+        {
+            const int start = offsets[b];
+            const int end = offsets[b + 1];
+            const int size = end - start;
+            if (size < 64) // Not worth it
+            {
+                DispatchPairRange(start, end);
+                continue;
+            }
+            std::array<jobHandle, COL_WORK_PARTS> handles{};
+            const int partSize = size / COL_WORK_PARTS;
+            int partEnd = start;
+            for (int j = 0; j < COL_WORK_PARTS - 1; ++j)
+            {
+                const int partStart = partEnd;
+                partEnd = partStart + partSize;
+                handles[j] = AddJob(CreateExplicitJob(DispatchPairRange, partStart, partEnd));
+            }
+            DispatchPairRange(partEnd, end);
+            AwaitJobs(handles);
+        }
+
+        pairs.clear();
+        batchedPairs.clear();
+        pairBatches.clear();
+        offsets.clear();
+        entityBatches.clear();
+    }
+
+    // Invokes exit events for all contacts of the last tick that didn't collide this tick
+    // Afterward the pairs of this tick become the new contacts
+    inline void HandleContactExits()
+    {
+        const auto& scriptVec = global::SCRIPT_DATA.scripts;
+        auto& dynamic = global::DY_COLL_DATA;
+        auto& pairSet = dynamic.pairSet;
+        auto& contacts = dynamic.contacts;
+
+        const auto invokeExit = [&](const entt::entity self, const entt::entity other)
+        {
+            const auto* pos = TryGetComponent<const PositionC>(self);
+            const auto* col = TryGetComponent<const CollisionC>(self);
+            if (pos == nullptr || col == nullptr) // Destroyed entities get no event
+            {
+                return;
+            }
+            const auto* otherCol = TryGetComponent<const CollisionC>(other);
+            if (otherCol == nullptr || col->detects(*otherCol))
+            {
+                InvokeEventDirect<onCollisionExit>(scriptVec[pos->type], self, other);
+            }
+        };
+
+        for (const auto key : contacts)
+        {
+            if (pairSet.contains(key)) [[likely]]
+            {
+                continue; // Still colliding
+            }
+            const auto e1 = static_cast<entt::entity>(static_cast<uint32_t>(key >> 32));
+            const auto e2 = static_cast<entt::entity>(static_cast<uint32_t>(key));
+            invokeExit(e1, e2);
+            invokeExit(e2, e1);
+        }
+        contacts.clear();
+        contacts.swap(pairSet); // Keeps the memory of both sets
+    }
+
 } // namespace magique
 
 #endif //DYNAMIC_COLLISION_SYSTEM_H
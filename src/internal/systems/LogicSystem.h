@@ -44,12 +44,34 @@ namespace magique
         cVec.push_back(e);
         const auto bb = GetEntityBoundingBox(pos, col);
         grid.insert(e, bb.x, bb.y, bb.width, bb.height);
+        if (global::ENGINE_CONFIG.autoTuneCellSize) [[unlikely]]
+        {
+            auto& tuner = global::DY_COLL_DATA.tuners[static_cast<int>(pos.map)];
+            tuner.sizeSum += std::max(bb.width, bb.height);
+            tuner.entityCount++;
+        }
+        if (col.continuous) [[unlikely]] // Remember where the sweep starts
+        {
+            global::DY_COLL_DATA.sweepStarts[e] = {pos.x, pos.y};
+        }
         if (isPathSolid) [[unlikely]]
         {
             pathGrid.insert(bb.x, bb.y, bb.width, bb.height);
         }
     }
 
+    // Applies the cell size and chooses the dense backend if the map bounds are known and small enough
+    inline void PrepareEntityGrid(const MapID map, EntityHashGrid& grid)
+    {
+        const int cellSize = global::DY_COLL_DATA.cellSizes[static_cast<int>(map)];
+        if (grid.getCellSize() != cellSize) [[unlikely]]
+        {
+            grid.setCellSize(cellSize);
+        }
+        const auto [x, y, w, h] = global::STATIC_COLL_DATA.getMapBounds(map);
+        grid.setDenseBounds(x, y, w, h, DynamicCollisionData::MAX_DENSE_CELLS);
+    }
+
     inline void AssignCameraData(const entt::registry& registry)
     {
         const auto view = registry.view<const CameraC, const PositionC>();
@@ -132,8 +154,12 @@ namespace magique
             const auto& pos = group.get<const PositionC>(e);
             const auto map = pos.map;
 
-            loadedMaps[static_cast<int>(map)] = true;
             auto& hashGrid = dynamicData.mapEntityGrids[map];
+            if (!loadedMaps[static_cast<int>(map)]) [[unlikely]] // First entity of this map - grid is still empty
+            {
+                PrepareEntityGrid(map, hashGrid);
+            }
+            loadedMaps[static_cast<int>(map)] = true;
 
             if (loadedMaps[static_cast<int>(map)]) [[likely]] // entity is in any map where at least 1 actor is
             {
@@ -185,6 +211,20 @@ namespace magique
                 data.loadedMaps.push_back(static_cast<MapID>(i));
             }
         }
+
+        if (config.autoTuneCellSize) [[unlikely]] // Sample occupancy and apply the new size in the next tick
+        {
+            for (const auto map : data.loadedMaps)
+            {
+                auto& tuner = dynamicData.tuners[static_cast<int>(map)];
+                tuner.addTick(dynamicData.mapEntityGrids[map]);
+                const int cellSize = tuner.evaluate();
+                if (cellSize != 0)
+                {
+                    dynamicData.cellSizes[static_cast<int>(map)] = static_cast<uint16_t>(cellSize);
+                }
+            }
+        }
     }
 
     inline void LogicSystem(const entt::registry& registry)
@@ -208,6 +248,7 @@ namespace magique
         updateVec.clear();                  // Update entities
         collisionVec.clear();               // Collision entities
         dynamicData.mapEntityGrids.clear(); // Collision entity hashgrid
+        dynamicData.sweepStarts.clear();    // Continuous collision start positions
         pathData.mapsDynamicGrids.clear();  // Pathfinding solid entities hashgrid
 
         // Iterates all entities
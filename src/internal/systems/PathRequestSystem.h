@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: zlib-acknowledgement
+#ifndef MAGIQUE_PATH_REQUEST_SYSTEM_H
+#define MAGIQUE_PATH_REQUEST_SYSTEM_H
+
+//-----------------------------------------------
+// Path Request System
+//-----------------------------------------------
+// .....................................................................
+// Solves all path requests made since the last tick (see RequestPath())
+// 1. Single threaded pass resolving the grids and jump tables of each request and checking the path cache
+//    -> everything that might add a map or build a table happens here - the searches only read shared data
+// 2. Multithreaded search (scalable to any amount)
+//    -> requests are distributed with a stride so expensive searches spread evenly
+//    -> each thread uses its own PathSearch (lookup grids, open list and node pool)
+//    -> agents bigger than a cell are searched on the main thread after - their clearance is built on demand
+// 3. Single threaded pass caching the found paths and calling the callbacks in request order
+// .....................................................................
+
+namespace magique
+{
+    inline void SolvePathRequest(PathSearch* search, PathRequest& request, std::vector<Point>& result)
+    {
+        const auto& staticGrid = *request.staticGrid;
+        const auto& dynamicGrid = *request.dynamicGrid;
+        if (request.algorithm == PathAlgorithm::JUMP_POINT && request.mode == GridMode::STAR && request.agentSize == 1)
+        {
+            request.found = search->findJumpPath(result, request.start, request.end, staticGrid, dynamicGrid,
+                                                 request.table, request.maxLen);
+        }
+        else if (request.algorithm == PathAlgorithm::BIDIRECTIONAL && request.agentSize == 1)
+        {
+            request.found = search->findBidirectionalPath(result, request.start, request.end, staticGrid, dynamicGrid,
+                                                          request.maxLen, request.mode);
+        }
+        else
+        {
+            request.found = search->findPath(result, request.start, request.end, staticGrid, dynamicGrid,
+                                             request.maxLen, request.mode, request.agentSize, request.clearance);
+        }
+    }
+
+    inline void SolvePathRequests(PathSearch* search, const int first, const int stride) // Runs on each thread
+    {
+        auto& path = global::PATH_DATA;
+        const int size = static_cast<int>(path.batchRequests.size());
+        for (int i = first; i < size; i += stride)
+        {
+            auto& request = path.batchRequests[i];
+            if (request.isCached || request.clearance != nullptr) // Big agents are searched on the main thread
+            {
+                continue;
+            }
+            SolvePathRequest(search, request, path.batchPaths[i]);
+        }
+    }
+
+    inline void PathRequestSystem()
+    {
+        auto& path = global::PATH_DATA;
+        path.requestLock.lock();
+        std::swap(path.pendingRequests, path.batchRequests); // Requests made from the callbacks go into the next batch
+        path.requestLock.unlock();
+
+        const int size = static_cast<int>(path.batchRequests.size());
+        if (size == 0)
+        {
+            return;
+        }
+
+        if (static_cast<int>(path.batchPaths.size()) < size)
+        {
+            path.batchPaths.resize(size);
+        }
+
+        // Adding a map can move the data of other maps - so all are added before taking pointers
+        const bool useCache = path.cachedPaths.capacity > 0;
+        const auto isJumpRequest = [](const PathRequest& request)
+        {
+            return request.algorithm == PathAlgorithm::JUMP_POINT && request.mode == GridMode::STAR &&
+                request.agentSize == 1;
+        };
+        for (int i = 0; i < size; ++i)
+        {
+            auto& request = path.batchRequests[i];
+            path.mapsStaticGrids[request.map];
+            if (path.mapsDynamicGrids[request.map].visited.empty() && isJumpRequest(request))
+            {
+                path.getJumpTable(request.map); // Builds it if needed
+            }
+            if (request.agentSize > 1)
+            {
+                path.mapsClearance[request.map];
+            }
+            if (useCache)
+            {
+                const auto key = PathFindingData::GetCacheKey(request.start, request.end, request.map, request.maxLen,
+                                                              request.mode, request.algorithm, request.agentSize);
+                request.isCached = path.getCachedPath(key, path.batchPaths[i]);
+                request.found = request.isCached;
+            }
+        }
+        for (auto& request : path.batchRequests)
+        {
+            request.staticGrid = &path.mapsStaticGrids[request.map];
+            request.dynamicGrid = &path.mapsDynamicGrids[request.map];
+            const bool useTable = request.dynamicGrid->visited.empty() && isJumpRequest(request);
+            request.table = useTable ? path.getJumpTable(request.map) : nullptr;
+            request.clearance = request.agentSize > 1 ? &path.mapsClearance[request.map] : nullptr;
+        }
+
+        if (size < PathFindingData::MIN_PARALLEL_REQUESTS)
+        {
+            SolvePathRequests(&path.search, 0, 1);
+        }
+        else
+        {
+            std::array<jobHandle, COL_WORK_PARTS> handles{};
+            for (int j = 0; j < COL_WORK_PARTS - 1; ++j)
+            {
+                handles[j] = AddJob(CreateExplicitJob(SolvePathRequests, &path.workerSearches[j], j, COL_WORK_PARTS));
+            }
+            SolvePathRequests(&path.search, COL_WORK_PARTS - 1, COL_WORK_PARTS);
+            AwaitJobs(handles);
+        }
+        for (int i = 0; i < size; ++i) // The clearance map builds its blocks while searching
+        {
+            auto& request = path.batchRequests[i];
+            if (request.clearance != nullptr && !request.isCached)
+            {
+                SolvePathRequest(&path.search, request, path.batchPaths[i]);
+            }
+        }
+
+        for (int i = 0; i < size; ++i)
+        {
+            const auto& request = path.batchRequests[i];
+            if (path.cachedPaths.capacity > 0 && request.found && !request.isCached) // Callbacks can disable it
+            {
+                const auto key = PathFindingData::GetCacheKey(request.start, request.end, request.map, request.maxLen,
+                                                              request.mode, request.algorithm, request.agentSize);
+                path.cachePath(key, path.batchPaths[i]);
+            }
+            request.callback(request.found, path.batchPaths[i]);
+        }
+        path.batchRequests.clear();
+    }
+} // namespace magique
+
+#endif //MAGIQUE_PATH_REQUEST_SYSTEM_H
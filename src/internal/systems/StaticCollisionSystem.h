@@ -9,6 +9,7 @@
 // .....................................................................
 // World bounds is given as white list area -> check against the outer rectangles
 // Collidable tiles are treated as squares and inserted into the grid
+// The static grids are baked into a packed layout (see BakedHashGrid.h) - changed grids are rebaked before the queries
 //
 // 1. Get all objects from the grid cells that intersect the entity bounding box
 // 2. Calculate all the collision and sort them after distance from collision point to entity middle
@@ -16,6 +17,9 @@
 //      3.1. Avoid the sticky edges by skipping collisions iff:
 //          - the entity has at least 1 other collision (before)
 //          - the collision has
+//
+// Continuous entities (CollisionC::continuous) query the grid with the bounding box swept from the start of the tick
+// If the end position doesn't collide the swept box is checked instead -> time of impact is reported in the info
 // .....................................................................
 
 namespace magique
@@ -27,6 +31,8 @@ namespace magique
     {
         const auto& data = global::ENGINE_DATA;
         auto& staticData = global::STATIC_COLL_DATA;
+        StreamTileCollisionChunks(); // Loads chunks around actors - before the grids are baked
+        staticData.rebakeGrids();    // Single threaded so the grids stay read only for the queries
         const int size = data.collisionVec.size(); // Multithread over certain amount
         if (size < 100)
         {
@@ -86,6 +92,66 @@ namespace magique
         collector.clear();
     }
 
+    // Returns the bounding box enclosing the start and end of the movement
+    inline Rectangle GetSweptBoundingBox(const Rectangle& bb, const Point move)
+    {
+        const float x = move.x > 0.0F ? bb.x - move.x : bb.x;
+        const float y = move.y > 0.0F ? bb.y - move.y : bb.y;
+        return {x, y, bb.width + std::abs(move.x), bb.height + std::abs(move.y)};
+    }
+
+    template <class TypeHashGrid>
+    void CheckHashGridSwept(const entt::entity e, const TypeHashGrid& grid, vector<StaticID>& collector,
+                            vector<StaticPair>& pairCollector, const ColliderType type,
+                            const vector<StaticCollider>& colliders, const PositionC& pos, const CollisionC& col,
+                            const Point move)
+    {
+        const auto bb = GetEntityBoundingBox(pos, col);
+        const auto swept = GetSweptBoundingBox(bb, move);
+        grid.query(collector, swept.x, swept.y, swept.width, swept.height);
+        for (const auto num : collector)
+        {
+            const auto objectNum = StaticIDHelper::GetObjectNum(num);
+            const auto [x, y, p1, p2] = colliders[(int)objectNum];
+            CollisionInfo info{};
+            CheckCollisionEntityRect(pos, col, {x, y, p1, p2}, info);
+            if (!info.isColliding()) // Only sweep if it's not colliding at the end
+            {
+                SweptRectToRect(bb.x - move.x, bb.y - move.y, bb.width, bb.height, move.x, move.y, x, y, p1, p2, info);
+            }
+            if (info.isColliding())
+            {
+                pairCollector.push_back({info, e, objectNum, StaticIDHelper::GetData(num), type, pos.type});
+            }
+        }
+        collector.clear();
+    }
+
+    inline void CheckStaticSwept(const entt::entity e, const MapID map, vector<StaticID>& idCollector,
+                                 vector<StaticPair>& pairCollector, const vector<StaticCollider>& colliders,
+                                 const PositionC& pos, const CollisionC& col, const Point move)
+    {
+        auto& staticData = global::STATIC_COLL_DATA;
+        if (staticData.mapObjectGrids.contains(map))
+        {
+            const auto& grid = staticData.mapObjectGrids[map];
+            constexpr auto type = ColliderType::TILEMAP_OBJECT;
+            CheckHashGridSwept(e, grid, idCollector, pairCollector, type, colliders, pos, col, move);
+        }
+        if (staticData.mapTileGrids.contains(map))
+        {
+            const auto& grid = staticData.mapTileGrids[map];
+            constexpr auto type = ColliderType::TILESET_TILE;
+            CheckHashGridSwept(e, grid, idCollector, pairCollector, type, colliders, pos, col, move);
+        }
+        if (staticData.mapGroupGrids.contains(map))
+        {
+            const auto& grid = staticData.mapGroupGrids[map];
+            constexpr auto type = ColliderType::MANUAL_COLLIDER;
+            CheckHashGridSwept(e, grid, idCollector, pairCollector, type, colliders, pos, col, move);
+        }
+    }
+
     inline void CheckStaticCollisionRange(const int thread, const int start, const int end) // Runs on each thread
     {
 
@@ -95,6 +161,7 @@ namespace magique
 
         const auto& collisionVec = data.collisionVec;
         const auto& colliderStorage = staticData.colliderStorage.colliders;
+        const auto& sweepStarts = global::DY_COLL_DATA.sweepStarts;
 
         // Just use for the hash grid queries
         auto& idCollector = staticData.colliderCollector[thread].vec; // non const
@@ -127,6 +194,17 @@ namespace magique
             }
             const auto map = pos.map;
 
+            if (col.continuous) [[unlikely]]
+            {
+                const auto it = sweepStarts.find(e);
+                if (it != sweepStarts.end())
+                {
+                    const Point move = {pos.x - it->second.x, pos.y - it->second.y};
+                    CheckStaticSwept(e, map, idCollector, pairCollector, colliderStorage, pos, col, move);
+                    continue;
+                }
+            }
+
             // Query object grid if it has any entries
             if (staticData.mapObjectGrids.contains(map))
             {
@@ -256,6 +256,116 @@ namespace magique
         RectToRect(x1, y1, w1, h1, x2, y2 + radius, radius * 2, height - radius, info);
     }
 
+    //----------------- SWEEP -----------------//
+
+    // Moving rect: x,y,width,height and its movement dx,dy / static rect: x,y,width,height
+    // Slab method: finds the first time in [0,1) at which the moving rect touches the static one
+    // Normal and pen depth are chosen so resolving moves the rect back to the point of impact
+    inline void SweptRectToRect(const float x1, const float y1, const float w1, const float h1, const float dx,
+                                const float dy, const float x2, const float y2, const float w2, const float h2,
+                                CollisionInfo& info)
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        float entryX = -inf, exitX = inf;
+        float entryY = -inf, exitY = inf;
+
+        if (dx == 0.0F)
+        {
+            if (x1 + w1 <= x2 || x1 >= x2 + w2)
+                return;
+        }
+        else
+        {
+            const float invX = 1.0F / dx;
+            const float t1 = (x2 - (x1 + w1)) * invX;
+            const float t2 = (x2 + w2 - x1) * invX;
+            entryX = minValue(t1, t2);
+            exitX = maxValue(t1, t2);
+        }
+
+        if (dy == 0.0F)
+        {
+            if (y1 + h1 <= y2 || y1 >= y2 + h2)
+                return;
+        }
+        else
+        {
+            const float invY = 1.0F / dy;
+            const float t1 = (y2 - (y1 + h1)) * invY;
+            const float t2 = (y2 + h2 - y1) * invY;
+            entryY = minValue(t1, t2);
+            exitY = maxValue(t1, t2);
+        }
+
+        const float entry = maxValue(entryX, entryY);
+        const float exit = minValue(exitX, exitY);
+        if (entry >= exit || entry < 0.0F || entry >= 1.0F) [[likely]]
+        {
+            return;
+        }
+
+        // Position of the moving rect at the time of impact
+        const float hx = x1 + dx * entry;
+        const float hy = y1 + dy * entry;
+        if (entryX > entryY)
+        {
+            info.normalVector.x = dx > 0.0F ? -1.0F : 1.0F;
+            info.normalVector.y = 0.0F;
+            info.penDepth = std::abs(dx) * (1.0F - entry);
+            info.collisionPoint.x = dx > 0.0F ? x2 : x2 + w2;
+            info.collisionPoint.y = (maxValue(hy, y2) + minValue(hy + h1, y2 + h2)) / 2.0F;
+        }
+        else
+        {
+            info.normalVector.x = 0.0F;
+            info.normalVector.y = dy > 0.0F ? -1.0F : 1.0F;
+            info.penDepth = std::abs(dy) * (1.0F - entry);
+            info.collisionPoint.x = (maxValue(hx, x2) + minValue(hx + w1, x2 + w2)) / 2.0F;
+            info.collisionPoint.y = dy > 0.0F ? y2 : y2 + h2;
+        }
+        info.timeOfImpact = entry;
+    }
+
+    //----------------- RAY -----------------//
+
+    // Ray: origin and normalized direction / rect: x,y,width,height
+    // Returns true and the distance along the ray if it hits the rect within maxDist - 0 if the origin is inside
+    inline bool RayToRect(const float ox, const float oy, const float dx, const float dy, const float maxDist,
+                          const float rx, const float ry, const float rw, const float rh, float& dist)
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        float tMin = 0.0F;
+        float tMax = maxDist;
+        if (dx == 0.0F)
+        {
+            if (ox < rx || ox > rx + rw)
+                return false;
+        }
+        else
+        {
+            const float invX = 1.0F / dx;
+            const float t1 = (rx - ox) * invX;
+            const float t2 = (rx + rw - ox) * invX;
+            tMin = maxValue(tMin, minValue(t1, t2));
+            tMax = minValue(tMax, maxValue(t1, t2));
+        }
+        if (dy == 0.0F)
+        {
+            if (oy < ry || oy > ry + rh)
+                return false;
+        }
+        else
+        {
+            const float invY = 1.0F / dy;
+            const float t1 = (ry - oy) * invY;
+            const float t2 = (ry + rh - oy) * invY;
+            tMin = maxValue(tMin, minValue(t1, t2));
+            tMax = minValue(tMax, maxValue(t1, t2));
+        }
+        dist = tMin;
+        return tMin <= tMax && tMin != inf;
+    }
+
     //----------------- SAT -----------------//
 
     // checks 4 points against another 4 points
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: zlib-acknowledgement
+#ifndef MAGIQUE_TILEMERGEUTIL_H
+#define MAGIQUE_TILEMERGEUTIL_H
+
+#include <cstdint>
+
+//-----------------------------------------------
+// Tile Merge Util
+//-----------------------------------------------
+// .....................................................................
+// Greedy meshing of tile cells into maximal rectangles
+// Each rectangle is grown first along the row and then downwards as long as all cells have the same value
+// .....................................................................
+
+namespace magique
+{
+    // Merges all cells of the given region with the same value (>= 0) into rectangles
+    // Calls func(x, y, width, height, value) for each rectangle - coordinates are in cells
+    //      - cells: value of each cell in a row major grid with the given stride - negative values are skipped
+    //      - done: region sized scratch (row major) - cells marked with != 0 are skipped (e.g. already covered)
+    template <typename Func>
+    void GreedyMergeCells(const int16_t* cells, uint8_t* done, const int stride, const int regionX,
+                          const int regionY, const int regionW, const int regionH, Func func)
+    {
+        const auto isFree = [&](const int x, const int y, const int16_t value)
+        {
+            return cells[y * stride + x] == value && done[(y - regionY) * regionW + (x - regionX)] == 0;
+        };
+
+        const int endX = regionX + regionW;
+        const int endY = regionY + regionH;
+        for (int y = regionY; y < endY; ++y)
+        {
+            for (int x = regionX; x < endX; ++x)
+            {
+                const int16_t value = cells[y * stride + x];
+                if (value < 0 || !isFree(x, y, value))
+                    continue;
+
+                int width = 1;
+                while (x + width < endX && isFree(x + width, y, value))
+                    ++width;
+
+                int height = 1;
+                while (y + height < endY)
+                {
+                    bool rowFree = true;
+                    for (int i = x; i < x + width && rowFree; ++i)
+                        rowFree = isFree(i, y + height, value);
+                    if (!rowFree)
+                        break;
+                    ++height;
+                }
+
+                for (int i = y; i < y + height; ++i)
+                {
+                    for (int j = x; j < x + width; ++j)
+                        done[(i - regionY) * regionW + (j - regionX)] = 1;
+                }
+                func(x, y, width, height, value);
+            }
+        }
+    }
+} // namespace magique
+
+#endif //MAGIQUE_TILEMERGEUTIL_H
@@ -10,6 +10,7 @@
 #include <magique/core/Core.h>
 #include <magique/core/Debug.h>
 #include <magique/core/Draw.h>
+#include <magique/core/StaticCollision.h>
 
 //-----------------------------------------------
 // Collision Benchmark
@@ -48,6 +49,12 @@
 // Time: 7.68
 // Time: 7.54   | optimized iteration and removed a branch
 // Time: 5.69ms | New compiler version? some minor branching optimizations
+// Added hierarchical entity grid (1x, 4x, 16x cell size) - toggle MIXED_SIZES for a mixed size distribution
+// Added dense grid backend for bounded maps - toggle DENSE_GRID to compare against the hashed cell lookup
+// Entity grid only with 50k entities on 1 thread - insert | query of all entities per tick:
+// Measured with magique-tests "[benchmark]" (testEntityGridBenchmark.cpp) - GCC 12.2 -O2, single core VM
+// Hashed: 4.9 ms | 27.7 ms
+// Dense:  3.3 ms | 20.5 ms
 // .....................................................................
 
 using namespace magique;
@@ -109,6 +116,8 @@ struct ObjectScript final : EntityScript
 
 int MAX_SHAPE = 100;
 float OBJECT_SIZE = 25;
+bool MIXED_SIZES = false; // Mostly small entities with some medium and few huge ones - stresses the coarse levels
+bool DENSE_GRID = false; // Setting the world bounds selects the dense grid backend - also adds world bound collision
 
 void benchmarkSetup()
 {
@@ -117,6 +126,10 @@ void benchmarkSetup()
         CreateEntity(OBJECT, GetRandomValue(0, 4000), GetRandomValue(0, 4000), MapID(0));
     }
     CreateEntity(PLAYER, 2500, 2500, MapID(0));
+    if (DENSE_GRID)
+    {
+        SetStaticWorldBounds({-250, -250, 4500, 4500});
+    }
     SetBenchmarkTicks(300);
 }
 
@@ -161,7 +174,17 @@ struct Example final : Game
         const auto objFunc = [](entt::entity e, EntityType type)
         {
             const auto val = GetRandomValue(0, MAX_SHAPE);
-            if (val < 25)
+            if (MIXED_SIZES)
+            {
+                const auto sizeVal = GetRandomValue(0, 100);
+                float size = static_cast<float>(GetRandomValue(4, 30)); // 1x level
+                if (sizeVal > 98)
+                    size = static_cast<float>(GetRandomValue(130, 400)); // 16x level
+                else if (sizeVal > 90)
+                    size = static_cast<float>(GetRandomValue(40, 120)); // 4x level
+                GiveCollisionRect(e, size, size);
+            }
+            else if (val < 25)
             {
                 GiveCollisionRect(e, OBJECT_SIZE, OBJECT_SIZE);
             }
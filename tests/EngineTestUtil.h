@@ -0,0 +1,88 @@
+#ifndef ENGINE_TEST_UTIL_H
+#define ENGINE_TEST_UTIL_H
+
+#include <functional>
+#include <raylib/raylib.h>
+
+#include <magique/core/Core.h>
+#include <magique/core/Camera.h>
+#include <magique/core/CollisionDetection.h>
+#include <magique/ecs/ECS.h>
+#include <magique/ecs/Components.h>
+#include <magique/ecs/Scripting.h>
+#include <magique/util/JobSystem.h>
+#include <magique/util/RayUtils.h>
+
+#include "external/cxstructs/cxstructs/SmallVector.h"
+#include "internal/globals/EngineData.h"
+#include "internal/globals/EngineConfig.h"
+#include "internal/globals/ECSData.h"
+#include "internal/globals/PathFindingData.h"
+#include "internal/globals/ScriptData.h"
+#include "internal/utils/CollisionSystemUtil.h"
+#include "internal/globals/StaticCollisionData.h"
+#include "internal/globals/DynamicCollisionData.h"
+#include "internal/utils/CollisionPrimitives.h"
+
+#include "internal/systems/StaticCollisionSystem.h"
+#include "internal/systems/DynamicCollisionSystem.h"
+#include "internal/systems/LogicSystem.h"
+
+//-----------------------------------------------
+// Engine Test Util
+//-----------------------------------------------
+// .....................................................................
+// Runs the collision relevant part of a game tick without a window - same order as InternalUpdatePre/Post
+// Entities are only collected within update range of an actor - tests need at least one actor in each map
+// .....................................................................
+
+enum EntityType : uint16_t
+{
+    TEST_ACTOR,
+    TEST_OBJECT,
+    TEST_OTHER,
+};
+
+namespace magique::test
+{
+    // Logic system (entity grids), the user update and then the collision systems
+    inline void RunCollisionTick(const std::function<void()>& update = nullptr)
+    {
+        LogicSystem(GetRegistry());
+        if (update)
+            update();
+        StaticCollisionSystem();
+        DynamicCollisionSystem();
+        ResolveCollisions();
+        global::ENGINE_DATA.engineTicks++;
+    }
+
+    // Destroys all entities and clears the collision state between test cases
+    // Registers the test types with a plain script
+    inline void ResetEngine()
+    {
+        for (const auto type : {TEST_ACTOR, TEST_OBJECT, TEST_OTHER})
+        {
+            if (!global::ECS_DATA.typeMap.contains(type))
+                RegisterEntity(type, [](entt::entity, EntityType) {});
+            SetEntityScript(type, new EntityScript());
+        }
+        for (const auto e : GetRegistry().view<entt::entity>())
+        {
+            DestroyEntity(e);
+        }
+        RunCollisionTick(); // Drops the contacts of the destroyed entities
+        global::ENGINE_CONFIG.parallelCollisionEvents = false;
+    }
+
+    // Creates an entity with a rect collision shape - the create function of the type is skipped
+    inline entt::entity CreateRectEntity(const EntityType type, const float x, const float y, const float width,
+                                         const float height, const MapID map = MapID(0))
+    {
+        const auto e = CreateEntity(type, x, y, map, 0, false);
+        GiveCollisionRect(e, width, height);
+        return e;
+    }
+} // namespace magique::test
+
+#endif //ENGINE_TEST_UTIL_H
@@ -0,0 +1,122 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <magique/fwd.hpp>
+#include <magique/internal/Macros.h>
+
+#include "internal/datastructures/VectorType.h"
+#include "internal/datastructures/HashTypes.h"
+#include "internal/datastructures/MultiResolutionGrid.h"
+#include "internal/datastructures/BakedHashGrid.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int CELL_SIZE = 32;
+    using Baked = BakedHashGrid<uint32_t, 64, CELL_SIZE>;
+    using Reference = SingleResolutionHashGrid<uint32_t, 64, CELL_SIZE>;
+
+    struct Rect final
+    {
+        float x, y, w, h;
+    };
+
+    bool Matches(const uint32_t val, const uint32_t elem) { return val == elem; }
+
+    std::vector<uint32_t> Query(const auto& grid, const Rect& r)
+    {
+        vector<uint32_t> found;
+        grid.query(found, r.x, r.y, r.w, r.h);
+        std::vector<uint32_t> result{found.begin(), found.end()};
+        std::ranges::sort(result);
+        const auto [first, last] = std::ranges::unique(result);
+        result.erase(first, last);
+        return result;
+    }
+
+    // Queries around the origin so columns are split at y = 0
+    void RequireSameQueries(const Baked& baked, const Reference& reference, std::mt19937& gen)
+    {
+        std::uniform_real_distribution<float> pos{-600.0F, 600.0F};
+        std::uniform_real_distribution<float> size{0.0F, 300.0F};
+        int found = 0;
+        for (int i = 0; i < 300; ++i)
+        {
+            const Rect r{pos(gen), pos(gen), size(gen), size(gen)};
+            const auto result = Query(baked, r);
+            REQUIRE(result == Query(reference, r));
+            REQUIRE(std::ranges::find(result, Baked::TOMBSTONE) == result.end());
+            found += static_cast<int>(result.size());
+        }
+        REQUIRE(found > 0);
+        const Rect acrossZero{-50, -50, 100, 100};
+        REQUIRE(Query(baked, acrossZero) == Query(reference, acrossZero));
+    }
+} // namespace
+
+TEST_CASE("Baked hash grid matches the single resolution grid")
+{
+    std::mt19937 gen{5};
+    std::uniform_real_distribution<float> pos{-500.0F, 500.0F};
+    std::uniform_real_distribution<float> size{1.0F, 60.0F};
+    std::vector<Rect> rects;
+    Baked baked;
+    Reference reference;
+    const auto insert = [&]
+    {
+        const Rect r{pos(gen), pos(gen), size(gen), size(gen)};
+        const auto id = static_cast<uint32_t>(rects.size());
+        rects.push_back(r);
+        baked.insert(id, r.x, r.y, r.w, r.h);
+        reference.insert(id, r.x, r.y, r.w, r.h);
+    };
+    const auto remove = [&](const uint32_t id)
+    {
+        const auto& r = rects[id];
+        baked.removeIfWithHoles(id, Matches, r.x, r.y, r.w, r.h);
+        reference.removeIfWithHoles(id, Matches);
+        reference.patchHoles();
+    };
+
+    for (int i = 0; i < 400; ++i)
+        insert();
+    REQUIRE(baked.needsBake());
+    baked.bake();
+    REQUIRE_FALSE(baked.needsBake());
+    REQUIRE(baked.delta.getCellCount() == 0);
+    const auto bakedValues = baked.values.size();
+    RequireSameQueries(baked, reference, gen);
+
+    // Delta inserts are queried in addition to the baked cells
+    for (int i = 0; i < Baked::MIN_DELTA / 2; ++i)
+        insert();
+    REQUIRE_FALSE(baked.needsBake());
+    RequireSameQueries(baked, reference, gen);
+
+    // Removals leave tombstones in the baked values and remove from the delta
+    for (uint32_t id = 0; id < 400; id += 4)
+        remove(id);
+    remove(static_cast<uint32_t>(rects.size()) - 1);
+    REQUIRE(baked.values.size() == bakedValues);
+    REQUIRE(std::ranges::count(baked.values, Baked::TOMBSTONE) > 100);
+    RequireSameQueries(baked, reference, gen);
+
+    // Only the cells of the given rect are visited
+    const auto& first = rects[1];
+    baked.removeIfWithHoles(1u, Matches, first.x + 200, first.y + 200, first.w, first.h);
+    REQUIRE(Query(baked, first) == Query(reference, first));
+    baked.removeIfWithHoles(1u, Matches); // Visits all values
+    reference.removeIfWithHoles(1u, Matches);
+    reference.patchHoles();
+
+    REQUIRE(baked.needsBake());
+    baked.bake();
+    REQUIRE_FALSE(baked.needsBake());
+    REQUIRE(baked.deltaChanges == 0);
+    REQUIRE(std::ranges::count(baked.values, Baked::TOMBSTONE) == 0);
+    REQUIRE(baked.values.size() < bakedValues);
+    RequireSameQueries(baked, reference, gen);
+}
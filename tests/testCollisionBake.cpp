@@ -0,0 +1,180 @@
+#include <catch_amalgamated.hpp>
+#include <chrono>
+#include <raylib/raylib.h>
+
+#include <magique/assets/types/Asset.h>
+#include <magique/assets/types/TileMap.h>
+#include <magique/assets/types/TileSet.h>
+#include <magique/core/StaticCollision.h>
+
+#include "internal/globals/StaticCollisionData.h"
+#include "internal/globals/PathFindingData.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int MAP_SIZE = 1024;
+    constexpr int TILE_SIZE = 16;
+
+    // Tile 0 is a full solid tile - tile 1 has a custom collision rect
+    TileSet CreateTileSet()
+    {
+        TileSet tileSet;
+        tileSet.tileSize = TILE_SIZE;
+        tileSet.tileCount = 2;
+        TileInfo full{};
+        full.tileID = 0;
+        full.hasCollision = true;
+        full.width = TILE_SIZE;
+        full.height = TILE_SIZE;
+        TileInfo custom{};
+        custom.tileID = 1;
+        custom.hasCollision = true;
+        custom.x = 4;
+        custom.y = 4;
+        custom.width = 8;
+        custom.height = 8;
+        tileSet.infoVec = {full, custom};
+        return tileSet;
+    }
+
+    // Dungeon like map - rooms with doors and some pillars
+    TileMap CreateTileMap()
+    {
+        TileMap tileMap;
+        tileMap.width = MAP_SIZE;
+        tileMap.height = MAP_SIZE;
+        auto& layer = tileMap.tileLayers.emplace_back(MAP_SIZE * MAP_SIZE, 0);
+        for (int i = 0; i < MAP_SIZE; ++i)
+        {
+            for (int j = 0; j < MAP_SIZE; ++j)
+            {
+                const bool isWall = (i % 16 == 0 || j % 24 == 0) && (i % 16 != 8 && j % 24 != 12); // With doors
+                const bool isPillar = (i % 16 == 4 && j % 24 == 6);
+                if (isWall)
+                    layer[i * MAP_SIZE + j] = 1; // Stored as 1 more
+                else if (isPillar)
+                    layer[i * MAP_SIZE + j] = 2;
+            }
+        }
+        return tileMap;
+    }
+
+    double MillisSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+TEST_CASE("Baked tile collision loads the same data faster")
+{
+    const auto tileSet = CreateTileSet();
+    const auto tileMap = CreateTileMap();
+    LoadGlobalTileSet(tileSet);
+
+    const auto parsedMap = static_cast<MapID>(0);
+    const auto bakedMap = static_cast<MapID>(1);
+
+    auto start = std::chrono::steady_clock::now();
+    AddTileCollisions(parsedMap, tileMap, {0});
+    const double parseTime = MillisSince(start);
+
+    start = std::chrono::steady_clock::now();
+    vector<char> baked;
+    vector<int> layers;
+    layers.push_back(0);
+    BakeTileCollisions(baked, tileMap, tileSet, 1, layers);
+    const double bakeTime = MillisSince(start);
+
+    Asset asset{"map.tmj.collision", static_cast<int>(baked.size()), baked.data()};
+    start = std::chrono::steady_clock::now();
+    REQUIRE(AddBakedTileCollisions(bakedMap, asset));
+    const double loadTime = MillisSince(start);
+
+    INFO("Parsing: " << parseTime << " ms | Baking: " << bakeTime << " ms | Loading baked: " << loadTime << " ms");
+    INFO("Baked size: " << baked.size() / 1'000'000.0 << " mb");
+
+    auto& data = global::STATIC_COLL_DATA;
+    const auto& parsedIds = data.colliderReferences.tilesCollisionMap[parsedMap];
+    const auto& bakedIds = data.colliderReferences.tilesCollisionMap[bakedMap];
+    REQUIRE(parsedIds.size() == bakedIds.size());
+    for (int i = 0; i < parsedIds.size(); ++i)
+    {
+        const auto& parsed = data.colliderStorage.get(parsedIds[i]);
+        const auto& loaded = data.colliderStorage.get(bakedIds[i]);
+        REQUIRE(parsed.x == loaded.x);
+        REQUIRE(parsed.y == loaded.y);
+        REQUIRE(parsed.p1 == loaded.p1);
+        REQUIRE(parsed.p2 == loaded.p2);
+    }
+
+    // Same queries return the same colliders
+    vector<StaticID> parsedResult;
+    vector<StaticID> bakedResult;
+    for (float pos = 0; pos < MAP_SIZE * TILE_SIZE; pos += 333)
+    {
+        parsedResult.clear();
+        bakedResult.clear();
+        data.mapTileGrids[parsedMap].query(parsedResult, pos, pos, 100, 100);
+        data.mapTileGrids[bakedMap].query(bakedResult, pos, pos, 100, 100);
+        REQUIRE(parsedResult.size() == bakedResult.size());
+    }
+
+    // Same pathfinding grid
+    const auto& parsedPath = global::PATH_DATA.mapsStaticGrids[parsedMap];
+    const auto& bakedPath = global::PATH_DATA.mapsStaticGrids[bakedMap];
+    REQUIRE(parsedPath.visited.size() == bakedPath.visited.size());
+    for (const auto& [key, block] : parsedPath.visited)
+    {
+        REQUIRE(bakedPath.visited.at(key) == block);
+    }
+
+    // Single tiles can still be updated
+    const auto colliderCount = bakedIds.size();
+    UpdateTileCollision(bakedMap, 0, 5, 5, 2);
+    REQUIRE(bakedIds.size() == colliderCount + 1);
+
+    REQUIRE(loadTime < parseTime);
+
+    RemoveTileCollisions(parsedMap);
+    RemoveTileCollisions(bakedMap);
+    data.tileSet = nullptr;
+    data.markedTilesMap.clear();
+}
+
+TEST_CASE("Baked tile collision of an empty map can't hold colliders")
+{
+    const auto tileSet = CreateTileSet();
+    LoadGlobalTileSet(tileSet);
+    const auto map = static_cast<MapID>(2);
+
+    // The colliders would go into a chunk that doesn't exist
+    BakedTileCollisionHeader header;
+    header.width = 0;
+    header.height = 4;
+    header.tileSize = TILE_SIZE;
+    header.colliderCount = 1;
+    header.pathCellSize = PathFindingData::cellSize;
+    header.pathBlockSize = sizeof(PathFindingGrid::Block);
+    const auto createAsset = [&](vector<char>& baked)
+    {
+        baked.clear();
+        baked.resize(sizeof(header) + header.colliderCount * sizeof(StaticCollider) + sizeof(uint32_t), 0);
+        memcpy(baked.data(), &header, sizeof(header));
+        return Asset{"empty.tmj.collision", static_cast<int>(baked.size()), baked.data()};
+    };
+    vector<char> baked;
+    REQUIRE_FALSE(AddBakedTileCollisions(map, createAsset(baked)));
+
+    auto& data = global::STATIC_COLL_DATA;
+    REQUIRE_FALSE(data.colliderReferences.tilesCollisionMap.contains(map));
+
+    header.colliderCount = 0;
+    REQUIRE(AddBakedTileCollisions(map, createAsset(baked)));
+    REQUIRE(data.colliderReferences.tilesCollisionMap[map].empty());
+
+    RemoveTileCollisions(map);
+    data.tileSet = nullptr;
+    data.markedTilesMap.clear();
+}
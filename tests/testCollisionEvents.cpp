@@ -0,0 +1,170 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    enum EventKind : uint8_t
+    {
+        DYNAMIC,
+        ENTER,
+        STAY,
+        EXIT,
+    };
+
+    struct Event final
+    {
+        EventKind kind;
+        entt::entity self;
+        entt::entity other;
+    };
+
+    std::vector<Event> EVENTS;
+
+    int CountEvents(const EventKind kind, const entt::entity self)
+    {
+        const auto matches = [&](const Event& e) { return e.kind == kind && e.self == self; };
+        return static_cast<int>(std::ranges::count_if(EVENTS, matches));
+    }
+
+    struct RecordScript final : EntityScript
+    {
+        bool ticks;
+        explicit RecordScript(const bool ticks) : ticks(ticks) {}
+
+        void onDynamicCollision(entt::entity self, entt::entity other, CollisionInfo&) override
+        {
+            EVENTS.push_back({DYNAMIC, self, other});
+        }
+        void onCollisionEnter(entt::entity self, entt::entity other, const CollisionInfo&) override
+        {
+            EVENTS.push_back({ENTER, self, other});
+        }
+        void onCollisionStay(entt::entity self, entt::entity other, const CollisionInfo&) override
+        {
+            EVENTS.push_back({STAY, self, other});
+        }
+        void onCollisionExit(entt::entity self, entt::entity other) override
+        {
+            EVENTS.push_back({EXIT, self, other});
+        }
+        [[nodiscard]] bool receivesCollisionTicks() const override { return ticks; }
+    };
+
+    void MoveTo(const entt::entity e, const float x, const float y)
+    {
+        auto& pos = GetComponent<PositionC>(e);
+        pos.x = x;
+        pos.y = y;
+    }
+} // namespace
+
+TEST_CASE("Contacts report one enter then a stay per tick and one exit")
+{
+    test::ResetEngine();
+    SetEntityScript(TEST_OBJECT, new RecordScript(true));
+    SetEntityScript(TEST_OTHER, new RecordScript(false)); // Only enter and exit
+    GiveActor(CreateEntity(TEST_ACTOR, 0, 0, MapID(0), 0, false));
+
+    const auto a = test::CreateRectEntity(TEST_OBJECT, 100, 100, 20, 20);
+    const auto b = test::CreateRectEntity(TEST_OTHER, 110, 100, 20, 20);
+    EVENTS.clear();
+
+    // Drives b apart - overlapping until x = 120
+    constexpr int stayTicks = 5;
+    for (int tick = 0; tick <= stayTicks; ++tick)
+    {
+        MoveTo(a, 100, 100); // Undo the resolution
+        MoveTo(b, 110.0F + static_cast<float>(tick), 100);
+        test::RunCollisionTick();
+    }
+    REQUIRE(CountEvents(ENTER, a) == 1);
+    REQUIRE(CountEvents(STAY, a) == stayTicks);
+    REQUIRE(CountEvents(DYNAMIC, a) == stayTicks + 1);
+    REQUIRE(CountEvents(EXIT, a) == 0);
+    const auto first = std::ranges::find_if(EVENTS, [&](const Event& e) { return e.self == a; });
+    REQUIRE(first->kind == DYNAMIC); // onDynamicCollision comes before the contact event
+    REQUIRE((first + 1)->kind == ENTER);
+
+    // Only the per-tick events are suppressed
+    REQUIRE(CountEvents(ENTER, b) == 1);
+    REQUIRE(CountEvents(STAY, b) == 0);
+    REQUIRE(CountEvents(DYNAMIC, b) == 0);
+
+    for (int tick = 0; tick < 3; ++tick)
+    {
+        MoveTo(a, 100, 100);
+        MoveTo(b, 200, 100);
+        test::RunCollisionTick();
+    }
+    REQUIRE(CountEvents(EXIT, a) == 1);
+    REQUIRE(CountEvents(EXIT, b) == 1);
+    REQUIRE(EVENTS.back().kind == EXIT);
+    REQUIRE(CountEvents(STAY, a) == stayTicks);
+
+    // Touching again is a new contact - destroying one side ends it for the other
+    EVENTS.clear();
+    MoveTo(b, 110, 100);
+    test::RunCollisionTick();
+    REQUIRE(CountEvents(ENTER, a) == 1);
+    REQUIRE(CountEvents(ENTER, b) == 1);
+    DestroyEntity(b);
+    test::RunCollisionTick();
+    REQUIRE(CountEvents(EXIT, a) == 1);
+    REQUIRE(CountEvents(EXIT, b) == 0); // Destroyed entities get no events
+    REQUIRE(EVENTS.back().kind == EXIT);
+    REQUIRE(EVENTS.back().other == b);
+
+    test::RunCollisionTick();
+    REQUIRE(CountEvents(EXIT, a) == 1);
+    test::ResetEngine();
+}
+
+TEST_CASE("Huge entities collide when the collision work is split into parts")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+    const auto setup = []
+    {
+        test::ResetEngine();
+        SetEntityScript(TEST_OBJECT, new RecordScript(false));
+        GiveActor(CreateEntity(TEST_ACTOR, 0, 0, MapID(0), 0, false));
+        for (int i = 0; i < 600; ++i) // Over the multithreading threshold - none touch
+            test::CreateRectEntity(TEST_OTHER, static_cast<float>(i % 25) * 20, static_cast<float>(i / 25) * 20, 10, 10);
+        EVENTS.clear();
+    };
+    const auto touches = [](const entt::entity self, const entt::entity other)
+    {
+        const auto matches = [&](const Event& e) { return e.kind == ENTER && e.self == self && e.other == other; };
+        return std::ranges::any_of(EVENTS, matches);
+    };
+
+    // Two overlapping pairs in the coarsest level - each in its own cell
+    setup();
+    const auto a1 = test::CreateRectEntity(TEST_OBJECT, -1000, -1000, 200, 200);
+    const auto a2 = test::CreateRectEntity(TEST_OBJECT, -950, -950, 200, 200);
+    const auto b1 = test::CreateRectEntity(TEST_OBJECT, 600, -1000, 200, 200);
+    const auto b2 = test::CreateRectEntity(TEST_OBJECT, 650, -950, 200, 200);
+    test::RunCollisionTick();
+    REQUIRE(global::DY_COLL_DATA.mapEntityGrids[MapID(0)].level2.getCellCount() == 2);
+    REQUIRE(touches(a1, a2));
+    REQUIRE(touches(a2, a1));
+    REQUIRE(touches(b1, b2));
+    REQUIRE(touches(b2, b1));
+
+    // Two coarse elements - each only touches a small entity
+    setup();
+    const auto c1 = test::CreateRectEntity(TEST_OBJECT, -1000, -1000, 200, 200);
+    const auto c2 = test::CreateRectEntity(TEST_OBJECT, 600, -1000, 200, 200);
+    const auto s1 = test::CreateRectEntity(TEST_OTHER, -900, -900, 10, 10);
+    const auto s2 = test::CreateRectEntity(TEST_OTHER, 700, -900, 10, 10);
+    test::RunCollisionTick();
+    REQUIRE(global::DY_COLL_DATA.mapEntityGrids[MapID(0)].coarseElements.size() == 2);
+    REQUIRE(touches(c1, s1));
+    REQUIRE(touches(c2, s2));
+    test::ResetEngine();
+}
@@ -0,0 +1,82 @@
+#include <catch_amalgamated.hpp>
+#include <vector>
+
+#include <magique/core/StaticCollision.h>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    struct Hit final
+    {
+        entt::entity other; // entt::null for static colliders
+        CollisionInfo info;
+    };
+
+    std::vector<Hit> HITS;
+
+    // Records the hits without resolving them
+    struct BulletScript final : EntityScript
+    {
+        void onDynamicCollision(entt::entity, entt::entity other, CollisionInfo& info) override
+        {
+            HITS.push_back({other, info});
+        }
+        void onStaticCollision(entt::entity, ColliderInfo, CollisionInfo& info) override
+        {
+            HITS.push_back({entt::null, info});
+        }
+    };
+
+    // Bullet flies 400 to the right within a single tick - through a thin entity at 200 and a thin wall at 300
+    void ShootBullet(const bool continuous)
+    {
+        test::ResetEngine();
+        SetEntityScript(TEST_OBJECT, new BulletScript());
+        GiveActor(CreateEntity(TEST_ACTOR, 0, 0, MapID(0), 0, false));
+        test::CreateRectEntity(TEST_OTHER, 200, 0, 4, 100);
+        const auto bullet = test::CreateRectEntity(TEST_OBJECT, 100, 40, 4, 4);
+        GetComponent<CollisionC>(bullet).continuous = continuous;
+
+        HITS.clear();
+        test::RunCollisionTick([&] { GetComponent<PositionC>(bullet).x += 400; });
+    }
+} // namespace
+
+TEST_CASE("Continuous entities hit thin walls and entities they cross in one tick")
+{
+    ManualColliderGroup wall;
+    wall.addRect(300, 0, 4, 100);
+    AddColliderGroup(MapID(0), wall);
+
+    ShootBullet(false); // Old behavior - tunnels through both
+    REQUIRE(HITS.empty());
+
+    ShootBullet(true);
+    REQUIRE(HITS.size() == 2);
+    const auto& entityHit = HITS[0].other != entt::null ? HITS[0] : HITS[1];
+    const auto& wallHit = HITS[0].other == entt::null ? HITS[0] : HITS[1];
+    REQUIRE(entityHit.other != entt::entity{entt::null});
+    REQUIRE(wallHit.other == entt::entity{entt::null});
+
+    // Time of impact is where the front of the bullet reaches the obstacle
+    REQUIRE(entityHit.info.timeOfImpact == Catch::Approx((200.0F - 104.0F) / 400.0F));
+    REQUIRE(wallHit.info.timeOfImpact == Catch::Approx((300.0F - 104.0F) / 400.0F));
+    for (const auto& hit : HITS)
+    {
+        REQUIRE(hit.info.normalVector.x == -1.0F);
+        REQUIRE(hit.info.normalVector.y == 0.0F);
+    }
+    REQUIRE(entityHit.info.collisionPoint.x == Catch::Approx(200.0F));
+    REQUIRE(wallHit.info.collisionPoint.x == Catch::Approx(300.0F));
+
+    // Colliding at the end of the movement is a normal collision
+    HITS.clear();
+    test::RunCollisionTick([] {});
+    REQUIRE(HITS.empty()); // Not moved and nothing at x = 500
+
+    RemoveColliderGroup(MapID(0), wall);
+    test::ResetEngine();
+}
@@ -0,0 +1,93 @@
+#include <catch_amalgamated.hpp>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <magique/util/Logging.h>
+
+#include "internal/globals/DynamicCollisionData.h"
+
+using namespace magique;
+
+// Hidden - run with: magique-tests "[benchmark]"
+// Measures the numbers noted in CollisionBenchmark.h - same entity count, area and world bounds
+
+namespace
+{
+    constexpr int ENTITIES = 50'000;
+    constexpr int TICKS = 300;
+
+    struct Rect final
+    {
+        float x, y, w, h;
+    };
+
+    // Bounding boxes of the benchmark shapes (rect, triangle, circle, capsule)
+    std::vector<Rect> CreateRects()
+    {
+        std::mt19937 gen{100};
+        std::uniform_int_distribution pos{0, 4000};
+        std::uniform_int_distribution shape{0, 3};
+        constexpr Rect shapes[] = {{0, 0, 25, 25}, {0, 0, 30, 15}, {0, 0, 48, 48}, {0, 0, 33, 15}};
+        std::vector<Rect> rects;
+        for (int i = 0; i < ENTITIES; ++i)
+        {
+            auto rect = shapes[shape(gen)];
+            rect.x = static_cast<float>(pos(gen));
+            rect.y = static_cast<float>(pos(gen));
+            rects.push_back(rect);
+        }
+        return rects;
+    }
+
+    // Returns the average insert and query time per tick in milliseconds
+    std::pair<double, double> RunGrid(EntityHashGrid& grid, const std::vector<Rect>& rects)
+    {
+        using Clock = std::chrono::steady_clock;
+        Clock::duration insertTime{};
+        Clock::duration queryTime{};
+        vector<entt::entity> found;
+        size_t total = 0;
+        for (int t = 0; t < TICKS; ++t)
+        {
+            grid.clear();
+            const auto start = Clock::now();
+            for (int i = 0; i < ENTITIES; ++i)
+            {
+                const auto& [x, y, w, h] = rects[i];
+                grid.insert(static_cast<entt::entity>(i), x, y, w, h);
+            }
+            const auto inserted = Clock::now();
+            for (const auto& [x, y, w, h] : rects)
+            {
+                grid.query(found, x, y, w, h);
+                total += found.size();
+                found.clear();
+            }
+            insertTime += inserted - start;
+            queryTime += Clock::now() - inserted;
+        }
+        REQUIRE(total >= static_cast<size_t>(ENTITIES) * TICKS); // Each finds at least itself
+        const auto toMs = [](const Clock::duration d)
+        { return std::chrono::duration<double, std::milli>(d).count() / TICKS; };
+        return {toMs(insertTime), toMs(queryTime)};
+    }
+} // namespace
+
+TEST_CASE("Entity grid backend benchmark", "[.][benchmark]")
+{
+    const auto rects = CreateRects();
+
+    EntityHashGrid hashed;
+    hashed.setCellSize(MAGIQUE_COLLISION_CELL_SIZE);
+    const auto [hashedInsert, hashedQuery] = RunGrid(hashed, rects);
+
+    EntityHashGrid dense;
+    dense.setCellSize(MAGIQUE_COLLISION_CELL_SIZE);
+    REQUIRE(dense.setDenseBounds(-250, -250, 4500, 4500, DynamicCollisionData::MAX_DENSE_CELLS));
+    const auto [denseInsert, denseQuery] = RunGrid(dense, rects);
+
+    LOG_INFO("Hashed: %.2f ms | %.2f ms", hashedInsert, hashedQuery);
+    LOG_INFO("Dense:  %.2f ms | %.2f ms", denseInsert, denseQuery);
+}
@@ -0,0 +1,94 @@
+#include <catch_amalgamated.hpp>
+#include <utility>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    // Spaced out so they never collide - the actor is in the middle
+    void CreateEntityRaster(const float size, const float spacing)
+    {
+        GiveActor(test::CreateRectEntity(TEST_ACTOR, 0, 0, 10, 10));
+        for (int i = -7; i <= 7; ++i)
+        {
+            for (int j = -7; j <= 7; ++j)
+            {
+                if (i != 0 || j != 0)
+                    test::CreateRectEntity(TEST_OBJECT, spacing * j, spacing * i, size, size);
+            }
+        }
+    }
+
+    const EntityHashGrid& GetGrid() { return global::DY_COLL_DATA.mapEntityGrids[MapID(0)]; }
+} // namespace
+
+TEST_CASE("Entity grid cell size is applied on the next tick")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+    test::ResetEngine();
+    const int defaultSize = GetEntityGridCellSize(MapID(0));
+    CreateEntityRaster(100, 150);
+    test::RunCollisionTick();
+    REQUIRE(GetGrid().getCellSize() == defaultSize);
+
+    SetEntityGridCellSize(MapID(0), 128);
+    REQUIRE(GetEntityGridCellSize(MapID(0)) == 128);
+    REQUIRE(GetGrid().getCellSize() == defaultSize); // Grid of this tick is kept
+    test::RunCollisionTick();
+    REQUIRE(GetGrid().getCellSize() == 128);
+    REQUIRE(GetGrid().coarseElements.empty()); // All fit into the base level now
+    REQUIRE(GetNearbyEntities(MapID(0), {300, 300}, 10).size() == 1);
+
+    // Out of range sizes are ignored
+    SetEntityGridCellSize(MapID(0), 4);
+    SetEntityGridCellSize(MapID(0), 5000);
+    REQUIRE(GetEntityGridCellSize(MapID(0)) == 128);
+
+    SetEntityGridCellSize(MapID(0), 16);
+    test::RunCollisionTick();
+    REQUIRE(GetGrid().getCellSize() == 16);
+    REQUIRE(GetGrid().coarseElements.size() == 224);
+    REQUIRE(GetNearbyEntities(MapID(0), {300, 300}, 10).size() == 1);
+
+    SetEntityGridCellSize(MapID(0), defaultSize);
+    test::ResetEngine();
+}
+
+TEST_CASE("Entity grid auto tuning converges after the sample ticks")
+{
+    internal::InitJobSystem();
+    WakeUpJobs();
+    test::ResetEngine();
+    const int defaultSize = GetEntityGridCellSize(MapID(0));
+    constexpr int sampleTicks = CellSizeTuner::SAMPLE_TICKS;
+
+    // Cells of about twice the entity size - for both directions
+    for (const auto [entitySize, expected] : {std::pair{20.0F, 64}, std::pair{100.0F, 256}})
+    {
+        test::ResetEngine();
+        SetEntityGridCellSize(MapID(0), 16);
+        CreateEntityRaster(entitySize, entitySize * 2);
+        SetEntityGridAutoTune(true);
+        for (int i = 0; i < sampleTicks - 1; ++i)
+            test::RunCollisionTick();
+        REQUIRE(GetEntityGridCellSize(MapID(0)) == 16);
+
+        test::RunCollisionTick(); // Chosen at the end of the tick
+        REQUIRE(GetEntityGridCellSize(MapID(0)) == expected);
+        REQUIRE(GetGrid().getCellSize() == 16);
+        test::RunCollisionTick();
+        REQUIRE(GetGrid().getCellSize() == expected);
+
+        // Stays once converged
+        for (int i = 0; i < sampleTicks; ++i)
+            test::RunCollisionTick();
+        REQUIRE(GetEntityGridCellSize(MapID(0)) == expected);
+        SetEntityGridAutoTune(false);
+    }
+
+    SetEntityGridCellSize(MapID(0), defaultSize);
+    test::ResetEngine();
+}
@@ -0,0 +1,248 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    // Actor in the middle so everything within 1250 is in update range
+    void SetupQueryWorld(const int count, const float maxSize, const unsigned seed)
+    {
+        GiveActor(test::CreateRectEntity(TEST_ACTOR, 0, 0, 10, 10));
+
+        std::mt19937 gen{seed};
+        std::uniform_real_distribution<float> pos{-1000.0F, 1000.0F};
+        std::uniform_real_distribution<float> size{2.0F, maxSize};
+        for (int i = 0; i < count; ++i)
+        {
+            test::CreateRectEntity(TEST_OBJECT, pos(gen), pos(gen), size(gen), size(gen));
+        }
+        test::RunCollisionTick();
+    }
+
+    std::vector<entt::entity> Sorted(auto&& range)
+    {
+        std::vector<entt::entity> result{range.begin(), range.end()};
+        std::ranges::sort(result);
+        return result;
+    }
+
+    // Cells of GetNearbyEntities() can hold entities outside the square - only keeps the ones overlapping it
+    std::vector<entt::entity> NearbyInSquare(const Point mid, const float size)
+    {
+        std::vector<entt::entity> result;
+        for (const auto e : GetNearbyEntities(MapID(0), mid, size))
+        {
+            const auto bb = GetEntityBoundingBox(GetComponent<PositionC>(e), GetComponent<CollisionC>(e));
+            if (RectToRect(mid.x - size / 2.0F, mid.y - size / 2.0F, size, size, bb.x, bb.y, bb.width, bb.height))
+                result.push_back(e);
+        }
+        std::ranges::sort(result);
+        return result;
+    }
+
+    // Same as the engine - distance to the closest point of the bounding box
+    float DistanceTo(const Point p, const entt::entity e)
+    {
+        const auto r = GetEntityBoundingBox(GetComponent<PositionC>(e), GetComponent<CollisionC>(e));
+        const float dx = std::max(std::max(r.x - p.x, p.x - (r.x + r.width)), 0.0F);
+        const float dy = std::max(std::max(r.y - p.y, p.y - (r.y + r.height)), 0.0F);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    std::vector<entt::entity> AllEntities()
+    {
+        std::vector<entt::entity> result;
+        for (const auto e : GetRegistry().view<CollisionC>())
+            result.push_back(e);
+        return result;
+    }
+
+    // Large entities end up on the coarse levels - a few are aligned to the base cells
+    void AddLargeEntities(std::mt19937& gen)
+    {
+        std::uniform_real_distribution<float> pos{-1000.0F, 1000.0F};
+        std::uniform_real_distribution<float> size{150.0F, 900.0F};
+        for (int i = 0; i < 20; ++i)
+            test::CreateRectEntity(TEST_OTHER, pos(gen), pos(gen), size(gen), size(gen));
+        test::CreateRectEntity(TEST_OTHER, -900, -40, 1800, 80); // Level 2
+        test::CreateRectEntity(TEST_OTHER, -20, -1000, 60, 1500);
+        const auto cell = static_cast<float>(global::DY_COLL_DATA.mapEntityGrids[MapID(0)].getCellSize());
+        for (int i = -5; i < 5; ++i)
+        {
+            const auto x = cell * static_cast<float>(i * 3);
+            test::CreateRectEntity(TEST_OTHER, x, cell * static_cast<float>(i), cell * 2, cell);
+        }
+        test::RunCollisionTick();
+        LogicSystem(GetRegistry()); // Rebuilds the grid with the positions after the collisions were resolved
+    }
+
+    // Compares the hits with RayToRect against every entity
+    void RequireSameRaycast(const Point origin, const Point dir, const float maxDist)
+    {
+        const float length = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+        const Point norm = {dir.x / length, dir.y / length};
+        std::vector<std::pair<float, entt::entity>> expected;
+        for (const auto e : AllEntities())
+        {
+            const auto bb = GetEntityBoundingBox(GetComponent<PositionC>(e), GetComponent<CollisionC>(e));
+            float dist = 0;
+            if (RayToRect(origin.x, origin.y, norm.x, norm.y, maxDist, bb.x, bb.y, bb.width, bb.height, dist))
+                expected.emplace_back(dist, e);
+        }
+        std::ranges::sort(expected);
+
+        const auto& hits = RaycastEntities(MapID(0), origin, dir, maxDist);
+        REQUIRE(hits.size() == expected.size());
+        for (int i = 0; i < static_cast<int>(hits.size()); ++i)
+            REQUIRE(hits[i].distance == expected[i].first);
+        std::vector<entt::entity> expectedEntities;
+        for (const auto& [dist, e] : expected)
+            expectedEntities.push_back(e);
+        std::ranges::sort(expectedEntities);
+        REQUIRE(Sorted(hits | std::views::transform(&RaycastHit::entity)) == expectedEntities);
+
+        constexpr int maxHits = 3;
+        const auto& closest = RaycastEntities(MapID(0), origin, dir, maxDist, maxHits);
+        REQUIRE(static_cast<int>(closest.size()) == std::min(maxHits, static_cast<int>(expected.size())));
+        for (int i = 0; i < static_cast<int>(closest.size()); ++i)
+            REQUIRE(closest[i].distance == expected[i].first);
+    }
+
+    // Compares with the k closest entities of all that pass the filter
+    void RequireSameNearest(const Point pos, const int k, const std::function<bool(entt::entity)>& filter,
+                            const float maxDist)
+    {
+        std::vector<float> expected;
+        for (const auto e : AllEntities())
+        {
+            const float dist = DistanceTo(pos, e);
+            if ((!filter || filter(e)) && dist <= maxDist)
+                expected.push_back(dist);
+        }
+        std::ranges::sort(expected);
+        expected.resize(std::min(expected.size(), static_cast<size_t>(k)));
+
+        const auto& nearest = FindKNearest(MapID(0), pos, k, filter, maxDist);
+        std::vector<float> distances;
+        for (const auto e : nearest)
+        {
+            REQUIRE((!filter || filter(e)));
+            distances.push_back(DistanceTo(pos, e));
+        }
+        REQUIRE(distances == expected); // Ties can be any of the entities
+    }
+} // namespace
+
+TEST_CASE("Batched entity queries match the single queries")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+    test::ResetEngine();
+    SetupQueryWorld(2000, 120.0F, 7);
+
+    std::mt19937 gen{11};
+    std::uniform_real_distribution<float> pos{-1100.0F, 1100.0F};
+    std::uniform_real_distribution<float> size{0.0F, 300.0F};
+    // Below and above the threshold for the parallel path
+    for (const int count : {SpatialQueryData::MIN_PARALLEL_QUERIES - 1, SpatialQueryData::MIN_PARALLEL_QUERIES * 4 + 3})
+    {
+        std::vector<EntityQuery> queries;
+        for (int i = 0; i < count; ++i)
+        {
+            queries.push_back({{pos(gen), pos(gen)}, size(gen), i % 2 == 0});
+        }
+        queries[count / 2].size = 0; // Empty queries keep their slot
+
+        const auto& results = QueryEntitiesBatch(MapID(0), queries);
+        REQUIRE(results.getQueryCount() == count);
+        int found = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& query = queries[i];
+            const auto batch = Sorted(results.get(i));
+            found += static_cast<int>(batch.size());
+            if (query.size == 0)
+            {
+                REQUIRE(batch.empty());
+            }
+            else if (query.isCircle)
+            {
+                REQUIRE(batch == Sorted(GetEntitiesInCircle(MapID(0), query.mid, query.size)));
+            }
+            else
+            {
+                REQUIRE(batch == NearbyInSquare(query.mid, query.size));
+            }
+        }
+        REQUIRE(found > count); // Not trivially empty
+    }
+
+    // Unknown maps return an empty result for each query
+    const std::vector<EntityQuery> queries(5, EntityQuery{{0, 0}, 100});
+    const auto& results = QueryEntitiesBatch(MapID(3), queries);
+    REQUIRE(results.getQueryCount() == 5);
+    REQUIRE(results.get(4).empty());
+    test::ResetEngine();
+}
+
+TEST_CASE("Spatial queries match a brute force search")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+    test::ResetEngine();
+    SetupQueryWorld(1500, 60.0F, 3);
+    std::mt19937 gen{17};
+    AddLargeEntities(gen);
+    REQUIRE_FALSE(global::DY_COLL_DATA.mapEntityGrids[MapID(0)].coarseElements.empty());
+
+    std::uniform_real_distribution<float> pos{-1100.0F, 1100.0F};
+    std::uniform_real_distribution<float> radius{1.0F, 400.0F};
+    std::uniform_real_distribution<float> angle{0.0F, 2.0F * PI};
+    std::uniform_real_distribution<float> dist{1.0F, 2000.0F};
+    for (int i = 0; i < 150; ++i)
+    {
+        const Point mid = {pos(gen), pos(gen)};
+        const float r = radius(gen);
+        std::vector<entt::entity> expected;
+        for (const auto e : AllEntities())
+        {
+            if (DistanceTo(mid, e) <= r)
+                expected.push_back(e);
+        }
+        std::ranges::sort(expected);
+        REQUIRE(Sorted(GetEntitiesInCircle(MapID(0), mid, r)) == expected);
+
+        const float a = angle(gen);
+        RequireSameRaycast(mid, {std::cos(a), std::sin(a)}, dist(gen));
+        RequireSameNearest(mid, 1 + i % 20, nullptr, radius(gen) * 2.0F);
+    }
+
+    // Rays along the cell borders and through cell corners
+    const auto cell = static_cast<float>(global::DY_COLL_DATA.mapEntityGrids[MapID(0)].getCellSize());
+    for (int i = -8; i <= 8; ++i)
+    {
+        const float border = cell * static_cast<float>(i);
+        RequireSameRaycast({border, -1000}, {0, 1}, 2000);
+        RequireSameRaycast({border, 1000}, {0, -1}, 2000);
+        RequireSameRaycast({-1000, border}, {1, 0}, 2000);
+        RequireSameRaycast({1000, border}, {-1, 0}, 2000);
+        RequireSameRaycast({border, border}, {1, 1}, 1500);
+        RequireSameRaycast({border, -border}, {-1, 1}, 1500);
+    }
+
+    // More than there are - also only the ones passing the filter
+    const auto isLarge = [](const entt::entity e) { return GetComponent<PositionC>(e).type == TEST_OTHER; };
+    RequireSameNearest({0, 0}, 10'000, nullptr, 3000);
+    REQUIRE(FindKNearest(MapID(0), {0, 0}, 10'000, nullptr, 3000).size() == AllEntities().size());
+    RequireSameNearest({300, -300}, 10'000, isLarge, 800);
+    RequireSameNearest({-700, 500}, 4, isLarge, 1000);
+    REQUIRE(FindKNearest(MapID(0), {0, 0}, 0).empty());
+    test::ResetEngine();
+}
@@ -0,0 +1,119 @@
+#include <catch_amalgamated.hpp>
+#include <vector>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    enum EventKind : uint8_t
+    {
+        DYNAMIC,
+        ENTER,
+    };
+
+    struct Entry final
+    {
+        int other; // Creation index of the other entity
+        EventKind kind;
+        bool operator==(const Entry&) const = default;
+    };
+
+    // Only read during the tick - each log is only written by the thread that dispatches the entity
+    magique::HashMap<entt::entity, int> INDICES;
+    std::vector<std::vector<Entry>> LOGS;
+    magique::HashSet<entt::entity> VICTIMS;
+    magique::HashMap<entt::entity, int> LOG_SIZE_AT_DESTROY;
+
+    void Log(const entt::entity self, const entt::entity other, const EventKind kind)
+    {
+        LOGS[INDICES.at(self)].push_back({INDICES.at(other), kind});
+    }
+
+    struct LogScript final : EntityScript
+    {
+        bool threadSafe;
+        explicit LogScript(const bool threadSafe) : threadSafe(threadSafe) {}
+
+        void onDynamicCollision(entt::entity self, entt::entity other, CollisionInfo&) override
+        {
+            Log(self, other, DYNAMIC);
+            // Only the serial script destroys
+            if (!threadSafe)
+            {
+                for (const auto victim : VICTIMS)
+                {
+                    if (EntityExists(victim))
+                    {
+                        LOG_SIZE_AT_DESTROY[victim] = static_cast<int>(LOGS[INDICES.at(victim)].size());
+                        DestroyEntity(victim);
+                    }
+                }
+            }
+        }
+        void onCollisionEnter(entt::entity self, entt::entity other, const CollisionInfo&) override
+        {
+            Log(self, other, ENTER);
+        }
+        [[nodiscard]] bool isThreadSafe() const override { return threadSafe; }
+    };
+
+    // 20x20 overlapping entities - each touches its 8 neighbours
+    // A few entities use a serial script which destroys the victim - a direct neighbour or a remote entity
+    std::vector<std::vector<Entry>> RunDispatch(const bool parallel, const bool remoteVictim)
+    {
+        test::ResetEngine();
+        SetEntityScript(TEST_OBJECT, new LogScript(true));
+        SetEntityScript(TEST_OTHER, new LogScript(false));
+        SetParallelCollisionEvents(parallel);
+        GiveActor(CreateEntity(TEST_ACTOR, -500, -500, MapID(0), 0, false));
+
+        INDICES.clear();
+        VICTIMS.clear();
+        LOG_SIZE_AT_DESTROY.clear();
+        constexpr int side = 20;
+        for (int i = 0; i < side * side; ++i)
+        {
+            const bool serial = i == 42 || i == 210 || i == 377;
+            const auto x = static_cast<float>(i % side) * 10.0F;
+            const auto y = static_cast<float>(i / side) * 10.0F;
+            const auto e = test::CreateRectEntity(serial ? TEST_OTHER : TEST_OBJECT, x, y, 12, 12);
+            INDICES[e] = i;
+            if ((!remoteVictim && i == 43) || (remoteVictim && i == 300)) // 300 doesn't touch a serial entity
+                VICTIMS.insert(e);
+        }
+        LOGS.assign(side * side, {});
+        test::RunCollisionTick();
+        return LOGS;
+    }
+} // namespace
+
+TEST_CASE("Parallel collision events keep the per entity order and skip destroyed entities")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+
+    const auto serial = RunDispatch(false, false);
+    const int victimSize = LOG_SIZE_AT_DESTROY.at(*VICTIMS.begin());
+    const int victimIndex = INDICES.at(*VICTIMS.begin());
+    const auto parallel = RunDispatch(true, false);
+    REQUIRE(global::DY_COLL_DATA.parallelPairs.empty());
+
+    int events = 0;
+    for (int i = 0; i < static_cast<int>(serial.size()); ++i)
+    {
+        REQUIRE(serial[i] == parallel[i]);
+        events += static_cast<int>(serial[i].size());
+    }
+    REQUIRE(events > 4000); // Enough pairs for batches that run on the workers
+    REQUIRE(static_cast<int>(serial[victimIndex].size()) == victimSize); // Nothing after it was destroyed
+    REQUIRE(LOG_SIZE_AT_DESTROY.size() == 1);
+
+    // Destroyed by a serial event while its pairs are still waiting in a batch - those are skipped
+    const auto remote = RunDispatch(true, true);
+    REQUIRE(LOG_SIZE_AT_DESTROY.size() == 1);
+    const int remoteIndex = INDICES.at(*VICTIMS.begin());
+    REQUIRE(static_cast<int>(remote[remoteIndex].size()) == LOG_SIZE_AT_DESTROY.begin()->second);
+    test::ResetEngine();
+}
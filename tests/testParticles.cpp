@@ -0,0 +1,214 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <raylib/raylib.h>
+
+#include <magique/core/Particles.h>
+#include <magique/util/JobSystem.h>
+
+#include "internal/globals/ParticleData.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int MILLION = 1'000'000;
+
+    // Moves straight to the right and falls down - no randomness
+    ScreenEmitter CreateEmitter(const int lifeTime)
+    {
+        ScreenEmitter emitter;
+        emitter.setDirection({1, 0});
+        emitter.setVelocityRange(2.0F);
+        emitter.setGravity(0, 30.0F);
+        emitter.setLifetime(lifeTime);
+        return emitter;
+    }
+
+    double MillisSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+TEST_CASE("Particles move and expire the same as whole particles")
+{
+    global::PARTICLE_DATA = ParticleData{};
+    const auto& rects = global::PARTICLE_DATA.rectangles;
+
+    static const auto longEmitter = CreateEmitter(10);
+    static const auto shortEmitter = CreateEmitter(5);
+    const Point start{100, 100};
+    CreateScreenParticle(longEmitter, start, 37); // Not a multiple of any vector width
+    CreateScreenParticle(shortEmitter, start, 20);
+    REQUIRE(rects.size() == 57);
+
+    const float gravity = longEmitter.getData().gravY;
+    for (int tick = 1; tick <= 5; ++tick)
+    {
+        global::PARTICLE_DATA.update();
+        REQUIRE(rects.size() == 57);
+        for (int i = 0; i < rects.size(); ++i)
+        {
+            REQUIRE(rects.age[i] == tick);
+            REQUIRE(rects.x[i] == Catch::Approx(start.x + 2.0F * tick));
+            REQUIRE(rects.y[i] == Catch::Approx(start.y + gravity * tick * (tick - 1) / 2.0F));
+            REQUIRE(rects.vy[i] == Catch::Approx(gravity * tick));
+        }
+    }
+
+    // Short lived particles are removed on the tick after they reached their lifetime
+    global::PARTICLE_DATA.update();
+    REQUIRE(rects.size() == 37);
+    for (int i = 0; i < rects.size(); ++i)
+    {
+        REQUIRE(rects.emitter[i] == &longEmitter);
+    }
+
+    for (int tick = 7; tick <= 10; ++tick)
+    {
+        global::PARTICLE_DATA.update();
+    }
+    REQUIRE(rects.size() == 37);
+    global::PARTICLE_DATA.update();
+    REQUIRE(rects.size() == 0);
+}
+
+TEST_CASE("Particle functions get the normalized time and can change the particle")
+{
+    global::PARTICLE_DATA = ParticleData{};
+    const auto& rects = global::PARTICLE_DATA.rectangles;
+
+    static auto emitter = CreateEmitter(4);
+    static float lastTime = -1;
+    static auto plainEmitter = CreateEmitter(4);
+    emitter.setScaleFunction(
+        [](float, const float t)
+        {
+            lastTime = t;
+            return 1.0F + t;
+        });
+    emitter.setTickFunction([](ScreenParticle& p, float) { p.vx = 0; });
+
+    CreateScreenParticle(plainEmitter, {}, 10);
+    CreateScreenParticle(emitter, {}, 10);
+    for (int tick = 0; tick < 4; ++tick)
+    {
+        global::PARTICLE_DATA.update();
+        REQUIRE(lastTime == Catch::Approx(tick / 4.0F));
+    }
+
+    REQUIRE(rects.size() == 20);
+    for (int i = 0; i < rects.size(); ++i)
+    {
+        if (rects.emitter[i] == &emitter)
+        {
+            REQUIRE(rects.scale[i] == Catch::Approx(1.75F));
+            REQUIRE(rects.vx[i] == 0);
+            REQUIRE(rects.x[i] == Catch::Approx(2.0F)); // Only moved in the first tick
+        }
+        else
+        {
+            REQUIRE(rects.scale[i] == 1.0F);
+            REQUIRE(rects.x[i] == Catch::Approx(8.0F));
+        }
+    }
+    global::PARTICLE_DATA = ParticleData{};
+}
+
+TEST_CASE("A million particles update on a single core")
+{
+    global::PARTICLE_DATA = ParticleData{};
+    const auto& rects = global::PARTICLE_DATA.rectangles;
+
+    static const auto emitter = CreateEmitter(1000);
+    CreateScreenParticle(emitter, {}, MILLION);
+    REQUIRE(rects.size() == MILLION);
+
+    constexpr int ticks = 100;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ticks; ++i)
+    {
+        global::PARTICLE_DATA.update(1);
+    }
+    const double perTick = MillisSince(start) / ticks;
+
+    // Only reported - unoptimized builds don't fit into the tick
+    WARN("1M particles: " << perTick << " ms per tick | " << MILLION / perTick / 1000.0 << " M particles/s | Budget: "
+                          << 1000.0 / MAGIQUE_LOGIC_TICKS << " ms");
+    REQUIRE(rects.size() == MILLION);
+    REQUIRE(rects.age[0] == ticks);
+    global::PARTICLE_DATA = ParticleData{};
+}
+
+TEST_CASE("Particle parts updated by the workers are stitched together")
+{
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+
+    global::PARTICLE_DATA = ParticleData{};
+    static auto emitter = CreateEmitter(1);
+    emitter.setLifetime(1, 30);
+    emitter.setEmissionShape(Shape::RECT, 1000, 1000);
+    CreateScreenParticle(emitter, {}, MILLION / 10);
+    auto single = global::PARTICLE_DATA;
+
+    // Same particles with a different order
+    const auto sorted = [](const ParticleStreams& rects)
+    {
+        std::vector<std::tuple<float, float, float, uint16_t>> result;
+        for (int i = 0; i < rects.size(); ++i)
+        {
+            result.emplace_back(rects.x[i], rects.y[i], rects.vy[i], rects.age[i]);
+        }
+        std::ranges::sort(result);
+        return result;
+    };
+
+    // All parts even if they share cores - only the result is compared
+    for (int tick = 0; tick < 31; ++tick) // A lifetime of 30 is still alive after 30 ticks
+    {
+        global::PARTICLE_DATA.update(ParticleData::MAX_PARTS);
+        single.update(1);
+        REQUIRE(global::PARTICLE_DATA.rectangles.size() == single.rectangles.size());
+        if (tick % 5 == 0)
+        {
+            REQUIRE(sorted(global::PARTICLE_DATA.rectangles) == sorted(single.rectangles));
+        }
+    }
+    REQUIRE(global::PARTICLE_DATA.rectangles.size() == 0);
+
+    // By default there are never more parts than cores
+    global::PARTICLE_DATA = ParticleData{};
+    emitter.setLifetime(1000);
+    CreateScreenParticle(emitter, {}, MILLION);
+    const int usable = ParticleData::getUsableParts();
+    REQUIRE(usable >= 1);
+    REQUIRE(usable <= static_cast<int>(std::max(1U, std::thread::hardware_concurrency())));
+    global::PARTICLE_DATA.startUpdate();
+    REQUIRE(global::PARTICLE_DATA.getParts() == std::min(usable, MILLION / ParticleData::MIN_PART_SIZE));
+    global::PARTICLE_DATA.finishUpdate();
+
+    // Scaling with the amount of threads that run at the same time
+    std::array<double, ParticleData::MAX_PARTS> perTick{};
+    constexpr int ticks = 10;
+    for (int parts = 1; parts <= usable; ++parts)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ticks; ++i)
+        {
+            global::PARTICLE_DATA.update(parts);
+        }
+        perTick[parts - 1] = MillisSince(start) / ticks;
+        UNSCOPED_INFO("1M particles with " << parts << " thread(s): " << perTick[parts - 1] << " ms per tick");
+    }
+    REQUIRE(global::PARTICLE_DATA.rectangles.size() == MILLION);
+    if (usable > 1)
+    {
+        CHECK(perTick[usable - 1] < perTick[0]);
+    }
+    global::PARTICLE_DATA = ParticleData{};
+}
@@ -0,0 +1,1147 @@
+#include <catch_amalgamated.hpp>
+#include <chrono>
+#include <queue>
+#include <random>
+#include <set>
+#include <raylib/raylib.h>
+
+#include <magique/core/Types.h>
+#include <magique/core/StaticCollision.h>
+#include <magique/gamedev/PathFinding.h>
+#include <magique/util/JobSystem.h>
+
+#include "internal/globals/StaticCollisionData.h"
+#include "internal/globals/PathFindingData.h"
+#include "internal/globals/EngineData.h"
+#include "internal/systems/PathRequestSystem.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int MAP_SIZE = 64; // In pathfinding cells
+    constexpr int CELL = MAGIQUE_PATHFINDING_CELL_SIZE;
+    constexpr uint16_t MAX_LEN = 400;
+
+    enum class MapType
+    {
+        OPEN,  // Few scattered pillars
+        MAZE,  // Small rooms connected by single doors
+        MIXED, // Big rooms with random obstacles
+    };
+
+    // Fills the static grid of the map - the map is enclosed by walls
+    std::vector<uint8_t> CreateMap(const MapID map, const MapType type, const uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<uint8_t> cells(MAP_SIZE * MAP_SIZE, 0);
+        for (int i = 0; i < MAP_SIZE; ++i)
+        {
+            for (int j = 0; j < MAP_SIZE; ++j)
+            {
+                bool solid = false;
+                switch (type)
+                {
+                case MapType::OPEN:
+                    solid = rng() % 100 < 3;
+                    break;
+                case MapType::MAZE:
+                    solid = (i % 6 == 0 || j % 6 == 0) && rng() % 100 < 85;
+                    break;
+                case MapType::MIXED:
+                    solid = ((i % 16 == 0 || j % 16 == 0) && i % 16 != 8 && j % 16 != 8) || rng() % 100 < 12;
+                    break;
+                }
+                cells[i * MAP_SIZE + j] = solid ? 1 : 0;
+            }
+        }
+
+        auto& grid = global::PATH_DATA.mapsStaticGrids[map];
+        grid.clear();
+        for (int i = -1; i <= MAP_SIZE; ++i)
+        {
+            for (int j = -1; j <= MAP_SIZE; ++j)
+            {
+                const bool inside = i >= 0 && j >= 0 && i < MAP_SIZE && j < MAP_SIZE;
+                if (!inside || cells[i * MAP_SIZE + j] != 0)
+                    grid.setMarked(static_cast<float>(j * CELL), static_cast<float>(i * CELL));
+            }
+        }
+        global::STATIC_COLL_DATA.mapBounds[map] = {0, 0, MAP_SIZE * CELL, MAP_SIZE * CELL};
+        global::PATH_DATA.markStaticGridChanged(map);
+        return cells;
+    }
+
+    // Exact shortest path costs with the same movement and costs as the pathfinding - stops early at the end cell
+    std::vector<float> DijkstraCosts(const std::vector<uint8_t>& cells, const int start, const int end = -1,
+                                     const int size = MAP_SIZE)
+    {
+        std::vector<float> dist(cells.size(), std::numeric_limits<float>::max());
+        using Entry = std::pair<float, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+        dist[start] = 0;
+        queue.emplace(0.0F, start);
+        while (!queue.empty())
+        {
+            const auto [cost, idx] = queue.top();
+            queue.pop();
+            if (idx == end)
+                break;
+            if (cost > dist[idx])
+                continue;
+            const int x = idx % size;
+            const int y = idx / size;
+            for (const auto& dir : MOVEMENTS[(int)GridMode::STAR])
+            {
+                const int nx = x + static_cast<int>(dir.x);
+                const int ny = y + static_cast<int>(dir.y);
+                if (nx < 0 || ny < 0 || nx >= size || ny >= size || cells[ny * size + nx] != 0)
+                    continue;
+                const float newCost = cost + MOVE_COST[(int)GridMode::STAR](dir);
+                if (newCost < dist[ny * size + nx])
+                {
+                    dist[ny * size + nx] = newCost;
+                    queue.emplace(newCost, ny * size + nx);
+                }
+            }
+        }
+        return dist;
+    }
+
+    // Negative if unreachable
+    float DijkstraCost(const std::vector<uint8_t>& cells, const int start, const int end, const int size = MAP_SIZE)
+    {
+        const float cost = DijkstraCosts(cells, start, end, size)[end];
+        return cost == std::numeric_limits<float>::max() ? -1.0F : cost;
+    }
+
+    // Cost of the returned path - fails if it contains invalid steps
+    float PathCost(const std::vector<uint8_t>& cells, const std::vector<Point>& path, const Point start,
+                   const int size = MAP_SIZE)
+    {
+        float cost = 0;
+        Point prev = {std::floor(start.x / CELL), std::floor(start.y / CELL)};
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+        {
+            const Point cell = {std::floor(it->x / CELL), std::floor(it->y / CELL)};
+            const Point dir = {cell.x - prev.x, cell.y - prev.y};
+            REQUIRE(std::abs(dir.x) <= 1);
+            REQUIRE(std::abs(dir.y) <= 1);
+            REQUIRE(cells[static_cast<int>(cell.y) * size + static_cast<int>(cell.x)] == 0);
+            cost += MOVE_COST[(int)GridMode::STAR](dir);
+            prev = cell;
+        }
+        return cost;
+    }
+
+    struct Query final
+    {
+        Point start;
+        Point end;
+        float optimalCost;
+    };
+
+    std::vector<Query> CreateQueries(const std::vector<uint8_t>& cells, const uint32_t seed, const int count)
+    {
+        std::mt19937 rng(seed);
+        std::vector<Query> queries;
+        while (static_cast<int>(queries.size()) < count)
+        {
+            const int start = static_cast<int>(rng() % cells.size());
+            const int end = static_cast<int>(rng() % cells.size());
+            if (start == end || cells[start] != 0 || cells[end] != 0)
+                continue;
+            const float cost = DijkstraCost(cells, start, end);
+            if (cost < 0)
+                continue;
+            const auto toPoint = [](const int idx)
+            {
+                const auto x = static_cast<float>(idx % MAP_SIZE * CELL);
+                const auto y = static_cast<float>(idx / MAP_SIZE * CELL);
+                return Point{x + 1, y + 1};
+            };
+            queries.push_back({toPoint(start), toPoint(end), cost});
+        }
+        return queries;
+    }
+
+    struct Result final
+    {
+        int found = 0;
+        int expanded = 0;
+        double millis = 0;
+        float cost = 0; // Summed cost of found paths
+    };
+
+    template <typename Func>
+    Result RunQueries(const std::vector<uint8_t>& cells, const std::vector<Query>& queries, Func func)
+    {
+        Result result;
+        std::vector<Point> path;
+        for (const auto& query : queries)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const bool found = func(path, query);
+            result.millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            result.expanded += global::PATH_DATA.expandedNodes;
+            if (!found)
+                continue;
+            ++result.found;
+            result.cost += PathCost(cells, path, query.start);
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Jump point search finds the shortest paths with fewer expanded nodes")
+{
+    const auto map = static_cast<MapID>(0);
+    auto& data = global::PATH_DATA;
+
+    const auto aStar = [&](std::vector<Point>& path, const Query& q)
+    { return data.findPath(path, q.start, q.end, map, MAX_LEN, GridMode::STAR); };
+    const auto jump = [&](std::vector<Point>& path, const Query& q)
+    { return data.findJumpPath(path, q.start, q.end, map, MAX_LEN); };
+
+    for (const auto type : {MapType::OPEN, MapType::MAZE, MapType::MIXED})
+    {
+        const char* name = type == MapType::OPEN ? "Open" : type == MapType::MAZE ? "Maze" : "Mixed";
+        for (uint32_t seed = 1; seed <= 3; ++seed)
+        {
+            const auto cells = CreateMap(map, type, seed);
+            const auto queries = CreateQueries(cells, seed, 200);
+
+            const auto aStarResult = RunQueries(cells, queries, aStar);
+
+            // Without table - the same as with dynamic solids
+            global::STATIC_COLL_DATA.mapBounds.erase(map);
+            const auto jumpResult = RunQueries(cells, queries, jump);
+            global::STATIC_COLL_DATA.mapBounds[map] = {0, 0, MAP_SIZE * CELL, MAP_SIZE * CELL};
+
+            REQUIRE(data.getJumpTable(map) != nullptr); // Builds it
+            const auto tableResult = RunQueries(cells, queries, jump);
+
+            INFO(name << " map (seed " << seed << ") - " << queries.size() << " queries");
+            INFO("A*      : " << aStarResult.found << " found | " << aStarResult.expanded << " expanded | "
+                              << aStarResult.millis << " ms");
+            INFO("JPS     : " << jumpResult.found << " found | " << jumpResult.expanded << " expanded | "
+                              << jumpResult.millis << " ms");
+            INFO("JPS+    : " << tableResult.found << " found | " << tableResult.expanded << " expanded | "
+                              << tableResult.millis << " ms");
+
+            // Jump point search always finds the optimal path
+            float optimalCost = 0;
+            for (const auto& query : queries)
+                optimalCost += query.optimalCost;
+            REQUIRE(jumpResult.found == static_cast<int>(queries.size()));
+            REQUIRE(tableResult.found == static_cast<int>(queries.size()));
+            REQUIRE(jumpResult.cost == Catch::Approx(optimalCost));
+            REQUIRE(tableResult.cost == Catch::Approx(optimalCost));
+            for (const auto& query : queries)
+            {
+                std::vector<Point> path;
+                REQUIRE(jump(path, query));
+                REQUIRE(PathCost(cells, path, query.start) == Catch::Approx(query.optimalCost));
+                if (aStar(path, query)) // Weighted heuristic - not always the shortest
+                    REQUIRE(PathCost(cells, path, query.start) >= query.optimalCost - 0.001F);
+            }
+
+            // The table only skips the scanning - same jump points
+            REQUIRE(tableResult.expanded == jumpResult.expanded);
+            REQUIRE(jumpResult.expanded < aStarResult.expanded);
+        }
+    }
+
+    data.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Hierarchical pathfinding finds long paths and rebuilds only changed clusters")
+{
+    constexpr int size = 256; // 16x16 clusters
+    const auto map = static_cast<MapID>(1);
+    auto& data = global::PATH_DATA;
+    SetStaticWorldBounds({0, 0, size * CELL, size * CELL});
+
+    // Rooms with doors and random pillars
+    std::mt19937 rng(7);
+    ManualColliderGroup walls;
+    for (int i = 0; i < size; i += 24)
+    {
+        for (int j = 0; j < size; j += 8)
+        {
+            if (rng() % 4 != 0)
+                walls.addRect(j * CELL + 0.5F, i * CELL + 0.5F, 8 * CELL - 1, CELL - 1);
+            if (rng() % 4 != 0)
+                walls.addRect(i * CELL + 0.5F, j * CELL + 0.5F, CELL - 1, 8 * CELL - 1);
+        }
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        const auto x = static_cast<float>(rng() % size);
+        const auto y = static_cast<float>(rng() % size);
+        walls.addRect(x * CELL + 0.5F, y * CELL + 0.5F, CELL - 1, CELL - 1);
+    }
+    AddColliderGroup(map, walls);
+
+    const auto readCells = [&]()
+    {
+        std::vector<uint8_t> cells(size * size);
+        const auto& grid = data.mapsStaticGrids[map];
+        for (int i = 0; i < size; ++i)
+        {
+            for (int j = 0; j < size; ++j)
+                cells[i * size + j] = grid.getIsMarked(j * CELL, i * CELL) ? 1 : 0;
+        }
+        return cells;
+    };
+    auto cells = readCells();
+
+    // Far apart queries - too long for the regular search
+    std::vector<Query> queries;
+    while (queries.size() < 20)
+    {
+        const int start = static_cast<int>(rng() % cells.size());
+        const int end = static_cast<int>(rng() % cells.size());
+        const int distance = std::abs(start % size - end % size) + std::abs(start / size - end / size);
+        if (cells[start] != 0 || cells[end] != 0 || distance < size)
+            continue;
+        const float cost = DijkstraCost(cells, start, end, size);
+        if (cost < 0)
+            continue;
+        const auto toPoint = [](const int idx)
+        {
+            const auto x = static_cast<float>(idx % size * CELL);
+            const auto y = static_cast<float>(idx / size * CELL);
+            return Point{x + 1, y + 1};
+        };
+        queries.push_back({toPoint(start), toPoint(end), cost});
+    }
+
+    std::vector<Point> path;
+    auto timer = std::chrono::steady_clock::now();
+    REQUIRE(FindLongPath(path, queries[0].start, queries[0].end, map));
+    const double coldTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timer).count();
+
+    double warmTime = 0;
+    int expanded = 0;
+    int regularFound = 0;
+    float longCost = 0;
+    float optimalCost = 0;
+    for (const auto& query : queries)
+    {
+        // Only the first clusters are refined - the next point is still a neighbor cell
+        std::vector<Point> coarse;
+        REQUIRE(FindLongPath(coarse, query.start, query.end, map));
+        REQUIRE(FindLongPath(path, query.start, query.end, map, size));
+        REQUIRE(coarse.size() < path.size());
+        REQUIRE(std::abs(coarse.back().x - path.back().x) < 0.001F);
+        REQUIRE(std::abs(coarse.back().y - path.back().y) < 0.001F);
+
+        // Fully refined - valid steps that end at the target
+        const float cost = PathCost(cells, path, query.start, size);
+        REQUIRE(path.front().x == std::floor(query.end.x / CELL) * CELL + CELL / 2.0F);
+        REQUIRE(path.front().y == std::floor(query.end.y / CELL) * CELL + CELL / 2.0F);
+        REQUIRE(cost >= query.optimalCost - 0.001F);
+        longCost += cost;
+        optimalCost += query.optimalCost;
+
+        regularFound += FindPath(path, query.start, query.end, map, 1000) ? 1 : 0;
+    }
+
+    // All used clusters are built now
+    for (const auto& query : queries)
+    {
+        timer = std::chrono::steady_clock::now();
+        FindLongPath(path, query.start, query.end, map);
+        warmTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timer).count();
+        expanded += data.expandedNodes;
+    }
+
+    INFO("First query (builds clusters): " << coldTime << " ms | Cached: " << warmTime / queries.size() << " ms");
+    INFO("Abstract nodes expanded: " << expanded / queries.size() << " per query");
+    INFO("Found by regular search: " << regularFound << "/" << queries.size());
+    INFO("Cost compared to optimal: " << longCost / optimalCost);
+    REQUIRE(longCost <= optimalCost * 1.15F);
+
+    // Changing a single spot only invalidates the clusters around it
+    auto& graph = data.mapsClusterGraphs[map];
+    const int builtClusters = static_cast<int>(graph.clusters.size());
+    ManualColliderGroup block;
+    block.addRect(5 * 16 * CELL + 0.5F, 5 * 16 * CELL + 0.5F, 3 * CELL, 3 * CELL);
+    AddColliderGroup(map, block);
+    int dirty = 0;
+    for (const auto& [key, cluster] : graph.clusters)
+        dirty += cluster.isDirty ? 1 : 0;
+    REQUIRE(static_cast<int>(graph.clusters.size()) == builtClusters);
+    REQUIRE(dirty > 0);
+    REQUIRE(dirty <= 9);
+
+    cells = readCells();
+    for (const auto& query : queries)
+    {
+        if (cells[static_cast<int>(query.start.y / CELL) * size + static_cast<int>(query.start.x / CELL)] != 0 ||
+            cells[static_cast<int>(query.end.y / CELL) * size + static_cast<int>(query.end.x / CELL)] != 0)
+            continue;
+        REQUIRE(FindLongPath(path, query.start, query.end, map, size));
+        PathCost(cells, path, query.start, size);
+    }
+
+    RemoveColliderGroup(map, block);
+    RemoveColliderGroup(map, walls);
+    SetStaticWorldBounds({0, 0, 0, 0});
+}
+
+TEST_CASE("Flow fields lead from every cell along a shortest path to the goal")
+{
+    const auto map = static_cast<MapID>(2);
+    auto& data = global::PATH_DATA;
+    const auto center = [](const int idx)
+    {
+        const auto x = static_cast<float>(idx % MAP_SIZE * CELL);
+        const auto y = static_cast<float>(idx / MAP_SIZE * CELL);
+        return Point{x + CELL / 2.0F, y + CELL / 2.0F};
+    };
+
+    // Follows the field and returns the cost of the walked path - negative if it stops before the goal
+    const auto followField = [&](const int start, const int goal)
+    {
+        auto pos = center(start);
+        float cost = 0;
+        for (int steps = 0; steps < MAP_SIZE * MAP_SIZE; ++steps)
+        {
+            if (static_cast<int>(pos.x / CELL) == goal % MAP_SIZE && static_cast<int>(pos.y / CELL) == goal / MAP_SIZE)
+                return cost;
+            const auto dir = GetFlowDirection(pos, center(goal), map);
+            const Point step = {dir.x > 0.1F ? 1.0F : dir.x < -0.1F ? -1.0F : 0.0F,
+                                dir.y > 0.1F ? 1.0F : dir.y < -0.1F ? -1.0F : 0.0F};
+            if (step.x == 0 && step.y == 0)
+                return -1.0F;
+            cost += MOVE_COST[(int)GridMode::STAR](step);
+            pos = {pos.x + step.x * CELL, pos.y + step.y * CELL};
+        }
+        return -1.0F;
+    };
+
+    const auto checkField = [&](const std::vector<uint8_t>& cells, const int goal)
+    {
+        const auto costs = DijkstraCosts(cells, goal);
+        for (int i = 0; i < static_cast<int>(cells.size()); ++i)
+        {
+            if (cells[i] != 0)
+                continue;
+            const float cost = followField(i, goal);
+            if (costs[i] == std::numeric_limits<float>::max())
+                REQUIRE(cost < 0);
+            else
+                REQUIRE(cost == Catch::Approx(costs[i]));
+        }
+    };
+
+    for (const auto type : {MapType::OPEN, MapType::MAZE, MapType::MIXED})
+    {
+        auto cells = CreateMap(map, type, 11);
+        int goal = MAP_SIZE * MAP_SIZE / 2 + MAP_SIZE / 2;
+        while (cells[goal] != 0)
+            ++goal;
+        const auto fieldCount = data.flowFields.size();
+        checkField(cells, goal);
+        REQUIRE(data.flowFields.size() <= fieldCount + 1); // Shared by all positions with the same goal
+
+        // Solid entities change the dynamic grid - the field is computed again in the next tick
+        int blocked = goal + 2;
+        while (cells[blocked] != 0)
+            ++blocked;
+        cells[blocked] = 1;
+        data.mapsDynamicGrids[map].setMarked(center(blocked).x, center(blocked).y);
+        ++global::ENGINE_DATA.engineTicks;
+        checkField(cells, goal);
+        data.mapsDynamicGrids[map].clear();
+        ++global::ENGINE_DATA.engineTicks;
+    }
+
+    // Many agents with the same goal - single field vs a search for each agent
+    const auto cells = CreateMap(map, MapType::MIXED, 12);
+    std::vector<Query> agents = CreateQueries(cells, 12, 500);
+    const auto goal = agents.front().end;
+    data.flowFields.clear();
+    auto timer = std::chrono::steady_clock::now();
+    for (const auto& agent : agents)
+        GetFlowDirection(agent.start, goal, map);
+    const auto millisSince = [](const auto start)
+    { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+    const double fieldTime = millisSince(timer);
+    REQUIRE(data.flowFields.size() == 1);
+    const auto fieldCells = static_cast<int64_t>(data.flowFields.begin()->second.costs.size());
+
+    std::vector<Point> path;
+    int64_t expanded = 0;
+    timer = std::chrono::steady_clock::now();
+    for (const auto& agent : agents)
+    {
+        FindPath(path, agent.start, goal, map, MAX_LEN);
+        expanded += data.expandedNodes;
+    }
+    const double searchTime = millisSince(timer);
+
+    // Work done instead of time - the field visits each of its cells once
+    WARN("500 agents - flow field: " << fieldTime << " ms | FindPath each: " << searchTime << " ms");
+    INFO("Field cells: " << fieldCells << " | Expanded by the searches: " << expanded);
+    REQUIRE(expanded > fieldCells * 2);
+
+    data.mapsStaticGrids[map].clear();
+    data.flowFields.clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Path requests are solved in batches and delivered in order")
+{
+    const auto map = static_cast<MapID>(3);
+    auto& data = global::PATH_DATA;
+    const auto cells = CreateMap(map, MapType::MIXED, 5);
+    // Stays below the parallel threshold - the job system is not running
+    constexpr int batchSize = PathFindingData::MIN_PARALLEL_REQUESTS - 1;
+    constexpr int batches = 10;
+    const auto queries = CreateQueries(cells, 5, batchSize * batches);
+
+    std::vector<int> order;
+    std::vector<Point> expected;
+    for (int batch = 0; batch < batches; ++batch)
+    {
+        for (int i = 0; i < batchSize; ++i)
+        {
+            const int idx = batch * batchSize + i;
+            const auto algorithm = idx % 2 == 0 ? PathAlgorithm::A_STAR : PathAlgorithm::JUMP_POINT;
+            const auto& query = queries[idx];
+            const auto callback = [&, idx, algorithm](const bool found, const std::vector<Point>& path)
+            {
+                order.push_back(idx);
+                const auto& q = queries[idx];
+                REQUIRE(FindPath(expected, q.start, q.end, map, MAX_LEN, GridMode::STAR, algorithm) == found);
+                REQUIRE(path.size() == expected.size());
+                for (int j = 0; j < static_cast<int>(path.size()); ++j)
+                    REQUIRE(path[j] == expected[j]);
+            };
+            RequestPath(query.start, query.end, map, callback, MAX_LEN, GridMode::STAR, algorithm);
+        }
+        REQUIRE(order.size() == static_cast<size_t>(batch * batchSize)); // Nothing is solved before the system runs
+        PathRequestSystem();
+        REQUIRE(order.size() == static_cast<size_t>((batch + 1) * batchSize));
+    }
+    for (int i = 0; i < static_cast<int>(order.size()); ++i)
+        REQUIRE(order[i] == i);
+
+    // Requests made inside a callback go into the next batch
+    bool followUpFound = false;
+    const auto& query = queries.front();
+    const auto followUp = [&](const bool found, const std::vector<Point>&) { followUpFound = found; };
+    const auto first = [&](bool, const std::vector<Point>&)
+    { RequestPath(query.end, query.start, map, followUp, MAX_LEN); };
+    RequestPath(query.start, query.end, map, first, MAX_LEN);
+    PathRequestSystem();
+    REQUIRE_FALSE(followUpFound);
+    REQUIRE(data.pendingRequests.size() == 1);
+    PathRequestSystem();
+    REQUIRE(followUpFound);
+    REQUIRE(data.pendingRequests.empty());
+
+    data.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Short searches don't pay for clearing the lookup grids")
+{
+    const auto map = static_cast<MapID>(4);
+    const auto cells = CreateMap(map, MapType::OPEN, 9);
+    constexpr int queryCount = 10'000;
+    constexpr int maxOffset = 6; // In cells
+
+    std::mt19937 rng(9);
+    std::vector<std::pair<int, int>> queries;
+    while (static_cast<int>(queries.size()) < queryCount)
+    {
+        const int start = static_cast<int>(rng() % cells.size());
+        const int x = start % MAP_SIZE + static_cast<int>(rng() % (maxOffset * 2 + 1)) - maxOffset;
+        const int y = start / MAP_SIZE + static_cast<int>(rng() % (maxOffset * 2 + 1)) - maxOffset;
+        if (x < 0 || y < 0 || x >= MAP_SIZE || y >= MAP_SIZE)
+            continue;
+        const int end = y * MAP_SIZE + x;
+        if (start != end && cells[start] == 0 && cells[end] == 0)
+            queries.emplace_back(start, end);
+    }
+    const auto toPoint = [](const int idx)
+    {
+        const auto x = static_cast<float>(idx % MAP_SIZE * CELL);
+        const auto y = static_cast<float>(idx / MAP_SIZE * CELL);
+        return Point{x + 1, y + 1};
+    };
+
+    std::vector<Point> path;
+    std::vector<uint8_t> found(queries.size());
+    const auto timer = std::chrono::steady_clock::now();
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const auto [start, end] = queries[i];
+        found[i] = FindPath(path, toPoint(start), toPoint(end), map, MAX_LEN) ? 1 : 0;
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - timer;
+    const double searchTime = std::chrono::duration<double, std::milli>(elapsed).count();
+    INFO("10k short paths: " << searchTime << " ms");
+
+    for (int i = 0; i < queryCount; ++i)
+    {
+        const auto [start, end] = queries[i];
+        REQUIRE((found[i] != 0) == (DijkstraCost(cells, start, end) >= 0));
+    }
+    // Searches still see their own marks after the stamp wrapped around
+    auto& search = global::PATH_DATA.search;
+    search.lookup.stamp = UINT32_MAX - 1;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto [start, end] = queries[i];
+        REQUIRE(FindPath(path, toPoint(start), toPoint(end), map, MAX_LEN) == (found[i] != 0));
+        if (found[i] != 0)
+            PathCost(cells, path, toPoint(start));
+    }
+    REQUIRE(search.lookup.stamp < 8);
+
+    global::PATH_DATA.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Cached paths are reused until a cell they pass through becomes solid")
+{
+    const auto map = static_cast<MapID>(5);
+    auto& data = global::PATH_DATA;
+    auto& cache = data.cachedPaths;
+    const auto cells = CreateMap(map, MapType::OPEN, 21);
+    std::vector<Query> queries;
+    std::vector<Point> path;
+    for (const auto& query : CreateQueries(cells, 21, 100)) // Only paths A* finds within its search capacity
+    {
+        if (queries.size() < 50 && FindPath(path, query.start, query.end, map, MAX_LEN))
+            queries.push_back(query);
+    }
+    REQUIRE(queries.size() == 50);
+    const auto samePath = [](const std::vector<Point>& a, const std::vector<Point>& b)
+    { return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()); };
+    const auto millisSince = [](const auto start)
+    { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+    SetPathCache(true, 64);
+
+    std::vector<std::vector<Point>> searched(queries.size());
+    auto timer = std::chrono::steady_clock::now();
+    for (int i = 0; i < static_cast<int>(queries.size()); ++i)
+        REQUIRE(FindPath(searched[i], queries[i].start, queries[i].end, map, MAX_LEN));
+    const double searchTime = millisSince(timer);
+    REQUIRE(cache.misses == queries.size());
+
+    timer = std::chrono::steady_clock::now();
+    for (int i = 0; i < static_cast<int>(queries.size()); ++i)
+    {
+        REQUIRE(FindPath(path, queries[i].start, queries[i].end, map, MAX_LEN));
+        REQUIRE(samePath(path, searched[i]));
+    }
+    const double cachedTime = millisSince(timer);
+    INFO("50 paths - searched: " << searchTime << " ms | cached: " << cachedTime << " ms");
+    REQUIRE(cache.hits == queries.size());
+
+    // A solid cell on the path invalidates it - paths not passing through it stay cached
+    const auto& blockedPath = searched.front();
+    REQUIRE(blockedPath.size() > 2);
+    const auto blocked = blockedPath[blockedPath.size() / 2];
+    data.mapsDynamicGrids[map].setMarked(blocked.x, blocked.y);
+    cache.hits = 0;
+    cache.misses = 0;
+    FindPath(path, queries.front().start, queries.front().end, map, MAX_LEN);
+    REQUIRE(cache.misses == 1);
+    REQUIRE(std::find(path.begin(), path.end(), blocked) == path.end());
+    for (int i = 1; i < static_cast<int>(queries.size()); ++i)
+    {
+        if (std::find(searched[i].begin(), searched[i].end(), blocked) != searched[i].end())
+            continue;
+        REQUIRE(FindPath(path, queries[i].start, queries[i].end, map, MAX_LEN));
+        REQUIRE(samePath(path, searched[i]));
+    }
+    REQUIRE(cache.misses == 1);
+    data.mapsDynamicGrids[map].clear();
+
+    // Least recently used paths are evicted first
+    SetPathCache(true, 4);
+    const auto find = [&](const int i) { FindPath(path, queries[i].start, queries[i].end, map, MAX_LEN); };
+    for (int i = 0; i < 5; ++i)
+        find(i); // Evicts 0
+    find(0);     // Evicts 1
+    find(4);
+    REQUIRE(cache.hits == 1);
+    find(1);
+    REQUIRE(cache.misses == 7);
+    REQUIRE(static_cast<int>(cache.entries.size()) == 4);
+
+    SetPathCache(false);
+    data.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Big agents only get paths they fit through")
+{
+    constexpr int size = 64;
+    const auto map = static_cast<MapID>(6);
+    auto& data = global::PATH_DATA;
+    SetStaticWorldBounds({0, 0, size * CELL, size * CELL});
+
+    // Wall through the middle with a gap of 1 cell and a gap of 3 cells right of it - plus random pillars
+    std::mt19937 rng(3);
+    ManualColliderGroup walls;
+    for (int j = 0; j < size; ++j)
+    {
+        if (j != 10 && (j < 16 || j > 18))
+            walls.addRect(j * CELL + 0.5F, 32 * CELL + 0.5F, CELL - 1, CELL - 1);
+    }
+    for (int i = 0; i < 60; ++i)
+    {
+        const auto x = static_cast<float>(rng() % size);
+        const auto y = static_cast<float>(rng() % 28);
+        walls.addRect(x * CELL + 0.5F, y * CELL + 0.5F, CELL - 1, CELL - 1);
+    }
+    AddColliderGroup(map, walls);
+
+    const auto& grid = data.mapsStaticGrids[map];
+    const auto isSolid = [&](const int x, const int y)
+    { return x < 0 || y < 0 || x >= size || y >= size || grid.getIsMarked(x * CELL, y * CELL); };
+    const auto fits = [&](const int x, const int y, const int agentSize)
+    {
+        for (int i = 0; i < agentSize; ++i)
+        {
+            for (int j = 0; j < agentSize; ++j)
+            {
+                if (isSolid(x + j, y + i))
+                    return false;
+            }
+        }
+        return true;
+    };
+    const auto checkClearance = [&]()
+    {
+        auto& clearance = data.mapsClearance[map];
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                int expected = 0;
+                while (expected < ClearanceMap::MAX && fits(x, y, expected + 1))
+                    ++expected;
+                REQUIRE(clearance.get(x, y, grid) == expected);
+            }
+        }
+    };
+    const auto checkPath = [&](const std::vector<Point>& path, const int agentSize)
+    {
+        bool usedSmallGap = false;
+        for (const auto& point : path)
+        {
+            const int x = static_cast<int>(point.x) / CELL;
+            const int y = static_cast<int>(point.y) / CELL;
+            REQUIRE(fits(x, y, agentSize));
+            usedSmallGap |= y == 32 && x == 10;
+        }
+        return usedSmallGap;
+    };
+
+    // Left of the small gap - the direct way leads through it
+    const Point start = {10 * CELL + 1, 20 * CELL + 1};
+    const Point end = {10 * CELL + 1, 44 * CELL + 1};
+    std::vector<Point> path;
+    REQUIRE(FindPath(path, start, end, map, 200));
+    REQUIRE(checkPath(path, 1));
+    REQUIRE(FindPath(path, start, end, map, 200, GridMode::STAR, PathAlgorithm::A_STAR, 2));
+    REQUIRE_FALSE(checkPath(path, 2));
+    REQUIRE(FindPath(path, start, end, map, 200, GridMode::STAR, PathAlgorithm::A_STAR, 3));
+    REQUIRE_FALSE(checkPath(path, 3));
+    REQUIRE_FALSE(FindPath(path, start, end, map, 200, GridMode::STAR, PathAlgorithm::A_STAR, 4));
+    checkClearance();
+
+    // Requests give the same paths - a parallel batch with big agents searched on the main thread
+    internal::InitJobSystem(); // Shared by the whole test binary - never closed here
+    WakeUpJobs();
+    int delivered = 0;
+    for (int i = 0; i < PathFindingData::MIN_PARALLEL_REQUESTS; ++i)
+    {
+        const int agentSize = i % 4 + 1;
+        const auto algorithm = i % 2 == 0 ? PathAlgorithm::JUMP_POINT : PathAlgorithm::BIDIRECTIONAL;
+        const auto callback = [&, agentSize, algorithm](const bool found, const std::vector<Point>& result)
+        {
+            REQUIRE(FindPath(path, start, end, map, 200, GridMode::STAR, algorithm, agentSize) == found);
+            REQUIRE(result == path);
+            REQUIRE(found == (agentSize < 4));
+            delivered++;
+        };
+        RequestPath(start, end, map, callback, 200, GridMode::STAR, algorithm, agentSize);
+    }
+    PathRequestSystem();
+    REQUIRE(delivered == PathFindingData::MIN_PARALLEL_REQUESTS);
+
+    // Changing the static collision only recomputes the clearance around it
+    auto& clearance = data.mapsClearance[map];
+    const int blockCount = static_cast<int>(clearance.blocks.size());
+    ManualColliderGroup block;
+    block.addRect(17 * CELL + 0.5F, 32 * CELL + 0.5F, CELL - 1, CELL - 1);
+    AddColliderGroup(map, block);
+    REQUIRE(static_cast<int>(clearance.blocks.size()) >= blockCount - 4);
+    REQUIRE_FALSE(FindPath(path, start, end, map, 200, GridMode::STAR, PathAlgorithm::A_STAR, 2));
+    checkClearance();
+
+    RemoveColliderGroup(map, block);
+    RemoveColliderGroup(map, walls);
+    SetStaticWorldBounds({0, 0, 0, 0});
+}
+
+TEST_CASE("Path planner reuses its search while chasing a moving goal")
+{
+    const auto map = static_cast<MapID>(7);
+    auto& data = global::PATH_DATA;
+    auto staticCells = CreateMap(map, MapType::MIXED, 4);
+    auto cells = staticCells;
+    auto& dynamicGrid = data.mapsDynamicGrids[map];
+    std::mt19937 rng(4);
+
+    const auto randomFreeCell = [&]()
+    {
+        while (true)
+        {
+            const int idx = static_cast<int>(rng() % cells.size());
+            if (cells[idx] == 0)
+                return idx;
+        }
+    };
+    const auto toPoint = [](const int idx)
+    { return Point{static_cast<float>(idx % MAP_SIZE * CELL + 1), static_cast<float>(idx / MAP_SIZE * CELL + 1)}; };
+
+    // 60 seconds - the goal moves a cell every 2 ticks - the chaser searches and moves every 6 ticks
+    int goal = randomFreeCell();
+    int goalDir = 0;
+    int chaser = randomFreeCell();
+    PathPlanner planner;
+    std::vector<Point> path;
+    int searches = 0, plannerFound = 0, aStarFound = 0, plannerExpanded = 0, aStarExpanded = 0;
+    double plannerMillis = 0, aStarMillis = 0;
+    for (int tick = 0; tick < 60 * 60; ++tick)
+    {
+        ++global::ENGINE_DATA.engineTicks;
+
+        // Every 2 seconds a solid entity (3x3 cells) appears somewhere else
+        if (tick % 120 == 0)
+        {
+            cells = staticCells;
+            dynamicGrid.clear();
+            const int idx = randomFreeCell();
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    const int x = std::min(idx % MAP_SIZE + j, MAP_SIZE - 1);
+                    const int y = std::min(idx / MAP_SIZE + i, MAP_SIZE - 1);
+                    if (y * MAP_SIZE + x == chaser || y * MAP_SIZE + x == goal)
+                        continue;
+                    cells[y * MAP_SIZE + x] = 1;
+                    dynamicGrid.setMarked(static_cast<float>(x * CELL), static_cast<float>(y * CELL));
+                }
+            }
+        }
+
+        // Runs in a straight line until it's blocked or randomly turns
+        if (tick % 2 == 0)
+        {
+            const auto& dir = MOVEMENTS[(int)GridMode::STAR][goalDir];
+            const int x = goal % MAP_SIZE + static_cast<int>(dir.x);
+            const int y = goal / MAP_SIZE + static_cast<int>(dir.y);
+            if (cells[y * MAP_SIZE + x] == 0 && rng() % 16 != 0)
+                goal = y * MAP_SIZE + x;
+            else
+                goalDir = static_cast<int>(rng() % 8);
+        }
+        if (tick % 6 != 0 || goal == chaser)
+            continue;
+
+        ++searches;
+        auto timer = std::chrono::steady_clock::now();
+        const bool aStar = FindPath(path, toPoint(chaser), toPoint(goal), map, MAX_LEN);
+        aStarMillis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timer).count();
+        aStarExpanded += data.expandedNodes;
+        aStarFound += aStar ? 1 : 0;
+
+        timer = std::chrono::steady_clock::now();
+        const bool found = planner.findPath(path, toPoint(chaser), toPoint(goal), map, MAX_LEN);
+        plannerMillis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timer).count();
+        plannerExpanded += data.expandedNodes;
+
+        const float optimalCost = DijkstraCost(cells, chaser, goal);
+        if (!found) // Unreachable or out of search capacity - the next search continues
+        {
+            REQUIRE((optimalCost < 0 || data.expandedNodes == MAGIQUE_MAX_PATH_SEARCH_CAPACITY));
+            continue;
+        }
+        ++plannerFound;
+        REQUIRE(PathCost(cells, path, toPoint(chaser)) == Catch::Approx(optimalCost));
+        if (!path.empty())
+        {
+            const Point next = path.back();
+            chaser = static_cast<int>(next.y) / CELL * MAP_SIZE + static_cast<int>(next.x) / CELL;
+        }
+    }
+
+    INFO("Chase over 60 seconds - " << searches << " searches");
+    INFO("A*      : " << aStarFound << " found | " << aStarExpanded << " expanded | " << aStarMillis << " ms");
+    INFO("Planner : " << plannerFound << " found | " << plannerExpanded << " expanded | " << plannerMillis << " ms");
+    REQUIRE(plannerFound >= aStarFound);
+    REQUIRE(plannerExpanded * 2 < aStarExpanded);
+
+    // Searches from scratch after a reset
+    planner.reset();
+    REQUIRE(planner.findPath(path, toPoint(chaser), toPoint(chaser), map, MAX_LEN));
+    REQUIRE(path.empty());
+
+    dynamicGrid.clear();
+    data.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Smoothed paths keep only the corners in line of sight")
+{
+    const auto map = static_cast<MapID>(8);
+    const auto length = [](const std::vector<Point>& path, const Point start)
+    {
+        float sum = 0;
+        Point prev = start;
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+        {
+            sum += prev.euclidean(*it);
+            prev = *it;
+        }
+        return sum;
+    };
+
+    for (const auto type : {MapType::OPEN, MapType::MIXED})
+    {
+        const auto cells = CreateMap(map, type, 5);
+        const auto queries = CreateQueries(cells, 5, 200);
+        int gridPoints = 0;
+        int smoothPoints = 0;
+        std::vector<Point> path;
+        for (const auto& query : queries)
+        {
+            REQUIRE(FindPath(path, query.start, query.end, map, MAX_LEN, GridMode::STAR, PathAlgorithm::JUMP_POINT));
+            const auto gridPath = path;
+            SmoothPath(path, query.start, map);
+            gridPoints += static_cast<int>(gridPath.size());
+            smoothPoints += static_cast<int>(path.size());
+
+            REQUIRE(path.size() <= gridPath.size());
+            REQUIRE(path.front() == gridPath.front());
+            REQUIRE(length(path, query.start) <= length(gridPath, query.start) + 0.001F);
+            Point prev = query.start;
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+            {
+                REQUIRE(GetPathRayCast(prev, *it, map));
+                prev = *it;
+            }
+        }
+        INFO((type == MapType::OPEN ? "Open" : "Mixed") << " map - " << queries.size() << " paths");
+        INFO("Points: " << gridPoints << " on the grid | " << smoothPoints << " smoothed");
+        REQUIRE(smoothPoints * 3 < gridPoints);
+    }
+
+    // Nothing to skip
+    std::vector<Point> path;
+    SmoothPath(path, {0, 0}, map);
+    REQUIRE(path.empty());
+
+    global::PATH_DATA.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Bidirectional search finds the shortest paths from both sides")
+{
+    const auto map = static_cast<MapID>(9);
+    auto& data = global::PATH_DATA;
+
+    const auto aStar = [&](std::vector<Point>& path, const Query& q)
+    { return FindPath(path, q.start, q.end, map, MAX_LEN, GridMode::STAR, PathAlgorithm::A_STAR); };
+    const auto bidirectional = [&](std::vector<Point>& path, const Query& q)
+    { return FindPath(path, q.start, q.end, map, MAX_LEN, GridMode::STAR, PathAlgorithm::BIDIRECTIONAL); };
+
+    for (const auto type : {MapType::OPEN, MapType::MAZE, MapType::MIXED})
+    {
+        const char* name = type == MapType::OPEN ? "Open" : type == MapType::MAZE ? "Maze" : "Mixed";
+        const auto cells = CreateMap(map, type, 6);
+        const auto queries = CreateQueries(cells, 6, 200);
+
+        const auto aStarResult = RunQueries(cells, queries, aStar);
+        const auto bidirectionalResult = RunQueries(cells, queries, bidirectional);
+        INFO(name << " map - " << queries.size() << " queries");
+        INFO("A*            : " << aStarResult.found << " found | " << aStarResult.expanded << " expanded | "
+                                << aStarResult.millis << " ms");
+        INFO("Bidirectional : " << bidirectionalResult.found << " found | " << bidirectionalResult.expanded
+                                << " expanded | " << bidirectionalResult.millis << " ms");
+
+        // Always the shortest path if found within the search capacity
+        std::vector<Point> path;
+        for (const auto& query : queries)
+        {
+            if (bidirectional(path, query))
+                REQUIRE(PathCost(cells, path, query.start) == Catch::Approx(query.optimalCost));
+            else
+                REQUIRE(data.expandedNodes == MAGIQUE_MAX_PATH_SEARCH_CAPACITY);
+        }
+        REQUIRE(bidirectionalResult.found * 10 >= static_cast<int>(queries.size()) * 9);
+    }
+
+    // The end is enclosed - the search from the end stops right away
+    auto cells = CreateMap(map, MapType::OPEN, 6);
+    for (const auto [x, y] : {std::pair{39, 40}, {41, 40}, {40, 39}, {40, 41}, {39, 39}, {41, 41}, {39, 41}, {41, 39}})
+        data.mapsStaticGrids[map].setMarked(static_cast<float>(x * CELL), static_cast<float>(y * CELL));
+    std::vector<Point> path;
+    const Point start = {5 * CELL + 1, 5 * CELL + 1};
+    const Point end = {40 * CELL + 1, 40 * CELL + 1};
+    REQUIRE_FALSE(FindPath(path, start, end, map, MAX_LEN));
+    const int aStarExpanded = data.expandedNodes;
+    REQUIRE_FALSE(FindPath(path, start, end, map, MAX_LEN, GridMode::STAR, PathAlgorithm::BIDIRECTIONAL));
+    REQUIRE(data.expandedNodes * 100 < aStarExpanded);
+
+    // Same as the start
+    REQUIRE(FindPath(path, start, start, map, MAX_LEN, GridMode::CROSS, PathAlgorithm::BIDIRECTIONAL));
+    REQUIRE(path.empty());
+
+    data.mapsStaticGrids[map].clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Paged lookup grid matches the hashmap also inside a search")
+{
+    // Same marks as a plain set - also for negative coordinates and while the paged area grows
+    PathFindingGrid grid;
+    std::set<std::pair<int, int>> marked;
+    std::mt19937 rng(10);
+    for (int i = 0; i < 5000; ++i)
+    {
+        const int x = static_cast<int>(rng() % 800) - 400;
+        const int y = static_cast<int>(rng() % 800) - 400;
+        grid.setMarked(static_cast<float>(x * CELL), static_cast<float>(y * CELL));
+        marked.insert({x, y});
+    }
+    const auto checkMarks = [&]()
+    {
+        for (int y = -450; y < 450; y += 3)
+        {
+            for (int x = -450; x < 450; ++x)
+            {
+                const bool expected = marked.contains({x, y});
+                REQUIRE(grid.getIsMarked(static_cast<float>(x * CELL), static_cast<float>(y * CELL)) == expected);
+            }
+        }
+    };
+    REQUIRE(grid.usePages);
+    checkMarks();
+
+    // Too spread out - only the hashmap is used
+    grid.setMarked(20'000 * CELL, 0);
+    marked.insert({20'000, 0});
+    REQUIRE_FALSE(grid.usePages);
+    checkMarks();
+    REQUIRE(grid.getIsMarked(20'000 * CELL, 0));
+
+    // Cleared grids keep the paged area
+    PathFindingGrid dynamicGrid;
+    dynamicGrid.setMarked(0, 0);
+    dynamicGrid.setMarked(40 * CELL, 40 * CELL);
+    const int pagesWidth = dynamicGrid.pagesWidth;
+    dynamicGrid.clear();
+    REQUIRE(dynamicGrid.pagesWidth == pagesWidth);
+    REQUIRE_FALSE(dynamicGrid.getIsMarked(0, 0));
+    dynamicGrid.setMarked(40 * CELL, 40 * CELL);
+    REQUIRE(dynamicGrid.getIsMarked(40 * CELL, 40 * CELL));
+
+    // Searches with direct pages vs hashing give the same results - timings are only informational
+    const auto map = static_cast<MapID>(10);
+    auto& data = global::PATH_DATA;
+    const auto cells = CreateMap(map, MapType::MIXED, 10);
+    const auto queries = CreateQueries(cells, 10, 500);
+    const auto aStar = [&](std::vector<Point>& path, const Query& q)
+    { return data.findPath(path, q.start, q.end, map, MAX_LEN, GridMode::STAR); };
+    auto& staticGrid = data.mapsStaticGrids[map];
+    REQUIRE(staticGrid.usePages);
+    const auto pagedResult = RunQueries(cells, queries, aStar);
+    staticGrid.usePages = false;
+    const auto hashedResult = RunQueries(cells, queries, aStar);
+    staticGrid.usePages = true;
+
+    const auto lookupsPerSecond = [](const Result& result)
+    { return static_cast<double>(result.expanded) * 8 * 2 / result.millis / 1000.0; };
+    INFO("Paged  : " << pagedResult.millis << " ms | " << lookupsPerSecond(pagedResult) << " M lookups/s");
+    INFO("Hashed : " << hashedResult.millis << " ms | " << lookupsPerSecond(hashedResult) << " M lookups/s");
+    REQUIRE(pagedResult.found == hashedResult.found);
+    REQUIRE(pagedResult.expanded == hashedResult.expanded);
+    REQUIRE(pagedResult.cost == hashedResult.cost);
+
+    staticGrid.clear();
+    global::STATIC_COLL_DATA.mapBounds.erase(map);
+}
+
+TEST_CASE("Updating a rect of the static grid matches a full rebuild")
+{
+    const auto map = static_cast<MapID>(11);
+    auto& data = global::PATH_DATA;
+    SetStaticWorldBounds({0, 0, MAP_SIZE * CELL, MAP_SIZE * CELL});
+
+    // Unaligned rects - cells on the border of the updated rect are also touched by colliders outside of it
+    std::mt19937 rng(11);
+    ManualColliderGroup walls;
+    for (int i = 0; i < 300; ++i)
+    {
+        const auto x = static_cast<float>(rng() % (MAP_SIZE * CELL));
+        const auto y = static_cast<float>(rng() % (MAP_SIZE * CELL));
+        walls.addRect(x, y, static_cast<float>(rng() % (3 * CELL) + 1), static_cast<float>(rng() % (3 * CELL) + 1));
+    }
+    AddColliderGroup(map, walls);
+    const auto expected = data.mapsStaticGrids[map];
+    REQUIRE(data.getJumpTable(map) != nullptr);
+    const auto& table = data.mapsJumpTables[map];
+    const std::vector<uint16_t> expectedTable(table.entries.begin(), table.entries.end());
+
+    auto& grid = data.mapsStaticGrids[map];
+    for (int k = 0; k < 50; ++k)
+    {
+        const int x = static_cast<int>(rng() % (MAP_SIZE - 8)) - 1;
+        const int y = static_cast<int>(rng() % (MAP_SIZE - 8)) - 1;
+        const int width = static_cast<int>(rng() % 8) + 1;
+        const int height = static_cast<int>(rng() % 8) + 1;
+
+        // Scrambles the cells of the rect and builds the jump table from them
+        for (int i = y; i < y + height; ++i)
+        {
+            for (int j = x; j < x + width; ++j)
+            {
+                if (rng() % 2 == 0)
+                    grid.setMarked(j * CELL, i * CELL);
+                else
+                    grid.setUnmarked(j * CELL, i * CELL);
+            }
+        }
+        data.markStaticGridChanged(map);
+        REQUIRE(data.getJumpTable(map) != nullptr);
+
+        const Rectangle rect = {static_cast<float>(x * CELL), static_cast<float>(y * CELL),
+                                static_cast<float>(width * CELL - 1), static_cast<float>(height * CELL - 1)};
+        data.updateStaticPathRect(map, rect);
+        for (int i = -2; i < MAP_SIZE + 2; ++i)
+        {
+            for (int j = -2; j < MAP_SIZE + 2; ++j)
+                REQUIRE(grid.getIsMarked(j * CELL, i * CELL) == expected.getIsMarked(j * CELL, i * CELL));
+        }
+        REQUIRE_FALSE(table.isDirty);
+        REQUIRE(std::equal(expectedTable.begin(), expectedTable.end(), table.entries.begin(), table.entries.end()));
+    }
+
+    RemoveColliderGroup(map, walls);
+    SetStaticWorldBounds({0, 0, 0, 0});
+}
@@ -0,0 +1,151 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <magique/assets/types/TileMap.h>
+#include <magique/assets/types/TileSet.h>
+#include <magique/core/StaticCollision.h>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int MAP_TILES = 96;
+    constexpr int TILE_SIZE = 16;
+    const auto UPDATED_MAP = static_cast<MapID>(3);
+    const auto FRESH_MAP = static_cast<MapID>(4);
+
+    using Collider = std::tuple<float, float, float, float, int>; // Rect and tile class
+
+    // Tile 0 and 2 are full tiles of different classes - tile 1 has a custom collision rect
+    TileSet CreateTileSet()
+    {
+        TileSet tileSet;
+        tileSet.tileSize = TILE_SIZE;
+        tileSet.tileCount = 3;
+        TileInfo full{};
+        full.tileID = 0;
+        full.hasCollision = true;
+        full.width = TILE_SIZE;
+        full.height = TILE_SIZE;
+        TileInfo custom{};
+        custom.tileID = 1;
+        custom.hasCollision = true;
+        custom.x = 4;
+        custom.y = 4;
+        custom.width = 8;
+        custom.height = 8;
+        TileInfo other = full;
+        other.tileID = 2;
+        other.tileClass = static_cast<TileClass>(1);
+        tileSet.infoVec = {full, custom, other};
+        return tileSet;
+    }
+
+    // Mostly walls of the first class - values are stored as 1 more
+    uint16_t RandomTile(std::mt19937& gen)
+    {
+        const auto roll = std::uniform_int_distribution{0, 9}(gen);
+        if (roll < 4)
+            return 0;
+        if (roll < 8)
+            return 1;
+        return roll == 8 ? 2 : 3;
+    }
+
+    std::vector<Collider> GetColliders(const MapID map)
+    {
+        const auto& data = global::STATIC_COLL_DATA;
+        std::vector<Collider> result;
+        for (const auto id : data.colliderReferences.tilesCollisionMap.at(map))
+        {
+            const auto& [x, y, w, h] = data.colliderStorage.get(id);
+            vector<StaticID> found;
+            data.mapTileGrids[map].query(found, x, y, w, h);
+            const auto it = std::ranges::find_if(found, [&](const StaticID sid)
+                                                 { return StaticIDHelper::GetObjectNum(sid) == id; });
+            REQUIRE(it != found.end());
+            result.emplace_back(x, y, w, h, StaticIDHelper::GetData(*it));
+        }
+        std::ranges::sort(result);
+        return result;
+    }
+
+    // Returns the classes of the colliders the grid finds at the point - sorted
+    std::vector<int> QueryPoint(const MapID map, const float x, const float y)
+    {
+        const auto& data = global::STATIC_COLL_DATA;
+        vector<StaticID> found;
+        data.mapTileGrids[map].query(found, x, y, 1, 1);
+        std::vector<int> result;
+        for (const auto id : found)
+        {
+            const auto& c = data.colliderStorage.get(StaticIDHelper::GetObjectNum(id));
+            if (RectToRect(x, y, 1, 1, c.x, c.y, c.p1, c.p2))
+                result.push_back(StaticIDHelper::GetData(id));
+        }
+        std::ranges::sort(result);
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Updated tile collisions match a fresh merge of the map")
+{
+    test::ResetEngine();
+    static const auto tileSet = CreateTileSet(); // Referenced by the global tileset
+    LoadGlobalTileSet(tileSet);
+
+    std::mt19937 gen{23};
+    TileMap tileMap;
+    tileMap.width = MAP_TILES;
+    tileMap.height = MAP_TILES;
+    auto& layer = tileMap.tileLayers.emplace_back(MAP_TILES * MAP_TILES, 0);
+    for (auto& tile : layer)
+        tile = RandomTile(gen);
+    AddTileCollisions(UPDATED_MAP, tileMap, {0});
+
+    // Toggles single tiles - also in rows and blocks so merged walls are split and joined
+    std::uniform_int_distribution<int> coord{0, MAP_TILES - 1};
+    for (int i = 0; i < 600; ++i)
+    {
+        const int x = coord(gen);
+        const int y = coord(gen);
+        const auto tile = i % 3 == 0 ? uint16_t{1} : RandomTile(gen);
+        const int length = i % 5 == 0 ? 6 : 1;
+        for (int j = x; j < std::min(MAP_TILES, x + length); ++j)
+        {
+            layer[y * MAP_TILES + j] = tile;
+            UpdateTileCollision(UPDATED_MAP, 0, j, y, tile);
+        }
+    }
+    AddTileCollisions(FRESH_MAP, tileMap, {0});
+
+    const auto updated = GetColliders(UPDATED_MAP);
+    REQUIRE(updated.size() > 100);
+    REQUIRE(updated == GetColliders(FRESH_MAP));
+
+    // Both find the same tiles at each tile center and at tile corners
+    for (int i = 0; i < MAP_TILES; ++i)
+    {
+        for (int j = 0; j < MAP_TILES; ++j)
+        {
+            const auto x = static_cast<float>(j * TILE_SIZE);
+            const auto y = static_cast<float>(i * TILE_SIZE);
+            REQUIRE(QueryPoint(UPDATED_MAP, x + 7.5F, y + 7.5F) == QueryPoint(FRESH_MAP, x + 7.5F, y + 7.5F));
+            REQUIRE(QueryPoint(UPDATED_MAP, x, y) == QueryPoint(FRESH_MAP, x, y));
+        }
+    }
+
+    // Out of bounds and unknown layers change nothing
+    UpdateTileCollision(UPDATED_MAP, 0, MAP_TILES, 0, 1);
+    UpdateTileCollision(UPDATED_MAP, 2, 0, 0, 1);
+    REQUIRE(GetColliders(UPDATED_MAP) == updated);
+
+    RemoveTileCollisions(UPDATED_MAP);
+    RemoveTileCollisions(FRESH_MAP);
+    test::ResetEngine();
+}
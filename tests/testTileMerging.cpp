@@ -0,0 +1,195 @@
+#include <catch_amalgamated.hpp>
+#include <vector>
+
+#include <magique/fwd.hpp>
+#include <magique/internal/Macros.h>
+
+#include "internal/datastructures/VectorType.h"
+#include "internal/datastructures/HashTypes.h"
+#include "internal/datastructures/MultiResolutionGrid.h"
+#include "internal/utils/TileMergeUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    struct MergedRect final
+    {
+        int x, y, width, height;
+        int16_t value;
+    };
+
+    std::vector<MergedRect> MergeAll(const std::vector<int16_t>& cells, const int width, const int height)
+    {
+        std::vector<MergedRect> rects;
+        std::vector<uint8_t> done(cells.size(), 0);
+        GreedyMergeCells(cells.data(), done.data(), width, 0, 0, width, height,
+                         [&](int x, int y, int w, int h, int16_t value) { rects.push_back({x, y, w, h, value}); });
+        return rects;
+    }
+
+    // Every solid cell has to be covered exactly once with a rect of its own value
+    bool CoversExactly(const std::vector<MergedRect>& rects, const std::vector<int16_t>& cells, const int width)
+    {
+        std::vector<int> coverage(cells.size(), 0);
+        for (const auto& rect : rects)
+        {
+            for (int i = rect.y; i < rect.y + rect.height; ++i)
+            {
+                for (int j = rect.x; j < rect.x + rect.width; ++j)
+                {
+                    if (cells[i * width + j] != rect.value)
+                        return false;
+                    ++coverage[i * width + j];
+                }
+            }
+        }
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            if (coverage[i] != (cells[i] >= 0 ? 1 : 0))
+                return false;
+        }
+        return true;
+    }
+
+    using TestTileGrid = SingleResolutionHashGrid<uint64_t, MAGIQUE_MAX_ENTITIES_CELL, 32>;
+
+    // Total candidates returned for a sweep of entity sized queries across the map - the narrow phase input
+    size_t QueryCost(const TestTileGrid& grid, const int mapSize, const float tileSize)
+    {
+        size_t candidates = 0;
+        std::vector<uint64_t> result;
+        const auto pixels = static_cast<float>(mapSize) * tileSize;
+        for (float y = 0; y < pixels; y += 100)
+        {
+            for (float x = 0; x < pixels; x += 100)
+            {
+                result.clear();
+                grid.query(result, x, y, 40, 40);
+                candidates += result.size();
+            }
+        }
+        return candidates;
+    }
+} // namespace
+
+TEST_CASE("Greedy tile merging produces maximal rectangles")
+{
+    constexpr int size = 256;
+
+    SECTION("Solid block")
+    {
+        const std::vector<int16_t> cells(size * size, 0);
+        const auto rects = MergeAll(cells, size, size);
+        REQUIRE(rects.size() == 1);
+        REQUIRE(rects[0].width == size);
+        REQUIRE(rects[0].height == size);
+    }
+
+    SECTION("Room outline")
+    {
+        std::vector<int16_t> cells(size * size, -1);
+        for (int i = 0; i < size; ++i)
+        {
+            cells[i] = 0;
+            cells[(size - 1) * size + i] = 0;
+            cells[i * size] = 0;
+            cells[i * size + size - 1] = 0;
+        }
+        const auto rects = MergeAll(cells, size, size);
+        REQUIRE(rects.size() == 4); // Instead of 1020 single tiles
+        REQUIRE(CoversExactly(rects, cells, size));
+    }
+
+    SECTION("Checkerboard cannot be merged")
+    {
+        std::vector<int16_t> cells(size * size, -1);
+        for (int i = 0; i < size; ++i)
+        {
+            for (int j = (i % 2); j < size; j += 2)
+                cells[i * size + j] = 0;
+        }
+        const auto rects = MergeAll(cells, size, size);
+        REQUIRE(rects.size() == size * size / 2);
+        REQUIRE(CoversExactly(rects, cells, size));
+    }
+
+    SECTION("Different tile classes are not merged")
+    {
+        std::vector<int16_t> cells(size * size, -1);
+        for (int j = 0; j < size; ++j)
+            cells[j] = static_cast<int16_t>(j < size / 2 ? 1 : 2);
+        const auto rects = MergeAll(cells, size, size);
+        REQUIRE(rects.size() == 2);
+        REQUIRE(CoversExactly(rects, cells, size));
+    }
+
+    SECTION("Region merge skips covered cells")
+    {
+        const std::vector<int16_t> cells(16 * 16, 0);
+        std::vector<uint8_t> done(4 * 4, 0);
+        done[0] = 1; // Top left cell of the region is already covered
+        std::vector<MergedRect> rects;
+        GreedyMergeCells(cells.data(), done.data(), 16, 4, 4, 4, 4,
+                         [&](int x, int y, int w, int h, int16_t value) { rects.push_back({x, y, w, h, value}); });
+        int area = 0;
+        for (const auto& rect : rects)
+        {
+            REQUIRE(rect.x >= 4);
+            REQUIRE(rect.y >= 4);
+            REQUIRE(rect.x + rect.width <= 8);
+            REQUIRE(rect.y + rect.height <= 8);
+            area += rect.width * rect.height;
+        }
+        REQUIRE(area == 15);
+        REQUIRE(rects.size() == 2);
+    }
+}
+
+TEST_CASE("Merged tile collision reduces colliders and query cost")
+{
+    // Map full of horizontal wall segments - typical for dungeons
+    constexpr int size = 256;
+    constexpr float tileSize = 16;
+    std::vector<int16_t> cells(size * size, -1);
+    for (int i = 0; i < size; i += 4)
+    {
+        for (int j = 0; j < size; ++j)
+        {
+            if (j % 32 != 0) // Doors
+                cells[i * size + j] = 0;
+        }
+    }
+
+    TestTileGrid single;
+    uint64_t singleCount = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        for (int j = 0; j < size; ++j)
+        {
+            if (cells[i * size + j] < 0)
+                continue;
+            single.insert(singleCount++, static_cast<float>(j) * tileSize, static_cast<float>(i) * tileSize, tileSize,
+                          tileSize);
+        }
+    }
+
+    TestTileGrid merged;
+    const auto rects = MergeAll(cells, size, size);
+    uint64_t mergedCount = 0;
+    for (const auto& rect : rects)
+    {
+        merged.insert(mergedCount++, static_cast<float>(rect.x) * tileSize, static_cast<float>(rect.y) * tileSize,
+                      static_cast<float>(rect.width) * tileSize, static_cast<float>(rect.height) * tileSize);
+    }
+
+    const auto singleCost = QueryCost(single, size, tileSize);
+    const auto mergedCost = QueryCost(merged, size, tileSize);
+    INFO("Colliders: " << singleCount << " -> " << mergedCount);
+    INFO("Query candidates: " << singleCost << " -> " << mergedCost);
+
+    REQUIRE(singleCount == 64 * 248);
+    REQUIRE(mergedCount == 64 * 8);
+    REQUIRE(CoversExactly(rects, cells, size));
+    REQUIRE(mergedCost < singleCost);
+}
@@ -0,0 +1,194 @@
+#include <catch_amalgamated.hpp>
+#include <algorithm>
+#include <vector>
+
+#include <magique/assets/types/TileMap.h>
+#include <magique/assets/types/TileSet.h>
+#include <magique/core/StaticCollision.h>
+
+#include "EngineTestUtil.h"
+
+using namespace magique;
+
+namespace
+{
+    constexpr int MAP_TILES = 512; // 8x8 chunks
+    constexpr int TILE_SIZE = 16;
+    constexpr float CHUNK_PIXELS = StaticCollisionData::CHUNK_TILES * TILE_SIZE;
+    const auto STREAMED_MAP = static_cast<MapID>(2);
+
+    // Tile 0 is a full solid tile - tile 1 has a custom collision rect
+    TileSet CreateTileSet()
+    {
+        TileSet tileSet;
+        tileSet.tileSize = TILE_SIZE;
+        tileSet.tileCount = 2;
+        TileInfo full{};
+        full.tileID = 0;
+        full.hasCollision = true;
+        full.width = TILE_SIZE;
+        full.height = TILE_SIZE;
+        TileInfo custom{};
+        custom.tileID = 1;
+        custom.hasCollision = true;
+        custom.x = 4;
+        custom.y = 4;
+        custom.width = 8;
+        custom.height = 8;
+        tileSet.infoVec = {full, custom};
+        return tileSet;
+    }
+
+    // Rooms with doors and pillars - repeats within each chunk so all chunks have the same colliders
+    TileMap CreateTileMap()
+    {
+        TileMap tileMap;
+        tileMap.width = MAP_TILES;
+        tileMap.height = MAP_TILES;
+        auto& layer = tileMap.tileLayers.emplace_back(MAP_TILES * MAP_TILES, 0);
+        for (int i = 0; i < MAP_TILES; ++i)
+        {
+            for (int j = 0; j < MAP_TILES; ++j)
+            {
+                const bool isWall = (i % 16 == 0 || j % 32 == 0) && (i % 16 != 8 && j % 32 != 16);
+                if (isWall)
+                    layer[i * MAP_TILES + j] = 1; // Stored as 1 more
+                else if (i % 16 == 4 && j % 32 == 8)
+                    layer[i * MAP_TILES + j] = 2;
+            }
+        }
+        return tileMap;
+    }
+
+    std::vector<uint32_t> SortedIds(const ObjectReferenceHolder::TileChunkInfo& chunk)
+    {
+        std::vector<uint32_t> ids{chunk.objectIds.begin(), chunk.objectIds.end()};
+        std::ranges::sort(ids);
+        return ids;
+    }
+
+    bool GridContains(const uint32_t objectNum)
+    {
+        const auto& data = global::STATIC_COLL_DATA;
+        const auto& [x, y, w, h] = data.colliderStorage.get(objectNum);
+        vector<StaticID> found;
+        data.mapTileGrids[STREAMED_MAP].query(found, x, y, w, h);
+        const auto matches = [&](const StaticID id) { return StaticIDHelper::GetObjectNum(id) == objectNum; };
+        return std::ranges::any_of(found, matches);
+    }
+
+    // Returns the loaded chunks - checks the byte counter and the grid against the chunk state
+    int CheckLoadedChunks()
+    {
+        const auto& data = global::STATIC_COLL_DATA;
+        const auto& mask = data.tileMasks.at(STREAMED_MAP);
+        const auto& chunks = data.colliderReferences.tileChunkMap.at(STREAMED_MAP);
+        const auto& loadedIds = data.colliderReferences.tilesCollisionMap.at(STREAMED_MAP);
+        int loaded = 0;
+        int loadedBytes = 0;
+        for (int i = 0; i < static_cast<int>(chunks.size()); ++i)
+        {
+            const auto& chunk = chunks[i];
+            if (chunk.isLoaded)
+            {
+                loaded++;
+                loadedBytes += static_cast<int>(chunk.objectIds.size()) * StaticCollisionData::COLLIDER_BYTES;
+                for (const auto id : chunk.objectIds)
+                {
+                    REQUIRE(GridContains(id));
+                    REQUIRE(std::ranges::find(loadedIds, id) != loadedIds.end());
+                }
+                continue;
+            }
+            // Nothing inside an unloaded chunk - merged colliders don't cross chunk borders
+            const float x = static_cast<float>(i % mask.chunksX) * CHUNK_PIXELS + 1;
+            const float y = static_cast<float>(i / mask.chunksX) * CHUNK_PIXELS + 1;
+            vector<StaticID> found;
+            data.mapTileGrids[STREAMED_MAP].query(found, x, y, CHUNK_PIXELS - 2, CHUNK_PIXELS - 2);
+            for (const auto id : found)
+            {
+                const auto& c = data.colliderStorage.get(StaticIDHelper::GetObjectNum(id));
+                REQUIRE_FALSE(RectToRect(x, y, CHUNK_PIXELS - 2, CHUNK_PIXELS - 2, c.x, c.y, c.p1, c.p2));
+            }
+        }
+        REQUIRE(data.loadedChunkBytes == loadedBytes);
+        REQUIRE(static_cast<int>(loadedIds.size()) * StaticCollisionData::COLLIDER_BYTES == loadedBytes);
+        return loaded;
+    }
+} // namespace
+
+TEST_CASE("Streamed tile chunks load around a moving actor within the budget")
+{
+    test::ResetEngine();
+    static const auto tileSet = CreateTileSet(); // Referenced by the global tileset
+    const auto tileMap = CreateTileMap();
+    LoadGlobalTileSet(tileSet);
+    const int updateRange = GetEntityUpdateRange();
+    SetEntityUpdateRange(500); // At most 4x4 chunks are in use
+
+    SetTileCollisionStreaming(true);
+    AddTileCollisions(STREAMED_MAP, tileMap, {0});
+    SetTileCollisionStreaming(false); // Only applies to maps added afterward
+    auto& data = global::STATIC_COLL_DATA;
+    const auto& chunks = data.colliderReferences.tileChunkMap.at(STREAMED_MAP);
+    REQUIRE(chunks.size() == 64);
+    REQUIRE(CheckLoadedChunks() == 0);
+
+    const auto actor = test::CreateRectEntity(TEST_ACTOR, 300, 300, 10, 10, STREAMED_MAP);
+    GiveActor(actor);
+    test::RunCollisionTick();
+    REQUIRE(CheckLoadedChunks() == 4); // Corner
+    const auto firstIds = SortedIds(chunks[0]);
+    REQUIRE(firstIds.size() > 10);
+    const int chunkBytes = static_cast<int>(firstIds.size()) * StaticCollisionData::COLLIDER_BYTES;
+    data.streamingBudget = 20 * chunkBytes;
+
+    // Across the map and back - chunk 0 is unloaded on the way
+    bool wasUnloaded = false;
+    int maxLoaded = 0;
+    const auto moveTo = [&](const float x, const float y)
+    {
+        auto& pos = GetComponent<PositionC>(actor);
+        pos.x = x;
+        pos.y = y;
+        test::RunCollisionTick();
+        const int loaded = CheckLoadedChunks();
+        maxLoaded = std::max(maxLoaded, loaded);
+        REQUIRE(data.loadedChunkBytes <= data.streamingBudget);
+        wasUnloaded |= !chunks[0].isLoaded;
+
+        const auto& mask = data.tileMasks.at(STREAMED_MAP);
+        const int chunkX = static_cast<int>(x / CHUNK_PIXELS);
+        const int chunkY = static_cast<int>(y / CHUNK_PIXELS);
+        for (int i = std::max(0, chunkY - 1); i <= std::min(mask.chunksY - 1, chunkY + 1); ++i)
+        {
+            for (int j = std::max(0, chunkX - 1); j <= std::min(mask.chunksX - 1, chunkX + 1); ++j)
+                REQUIRE(chunks[i * mask.chunksX + j].isLoaded);
+        }
+    };
+    constexpr float step = 256;
+    constexpr float end = MAP_TILES * TILE_SIZE - 300;
+    for (float x = 300; x <= end; x += step)
+        moveTo(x, 300);
+    for (float y = 300; y <= end; y += step)
+        moveTo(end, y);
+    for (float x = end; x >= 300; x -= step)
+        moveTo(x, x);
+
+    REQUIRE(wasUnloaded);
+    REQUIRE(maxLoaded == 20); // Filled the budget
+    REQUIRE(chunks[0].isLoaded);
+    REQUIRE(SortedIds(chunks[0]) == firstIds); // Reloaded with the reserved ids
+
+    // A tighter budget unloads everything not in use
+    data.streamingBudget = 0;
+    test::RunCollisionTick();
+    REQUIRE(CheckLoadedChunks() == 4);
+
+    RemoveTileCollisions(STREAMED_MAP);
+    REQUIRE(data.loadedChunkBytes == 0);
+    REQUIRE(data.colliderReferences.lruHead.chunk == -1);
+    REQUIRE(data.colliderReferences.lruTail.chunk == -1);
+    SetEntityUpdateRange(updateRange);
+    test::ResetEngine();
+}